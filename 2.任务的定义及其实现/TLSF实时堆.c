@@ -0,0 +1,431 @@
+/*
+ * Demo: TLSF实时堆（替换heap_4.c的pvPortMalloc）
+ * 学习要点：
+ * 1. TLSF（Two-Level Segregated Fit，两级分离适配）分配算法，实现在heap_tlsf.c
+ * 2. 一级索引按2的幂分档，二级索引把每档再线性分成16份
+ * 3. 两级位图 + 找最低置位指令，分配/释放都是有界的O(1)
+ * 4. 释放时立即与物理相邻的空闲块合并，减少碎片
+ * 5. 实时统计：空闲字节、最大空闲块、碎片率、每个调用者的分配情况
+ * 6. 随机分配长时间压测：与首次适配（first-fit）堆对比最坏延迟和碎片率
+ *
+ * 使用方法：工程里用heap_tlsf.c替换heap_4.c，再编译本文件，pvPortMalloc()/vPortFree()就会走TLSF
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "heap_tlsf.h"
+#include "../cycle_counter.h"
+
+
+// ==================== 对比用的首次适配堆 ====================
+/*
+ * 和heap_4.c相同的思路：空闲块按地址排序的单向链表，
+ * 分配时从头找第一个放得下的块，释放时插回并与相邻块合并
+ * 分配和释放都要遍历链表，耗时随空闲块数量增长
+ */
+typedef struct FirstFitBlock{
+    struct FirstFitBlock *next;     //下一个空闲块（按地址排序）
+    size_t size;                    //整个块大小（含块头）
+}FirstFitBlock_t;
+
+#define FF_HEADER_SIZE  ((sizeof(FirstFitBlock_t)+7)&~(size_t)7)
+#define FF_MIN_BLOCK    (FF_HEADER_SIZE*2)
+
+typedef struct{
+    FirstFitBlock_t start;          //空闲链表头
+    FirstFitBlock_t *end;           //链表尾哨兵
+    size_t free_bytes;
+}FirstFit_t;
+
+static void FirstFit_Init(FirstFit_t *heap, void *memory, size_t bytes){
+    uintptr_t start=((uintptr_t)memory+7)&~(uintptr_t)7;
+    size_t usable=(bytes-(size_t)(start-(uintptr_t)memory))&~(size_t)7;
+    FirstFitBlock_t *first=(FirstFitBlock_t*)start;
+
+    heap->end=(FirstFitBlock_t*)(start+usable-FF_HEADER_SIZE);
+    heap->end->size=0;
+    heap->end->next=NULL;
+
+    first->size=usable-FF_HEADER_SIZE;
+    first->next=heap->end;
+
+    heap->start.next=first;
+    heap->start.size=0;
+    heap->free_bytes=first->size;
+}
+
+//按地址插入空闲链表，并与前后相邻块合并
+static void FirstFit_Insert(FirstFit_t *heap, FirstFitBlock_t *block){
+    FirstFitBlock_t *iter=&heap->start;
+
+    while(iter->next<block){
+        iter=iter->next;
+    }
+
+    if(iter!=&heap->start&&(uint8_t*)iter+iter->size==(uint8_t*)block){
+        iter->size+=block->size;
+        block=iter;
+    }
+
+    if(iter->next!=heap->end&&(uint8_t*)block+block->size==(uint8_t*)iter->next){
+        block->size+=iter->next->size;
+        block->next=iter->next->next;
+    }else{
+        block->next=iter->next;
+    }
+
+    if(iter!=block){
+        iter->next=block;
+    }
+}
+
+static void *FirstFit_Malloc(FirstFit_t *heap, size_t size){
+    FirstFitBlock_t *prev=&heap->start;
+    FirstFitBlock_t *block=heap->start.next;
+    size_t wanted=FF_HEADER_SIZE+((size+7)&~(size_t)7);
+
+    while(block->size<wanted&&block->next!=NULL){
+        prev=block;
+        block=block->next;
+    }
+    if(block==heap->end){
+        return NULL;
+    }
+
+    prev->next=block->next;
+
+    if(block->size-wanted>FF_MIN_BLOCK){
+        FirstFitBlock_t *rest=(FirstFitBlock_t*)((uint8_t*)block+wanted);
+        rest->size=block->size-wanted;
+        block->size=wanted;
+        FirstFit_Insert(heap,rest);
+    }
+
+    heap->free_bytes-=block->size;
+    return (uint8_t*)block+FF_HEADER_SIZE;
+}
+
+static void FirstFit_Free(FirstFit_t *heap, void *ptr){
+    FirstFitBlock_t *block=(FirstFitBlock_t*)((uint8_t*)ptr-FF_HEADER_SIZE);
+
+    heap->free_bytes+=block->size;
+    FirstFit_Insert(heap,block);
+}
+
+/**
+ * 空闲载荷统计
+ * 与TLSF的free_bytes口径一致：只算能分给用户的字节，不含块头
+ */
+static void FirstFit_GetFreePayload(FirstFit_t *heap, size_t *free_payload, size_t *largest_payload){
+    *free_payload=0;
+    *largest_payload=0;
+
+    for(FirstFitBlock_t *block=heap->start.next;block!=heap->end;block=block->next){
+        size_t payload=block->size-FF_HEADER_SIZE;
+        *free_payload+=payload;
+        if(payload>*largest_payload){
+            *largest_payload=payload;
+        }
+    }
+}
+
+
+// ==================== 随机分配长时间压测 ====================
+#define BENCH_ARENA_SIZE    (16*1024)   //每个被测堆的内存大小
+#define BENCH_SLOTS         64          //同时存活的分配数上限
+#define BENCH_OPERATIONS    200000      //总操作次数
+#define BENCH_SAMPLE_EVERY  1000        //每隔多少次操作采样一次碎片率
+
+static uint8_t bench_arena_tlsf[BENCH_ARENA_SIZE] __attribute__((aligned(8)));
+static uint8_t bench_arena_ff[BENCH_ARENA_SIZE] __attribute__((aligned(8)));
+static Tlsf_t bench_tlsf;
+static FirstFit_t bench_ff;
+
+//压测结果
+typedef struct{
+    uint32_t worst_alloc;       //最坏分配延迟
+    uint32_t worst_free;        //最坏释放延迟
+    uint64_t total_alloc;       //分配总耗时
+    uint32_t alloc_ops;
+    uint32_t fail_count;        //分配失败次数
+    uint32_t worst_frag;        //最坏碎片率（%）
+    uint64_t frag_sum;          //碎片率累加（求平均）
+    uint32_t frag_samples;
+}BenchResult_t;
+
+//xorshift32伪随机数
+static uint32_t bench_rand(uint32_t *state){
+    uint32_t x=*state;
+    x^=x<<13;
+    x^=x>>17;
+    x^=x<<5;
+    *state=x;
+    return x;
+}
+
+//请求大小：大部分是小块，少量大块（类似消息+数据帧混合负载）
+static size_t bench_size(uint32_t r){
+    switch(r%8){
+        case 0: return 512+(r>>8)%512;
+        case 1:
+        case 2: return 64+(r>>8)%192;
+        default: return 8+(r>>8)%56;
+    }
+}
+
+static void bench_record_frag(BenchResult_t *res, size_t free_bytes, size_t largest){
+    uint32_t frag=(free_bytes==0)?0:(uint32_t)(100-(largest*100)/free_bytes);
+
+    if(frag>res->worst_frag) res->worst_frag=frag;
+    res->frag_sum+=frag;
+    res->frag_samples++;
+}
+
+static void bench_alloc(BenchResult_t *res, uint32_t elapsed, void *ptr){
+    if(elapsed>res->worst_alloc) res->worst_alloc=elapsed;
+    res->total_alloc+=elapsed;
+    res->alloc_ops++;
+    if(ptr==NULL) res->fail_count++;
+}
+
+static void bench_free(BenchResult_t *res, uint32_t elapsed){
+    if(elapsed>res->worst_free) res->worst_free=elapsed;
+}
+
+/**
+ * 两个堆同步执行同一个随机分配/释放序列
+ * 每一步先在TLSF上做，再在首次适配上做；某一边分配失败时两边都放弃这次分配（另一边的块立即释放，不计时），
+ * 这样两个堆的槽位占用始终相同，后续的操作序列也完全相同
+ * 每次计时的调用都放在临界段里，最坏值只包含分配器本身，不含被其他任务抢占和tick中断的时间
+ */
+static void bench_run(BenchResult_t *tlsf_res, BenchResult_t *ff_res){
+    static void *tlsf_slots[BENCH_SLOTS];
+    static void *ff_slots[BENCH_SLOTS];
+    uint32_t seed=0x12345678;
+    uint32_t start,elapsed;
+    size_t free_payload,largest_payload;
+
+    memset(tlsf_res,0,sizeof(BenchResult_t));
+    memset(ff_res,0,sizeof(BenchResult_t));
+    memset(tlsf_slots,0,sizeof(tlsf_slots));
+    memset(ff_slots,0,sizeof(ff_slots));
+
+    for(uint32_t op=0;op<BENCH_OPERATIONS;op++){
+        uint32_t r=bench_rand(&seed);
+        uint32_t index=r%BENCH_SLOTS;
+
+        if(tlsf_slots[index]!=NULL){
+            taskENTER_CRITICAL();
+            start=cycle_counter_get();
+            Tlsf_Free(&bench_tlsf,tlsf_slots[index]);
+            elapsed=cycle_counter_get()-start;
+            taskEXIT_CRITICAL();
+            bench_free(tlsf_res,elapsed);
+
+            taskENTER_CRITICAL();
+            start=cycle_counter_get();
+            FirstFit_Free(&bench_ff,ff_slots[index]);
+            elapsed=cycle_counter_get()-start;
+            taskEXIT_CRITICAL();
+            bench_free(ff_res,elapsed);
+
+            tlsf_slots[index]=NULL;
+            ff_slots[index]=NULL;
+        }else{
+            size_t size=bench_size(bench_rand(&seed));
+
+            taskENTER_CRITICAL();
+            start=cycle_counter_get();
+            tlsf_slots[index]=Tlsf_Malloc(&bench_tlsf,size,NULL);
+            elapsed=cycle_counter_get()-start;
+            taskEXIT_CRITICAL();
+            bench_alloc(tlsf_res,elapsed,tlsf_slots[index]);
+
+            taskENTER_CRITICAL();
+            start=cycle_counter_get();
+            ff_slots[index]=FirstFit_Malloc(&bench_ff,size);
+            elapsed=cycle_counter_get()-start;
+            taskEXIT_CRITICAL();
+            bench_alloc(ff_res,elapsed,ff_slots[index]);
+
+            if(tlsf_slots[index]==NULL||ff_slots[index]==NULL){
+                if(tlsf_slots[index]!=NULL) Tlsf_Free(&bench_tlsf,tlsf_slots[index]);
+                if(ff_slots[index]!=NULL) FirstFit_Free(&bench_ff,ff_slots[index]);
+                tlsf_slots[index]=NULL;
+                ff_slots[index]=NULL;
+            }
+        }
+
+        if(op%BENCH_SAMPLE_EVERY==0){
+            bench_record_frag(tlsf_res,bench_tlsf.free_bytes,Tlsf_GetLargestFreeBlock(&bench_tlsf));
+            FirstFit_GetFreePayload(&bench_ff,&free_payload,&largest_payload);
+            bench_record_frag(ff_res,free_payload,largest_payload);
+            taskYIELD();    //长时间压测，定期让出CPU
+        }
+    }
+
+    //清理，下次重测从干净的堆开始
+    for(uint32_t i=0;i<BENCH_SLOTS;i++){
+        if(tlsf_slots[i]!=NULL){
+            Tlsf_Free(&bench_tlsf,tlsf_slots[i]);
+            FirstFit_Free(&bench_ff,ff_slots[i]);
+        }
+    }
+}
+
+static void bench_print(const char *name, const BenchResult_t *res){
+    printf("  %-10s 最坏分配:%6lu 平均分配:%5lu 最坏释放:%6lu %s | 失败:%lu 碎片率 平均:%lu%% 最坏:%lu%%\n",
+           name, res->worst_alloc,
+           (uint32_t)(res->total_alloc/(res->alloc_ops?res->alloc_ops:1)),
+           res->worst_free, CYCLE_UNIT, res->fail_count,
+           (uint32_t)(res->frag_sum/(res->frag_samples?res->frag_samples:1)),
+           res->worst_frag);
+}
+
+/**
+ * 堆对比测试任务
+ * 功能：同一随机操作序列分别在TLSF和首次适配堆上执行，
+ *       对比最坏延迟（实时性）和碎片率（长期稳定性）
+ */
+void heap_benchmark_task(void *pvParameters){
+    BenchResult_t tlsf_result,ff_result;
+
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    cycle_counter_init();
+
+    for(;;){
+        Tlsf_Init(&bench_tlsf,bench_arena_tlsf,sizeof(bench_arena_tlsf));
+        FirstFit_Init(&bench_ff,bench_arena_ff,sizeof(bench_arena_ff));
+
+        bench_run(&tlsf_result,&ff_result);
+
+        printf("\n[堆压测] %d次随机操作，%d个存活槽位，%d字节堆（碎片率按空闲载荷计算，不含块头）\n",
+               BENCH_OPERATIONS, BENCH_SLOTS, BENCH_ARENA_SIZE);
+        bench_print("TLSF",&tlsf_result);
+        bench_print("FirstFit",&ff_result);
+
+        vTaskDelay(pdMS_TO_TICKS(60000));   //每分钟重测一次
+    }
+}
+
+
+// ==================== 堆使用示例 ====================
+// 模拟5.支持多优先级/demo4.c的监控任务：每个周期都申请和释放一次内存
+void allocating_monitor_task(void *pvParameters){
+    for(;;){
+        UBaseType_t count=uxTaskGetNumberOfTasks();
+        TaskStatus_t *list=pvPortMalloc(count*sizeof(TaskStatus_t));
+
+        if(list!=NULL){
+            uxTaskGetSystemState(list,count,NULL);
+            vPortFree(list);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
+// 模拟可变长度消息的生产者：申请随机大小的缓冲区，持有一段时间再释放
+void message_buffer_task(void *pvParameters){
+    void *buffers[4]={NULL};
+    uint32_t seed=(uint32_t)(uintptr_t)pvParameters+1;
+
+    for(uint32_t i=0;;i++){
+        uint32_t index=i%4;
+
+        vPortFree(buffers[index]);
+        buffers[index]=pvPortMalloc(bench_size(bench_rand(&seed)));
+
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
+
+// 堆监控任务：实时打印碎片率和每个调用者的内存占用
+// 统计在挂起调度器期间复制出来，恢复调度器之后再打印，printf不在挂起期间执行
+void heap_monitor_task(void *pvParameters){
+    static TlsfCaller_t callers[TLSF_CALLER_SLOTS];
+    TlsfStats_t stats;
+    uint32_t caller_count;
+
+    for(;;){
+        vPortGetTlsfStats(&stats);
+        caller_count=ulPortGetTlsfCallers(callers,TLSF_CALLER_SLOTS);
+
+        printf("\n=== TLSF堆状态 ===\n");
+        printf("总大小:%u 空闲:%u 历史最小空闲:%u\n",
+               (unsigned)stats.total_bytes, (unsigned)stats.free_bytes, (unsigned)stats.min_free_bytes);
+        printf("最大空闲块:%u 空闲块数:%lu 碎片率:%lu%%\n",
+               (unsigned)stats.largest_free_block, stats.free_blocks, stats.fragmentation);
+        printf("分配:%lu 释放:%lu 失败:%lu\n",
+               stats.alloc_count, stats.free_count, stats.fail_count);
+
+        printf("调用者统计:\n");
+        for(uint32_t i=0;i<caller_count;i++){
+            printf("  %p 分配:%lu 释放:%lu 占用:%u 峰值:%u\n",
+                   callers[i].caller, callers[i].alloc_count, callers[i].free_count,
+                   (unsigned)callers[i].bytes_in_use, (unsigned)callers[i].bytes_peak);
+        }
+        printf("==================\n\n");
+
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: TLSF实时堆\n");
+
+    xTaskCreate(allocating_monitor_task, "AllocMon", 256, NULL, 3, NULL);
+    xTaskCreate(message_buffer_task, "MsgBuf1", 256, (void*)1, 2, NULL);
+    xTaskCreate(message_buffer_task, "MsgBuf2", 256, (void*)2, 2, NULL);
+    xTaskCreate(heap_monitor_task, "HeapMon", 512, NULL, 1, NULL);
+    xTaskCreate(heap_benchmark_task, "HeapBench", 512, NULL, 1, NULL);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败!\n");
+    return -1;
+}
+
+void vApplicationMallocFailedHook(void){
+    TlsfStats_t stats;
+
+    //分配失败时打印堆状态，区分"内存不够"和"碎片太多"
+    vPortGetTlsfStats(&stats);
+    printf("内存分配失败! 空闲:%u 最大空闲块:%u 碎片率:%lu%%\n",
+           (unsigned)stats.free_bytes, (unsigned)stats.largest_free_block, stats.fragmentation);
+    for(;;);
+}
+
+/*
+学习要点总结：
+
+1. TLSF的两级索引：
+   - 一级（fl）：按块大小的最高位分档，每档是上一档的2倍
+   - 二级（sl）：每个一级档再线性分成16份
+   - 小于128字节的块直接按8字节一档线性划分
+
+2. 为什么是O(1)：
+   - 每个(fl,sl)对应一条空闲链表，位图记录哪些链表非空
+   - 分配时先把请求大小向上取整到下一个分档，再用"找最低置位"指令在位图里找
+   - 找到的链表中任何一个块都一定够大，直接取表头，不需要遍历
+
+3. 合并：
+   - 每个块头记录物理上前一个块，释放时可以O(1)找到前后邻居
+   - 前后是空闲块就立即合并，堆末尾的哨兵块防止越界
+
+4. 与首次适配的区别：
+   - 首次适配要遍历空闲链表，耗时随空闲块数量增长，最坏延迟不可控
+   - TLSF最坏延迟是常数，更适合实时系统
+   - TLSF的取整会浪费一点内存，但碎片率通常更低
+
+5. 统计信息：
+   - 碎片率 = 1 - 最大空闲块/总空闲，空闲够但分配失败说明碎片严重
+   - 每个调用者的占用可以快速定位内存泄漏
+   - 调用者槽位存在块头里，释放时不用查表
+*/
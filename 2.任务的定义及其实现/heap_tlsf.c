@@ -0,0 +1,424 @@
+/*
+ * TLSF实时堆：替换heap_4.c的pvPortMalloc()/vPortFree()
+ * 1. 一级索引按2的幂分档，二级索引把每档再线性分成16份
+ * 2. 两级位图 + 找最低置位指令，分配/释放都是有界的O(1)
+ * 3. 释放时立即与物理相邻的空闲块合并，减少碎片
+ * 4. 实时统计：空闲字节、最大空闲块、碎片率、每个调用者的分配情况
+ *
+ * 使用方法：工程里用本文件替换heap_4.c，接口见heap_tlsf.h
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+#include "heap_tlsf.h"
+
+
+// ==================== 位操作 ====================
+//最高置位的序号（fls：find last set），x必须非0
+static inline uint32_t tlsf_fls(size_t x){
+    return (uint32_t)(sizeof(unsigned long)*8-1-__builtin_clzl((unsigned long)x));
+}
+
+//最低置位的序号（ffs：find first set），x必须非0；Cortex-M3以上编译成RBIT+CLZ
+static inline uint32_t tlsf_ffs(uint32_t x){
+    return (uint32_t)__builtin_ctz(x);
+}
+
+
+// ==================== 块操作 ====================
+static inline size_t block_size(const TlsfBlock_t *block){
+    return block->size&TLSF_SIZE_MASK;
+}
+
+static inline void block_set_size(TlsfBlock_t *block, size_t size){
+    block->size=(block->size&~TLSF_SIZE_MASK)|size;
+}
+
+static inline int block_is_free(const TlsfBlock_t *block){
+    return (block->size&TLSF_BLOCK_FREE)!=0;
+}
+
+static inline void *block_to_ptr(TlsfBlock_t *block){
+    return (uint8_t*)block+TLSF_BLOCK_HEADER_SIZE;
+}
+
+static inline TlsfBlock_t *block_from_ptr(void *ptr){
+    return (TlsfBlock_t*)((uint8_t*)ptr-TLSF_BLOCK_HEADER_SIZE);
+}
+
+//物理上的下一个块（堆末尾有一个大小为0的哨兵块，所以总是存在）
+static inline TlsfBlock_t *block_next(TlsfBlock_t *block){
+    return (TlsfBlock_t*)((uint8_t*)block_to_ptr(block)+block_size(block));
+}
+
+
+// ==================== 索引计算 ====================
+/**
+ * 根据块大小计算所在的空闲链表
+ * 小块：fl=0，sl=size/8（线性）
+ * 大块：fl=最高位序号，sl=最高位后面的4位
+ */
+static void mapping_insert(size_t size, uint32_t *fl, uint32_t *sl){
+    if(size<TLSF_SMALL_BLOCK_SIZE){
+        *fl=0;
+        *sl=(uint32_t)size/(TLSF_SMALL_BLOCK_SIZE/TLSF_SL_INDEX_COUNT);
+    }else{
+        uint32_t f=tlsf_fls(size);
+        *sl=(uint32_t)(size>>(f-TLSF_SL_INDEX_LOG2))^TLSF_SL_INDEX_COUNT;
+        *fl=f-(TLSF_FL_INDEX_SHIFT-1);
+    }
+}
+
+/**
+ * 分配时的查找索引
+ * 先把size向上取整到下一个二级分档的起点，这样该链表中的任何块都一定放得下，
+ * 不需要遍历链表 - 这是TLSF保证O(1)的关键（代价是最多1/16的内部浪费）
+ */
+static void mapping_search(size_t size, uint32_t *fl, uint32_t *sl){
+    if(size>=TLSF_SMALL_BLOCK_SIZE){
+        size+=((size_t)1<<(tlsf_fls(size)-TLSF_SL_INDEX_LOG2))-1;
+    }
+    mapping_insert(size,fl,sl);
+}
+
+/**
+ * 用位图找到第一个足够大的非空链表
+ * 先在同一级里找sl及以上的二级位，找不到再找更高的一级位
+ */
+static TlsfBlock_t *search_suitable_block(Tlsf_t *tlsf, uint32_t *fl, uint32_t *sl){
+    uint32_t sl_map=tlsf->sl_bitmap[*fl]&(~0U<<*sl);
+
+    if(sl_map==0){
+        uint32_t fl_map=tlsf->fl_bitmap&(~0U<<(*fl+1));
+        if(fl_map==0){
+            return NULL;    //没有足够大的空闲块
+        }
+        *fl=tlsf_ffs(fl_map);
+        sl_map=tlsf->sl_bitmap[*fl];
+    }
+    *sl=tlsf_ffs(sl_map);
+
+    return tlsf->blocks[*fl][*sl];
+}
+
+
+// ==================== 空闲链表 ====================
+static void insert_free_block(Tlsf_t *tlsf, TlsfBlock_t *block){
+    uint32_t fl,sl;
+    size_t size=block_size(block);
+
+    mapping_insert(size,&fl,&sl);
+
+    //空闲块不属于任何调用者
+    block->size=size|TLSF_BLOCK_FREE;
+    block->next_free=tlsf->blocks[fl][sl];
+    block->prev_free=NULL;
+    if(block->next_free!=NULL){
+        block->next_free->prev_free=block;
+    }
+    tlsf->blocks[fl][sl]=block;
+
+    tlsf->fl_bitmap|=(1U<<fl);
+    tlsf->sl_bitmap[fl]|=(1U<<sl);
+
+    tlsf->free_bytes+=size;
+    tlsf->free_blocks++;
+}
+
+static void remove_free_block(Tlsf_t *tlsf, TlsfBlock_t *block){
+    uint32_t fl,sl;
+    size_t size=block_size(block);
+
+    mapping_insert(size,&fl,&sl);
+
+    if(block->prev_free!=NULL){
+        block->prev_free->next_free=block->next_free;
+    }
+    if(block->next_free!=NULL){
+        block->next_free->prev_free=block->prev_free;
+    }
+
+    if(tlsf->blocks[fl][sl]==block){
+        tlsf->blocks[fl][sl]=block->next_free;
+        //链表空了就清位图
+        if(tlsf->blocks[fl][sl]==NULL){
+            tlsf->sl_bitmap[fl]&=~(1U<<sl);
+            if(tlsf->sl_bitmap[fl]==0){
+                tlsf->fl_bitmap&=~(1U<<fl);
+            }
+        }
+    }
+
+    block->size&=~TLSF_BLOCK_FREE;
+    tlsf->free_bytes-=size;
+    tlsf->free_blocks--;
+}
+
+
+// ==================== 调用者统计 ====================
+/**
+ * 为调用者分配统计槽位
+ * 按返回地址哈希，线性探测；槽位数固定，所以是有界时间
+ * 表满时记到槽位0
+ */
+static uint32_t caller_slot(Tlsf_t *tlsf, void *caller){
+    uint32_t start=(uint32_t)(((uintptr_t)caller>>2)%(TLSF_CALLER_SLOTS-1))+1;
+    uint32_t slot=start;
+
+    do{
+        if(tlsf->callers[slot].caller==caller){
+            return slot;
+        }
+        if(tlsf->callers[slot].caller==NULL){
+            tlsf->callers[slot].caller=caller;
+            return slot;
+        }
+        slot=(slot%(TLSF_CALLER_SLOTS-1))+1;
+    }while(slot!=start);
+
+    return 0;
+}
+
+
+// ==================== TLSF API ====================
+/**
+ * 在一块内存上初始化TLSF实例
+ * 参数：tlsf - 控制块
+ *       memory/bytes - 被管理的内存区域
+ */
+void Tlsf_Init(Tlsf_t *tlsf, void *memory, size_t bytes){
+    uintptr_t start=((uintptr_t)memory+TLSF_ALIGN_SIZE-1)&~(uintptr_t)(TLSF_ALIGN_SIZE-1);
+    size_t usable=(bytes-(size_t)(start-(uintptr_t)memory))&~(size_t)(TLSF_ALIGN_SIZE-1);
+    TlsfBlock_t *block=(TlsfBlock_t*)start;
+    TlsfBlock_t *sentinel;
+
+    memset(tlsf,0,sizeof(Tlsf_t));
+
+    //整个区域 = 一个大空闲块 + 末尾大小为0的哨兵块（永远是"已分配"，合并到此为止）
+    configASSERT(usable-2*TLSF_BLOCK_HEADER_SIZE<=TLSF_BLOCK_SIZE_MAX);
+    block->prev_phys=NULL;
+    block->size=usable-2*TLSF_BLOCK_HEADER_SIZE;
+
+    sentinel=block_next(block);
+    sentinel->prev_phys=block;
+    sentinel->size=0;
+
+    insert_free_block(tlsf,block);
+
+    tlsf->total_bytes=tlsf->free_bytes;
+    tlsf->min_free_bytes=tlsf->free_bytes;
+}
+
+
+/**
+ * 分配内存
+ * 功能：查找→摘链→切分，每一步都是常数时间
+ * 参数：size - 字节数；caller - 调用者地址（用于统计）
+ * 返回：8字节对齐的地址，失败返回NULL
+ */
+void *Tlsf_Malloc(Tlsf_t *tlsf, size_t size, void *caller){
+    uint32_t fl,sl,slot;
+    size_t adjust,remain;
+    TlsfBlock_t *block;
+
+    adjust=(size+TLSF_ALIGN_SIZE-1)&~(size_t)(TLSF_ALIGN_SIZE-1);
+    if(adjust<TLSF_BLOCK_SIZE_MIN){
+        adjust=TLSF_BLOCK_SIZE_MIN;
+    }
+    if(size==0||adjust>TLSF_BLOCK_SIZE_MAX){
+        tlsf->fail_count++;
+        return NULL;
+    }
+
+    mapping_search(adjust,&fl,&sl);
+    block=(fl<TLSF_FL_INDEX_COUNT)?search_suitable_block(tlsf,&fl,&sl):NULL;
+    if(block==NULL){
+        tlsf->fail_count++;
+        return NULL;
+    }
+
+    remove_free_block(tlsf,block);
+
+    //剩余部分足够放下一个块头和最小载荷，就切出来放回空闲链表
+    remain=block_size(block)-adjust;
+    if(remain>=sizeof(TlsfBlock_t)){
+        TlsfBlock_t *rest=(TlsfBlock_t*)((uint8_t*)block_to_ptr(block)+adjust);
+
+        rest->prev_phys=block;
+        rest->size=remain-TLSF_BLOCK_HEADER_SIZE;
+        block_next(rest)->prev_phys=rest;
+        block_set_size(block,adjust);
+
+        insert_free_block(tlsf,rest);
+    }
+
+    //统计
+    slot=caller_slot(tlsf,caller);
+    block->size=(block->size&~TLSF_CALLER_MASK)|((size_t)slot<<TLSF_CALLER_SHIFT);
+    tlsf->callers[slot].alloc_count++;
+    tlsf->callers[slot].bytes_in_use+=block_size(block);
+    if(tlsf->callers[slot].bytes_in_use>tlsf->callers[slot].bytes_peak){
+        tlsf->callers[slot].bytes_peak=tlsf->callers[slot].bytes_in_use;
+    }
+    tlsf->alloc_count++;
+    if(tlsf->free_bytes<tlsf->min_free_bytes){
+        tlsf->min_free_bytes=tlsf->free_bytes;
+    }
+
+    return block_to_ptr(block);
+}
+
+
+/**
+ * 释放内存
+ * 功能：与前后物理相邻的空闲块合并后放回空闲链表，常数时间
+ */
+void Tlsf_Free(Tlsf_t *tlsf, void *ptr){
+    TlsfBlock_t *block,*prev,*next;
+    uint32_t slot;
+
+    if(ptr==NULL){
+        return;
+    }
+
+    block=block_from_ptr(ptr);
+    configASSERT(!block_is_free(block));    //重复释放
+
+    slot=(uint32_t)((block->size&TLSF_CALLER_MASK)>>TLSF_CALLER_SHIFT);
+    tlsf->callers[slot].free_count++;
+    tlsf->callers[slot].bytes_in_use-=block_size(block);
+    tlsf->free_count++;
+
+    //和前一个空闲块合并
+    prev=block->prev_phys;
+    if(prev!=NULL&&block_is_free(prev)){
+        remove_free_block(tlsf,prev);
+        block_set_size(prev,block_size(prev)+TLSF_BLOCK_HEADER_SIZE+block_size(block));
+        block=prev;
+        block_next(block)->prev_phys=block;
+    }
+
+    //和后一个空闲块合并
+    next=block_next(block);
+    if(block_is_free(next)){
+        remove_free_block(tlsf,next);
+        block_set_size(block,block_size(block)+TLSF_BLOCK_HEADER_SIZE+block_size(next));
+        block_next(block)->prev_phys=block;
+    }
+
+    insert_free_block(tlsf,block);
+}
+
+
+/**
+ * 最大空闲块
+ * 位图直接给出最高的非空链表，只需要遍历这一条链表
+ */
+size_t Tlsf_GetLargestFreeBlock(Tlsf_t *tlsf){
+    uint32_t fl,sl;
+    size_t largest=0;
+
+    if(tlsf->fl_bitmap==0){
+        return 0;
+    }
+    fl=tlsf_fls(tlsf->fl_bitmap);
+    sl=tlsf_fls(tlsf->sl_bitmap[fl]);
+
+    for(TlsfBlock_t *block=tlsf->blocks[fl][sl];block!=NULL;block=block->next_free){
+        if(block_size(block)>largest){
+            largest=block_size(block);
+        }
+    }
+    return largest;
+}
+
+
+void Tlsf_GetStats(Tlsf_t *tlsf, TlsfStats_t *stats){
+    stats->total_bytes=tlsf->total_bytes;
+    stats->free_bytes=tlsf->free_bytes;
+    stats->min_free_bytes=tlsf->min_free_bytes;
+    stats->largest_free_block=Tlsf_GetLargestFreeBlock(tlsf);
+    stats->free_blocks=tlsf->free_blocks;
+    stats->fragmentation=(tlsf->free_bytes==0)?0:
+        (uint32_t)(100-(stats->largest_free_block*100)/tlsf->free_bytes);
+    stats->alloc_count=tlsf->alloc_count;
+    stats->free_count=tlsf->free_count;
+    stats->fail_count=tlsf->fail_count;
+}
+
+
+// ==================== FreeRTOS堆接口（替换heap_4.c） ====================
+static uint8_t ucHeap[configTOTAL_HEAP_SIZE] __attribute__((aligned(8)));
+static Tlsf_t system_heap;
+static BaseType_t system_heap_ready=pdFALSE;
+
+void *pvPortMalloc(size_t xWantedSize){
+    void *ptr;
+    void *caller=__builtin_return_address(0);
+
+    //与heap_4.c一样用挂起调度器保护；TLSF是有界时间，这段时间很短
+    vTaskSuspendAll();
+    {
+        if(system_heap_ready==pdFALSE){
+            Tlsf_Init(&system_heap,ucHeap,sizeof(ucHeap));
+            system_heap_ready=pdTRUE;
+        }
+        ptr=Tlsf_Malloc(&system_heap,xWantedSize,caller);
+    }
+    (void)xTaskResumeAll();
+
+#if(configUSE_MALLOC_FAILED_HOOK==1)
+    if(ptr==NULL){
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+    }
+#endif
+
+    return ptr;
+}
+
+void vPortFree(void *pv){
+    if(pv==NULL){
+        return;
+    }
+
+    vTaskSuspendAll();
+    {
+        Tlsf_Free(&system_heap,pv);
+    }
+    (void)xTaskResumeAll();
+}
+
+size_t xPortGetFreeHeapSize(void){
+    return system_heap.free_bytes;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void){
+    return system_heap.min_free_bytes;
+}
+
+//获取系统堆统计（监控任务用）
+void vPortGetTlsfStats(TlsfStats_t *stats){
+    vTaskSuspendAll();
+    {
+        Tlsf_GetStats(&system_heap,stats);
+    }
+    (void)xTaskResumeAll();
+}
+
+//复制调用者统计，返回复制的条数
+uint32_t ulPortGetTlsfCallers(TlsfCaller_t *callers, uint32_t max_callers){
+    uint32_t count=0;
+
+    vTaskSuspendAll();
+    {
+        for(uint32_t i=0;i<TLSF_CALLER_SLOTS&&count<max_callers;i++){
+            if(system_heap.callers[i].alloc_count>0){
+                callers[count++]=system_heap.callers[i];
+            }
+        }
+    }
+    (void)xTaskResumeAll();
+
+    return count;
+}
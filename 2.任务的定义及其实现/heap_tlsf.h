@@ -0,0 +1,107 @@
+/*
+ * TLSF实时堆（heap_tlsf.c的接口）
+ * 工程里用heap_tlsf.c替换heap_4.c，pvPortMalloc()/vPortFree()就会走TLSF；
+ * Tlsf_*接口也可以在任意一块内存上单独建堆（TLSF实时堆.c的压测就是这样用的）
+ */
+#ifndef HEAP_TLSF_H
+#define HEAP_TLSF_H
+
+#include "FreeRTOS.h"
+#include <stddef.h>
+#include <stdint.h>
+
+
+// ==================== TLSF配置 ====================
+#ifndef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE   (32*1024)
+#endif
+
+#ifndef configUSE_MALLOC_FAILED_HOOK
+#define configUSE_MALLOC_FAILED_HOOK 1
+#endif
+
+#define TLSF_ALIGN_LOG2         3                                   //8字节对齐
+#define TLSF_ALIGN_SIZE         (1U<<TLSF_ALIGN_LOG2)
+#define TLSF_SL_INDEX_LOG2      4                                   //二级索引：每档分16份
+#define TLSF_SL_INDEX_COUNT     (1U<<TLSF_SL_INDEX_LOG2)
+#define TLSF_FL_INDEX_SHIFT     (TLSF_SL_INDEX_LOG2+TLSF_ALIGN_LOG2)
+#define TLSF_FL_INDEX_MAX       24                                  //最大块16MB
+#define TLSF_FL_INDEX_COUNT     (TLSF_FL_INDEX_MAX-TLSF_FL_INDEX_SHIFT+1)
+#define TLSF_SMALL_BLOCK_SIZE   (1U<<TLSF_FL_INDEX_SHIFT)           //小于128字节的块线性分档
+
+/*
+ * 块头size字段的布局：
+ *   bit0       空闲标志
+ *   bit3~23    载荷大小（8字节对齐，低3位天然为0）
+ *   bit24~31   调用者槽位（用于按调用者统计，释放时不需要再查表）
+ */
+#define TLSF_BLOCK_FREE         ((size_t)1)
+#define TLSF_SIZE_MASK          ((size_t)0x00FFFFF8)
+#define TLSF_CALLER_SHIFT       24
+#define TLSF_CALLER_MASK        ((size_t)0xFF<<TLSF_CALLER_SHIFT)
+#define TLSF_CALLER_SLOTS       32      //槽位0用于"表满/未知调用者"
+
+//块头：prev_phys和size常驻；next_free/prev_free只在空闲时有效，与载荷区重叠
+typedef struct TlsfBlock{
+    struct TlsfBlock *prev_phys;    //物理上的前一个块
+    size_t size;                    //载荷大小 + 标志位
+    struct TlsfBlock *next_free;    //同一空闲链表的下一个块
+    struct TlsfBlock *prev_free;    //同一空闲链表的上一个块
+}TlsfBlock_t;
+
+#define TLSF_BLOCK_HEADER_SIZE  (offsetof(TlsfBlock_t,next_free))
+#define TLSF_BLOCK_SIZE_MIN     (sizeof(TlsfBlock_t)-TLSF_BLOCK_HEADER_SIZE)
+#define TLSF_BLOCK_SIZE_MAX     TLSF_SIZE_MASK
+
+//每个调用者的分配统计
+typedef struct{
+    void *caller;               //调用pvPortMalloc()的返回地址
+    uint32_t alloc_count;       //分配次数
+    uint32_t free_count;        //释放次数
+    size_t bytes_in_use;        //当前占用字节
+    size_t bytes_peak;          //占用字节峰值
+}TlsfCaller_t;
+
+//TLSF控制块：一个实例管理一块连续内存
+typedef struct{
+    uint32_t fl_bitmap;                                             //一级位图
+    uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];                        //二级位图
+    TlsfBlock_t *blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];  //空闲链表头
+
+    //统计信息
+    size_t total_bytes;         //可分配的总载荷字节
+    size_t free_bytes;          //当前空闲字节
+    size_t min_free_bytes;      //历史最小空闲字节
+    uint32_t free_blocks;       //空闲块数量
+    uint32_t alloc_count;       //分配成功次数
+    uint32_t free_count;        //释放次数
+    uint32_t fail_count;        //分配失败次数
+    TlsfCaller_t callers[TLSF_CALLER_SLOTS];
+}Tlsf_t;
+
+//堆统计快照
+typedef struct{
+    size_t total_bytes;
+    size_t free_bytes;
+    size_t min_free_bytes;
+    size_t largest_free_block;
+    uint32_t free_blocks;
+    uint32_t fragmentation;     //碎片率（百分比）= 1 - 最大空闲块/总空闲
+    uint32_t alloc_count;
+    uint32_t free_count;
+    uint32_t fail_count;
+}TlsfStats_t;
+
+
+// ==================== 接口 ====================
+void Tlsf_Init(Tlsf_t *tlsf, void *memory, size_t bytes);
+void *Tlsf_Malloc(Tlsf_t *tlsf, size_t size, void *caller);
+void Tlsf_Free(Tlsf_t *tlsf, void *ptr);
+size_t Tlsf_GetLargestFreeBlock(Tlsf_t *tlsf);
+void Tlsf_GetStats(Tlsf_t *tlsf, TlsfStats_t *stats);
+
+//系统堆（pvPortMalloc使用的那一个）的统计快照，在挂起调度器期间复制，调用者拿到后再打印
+void vPortGetTlsfStats(TlsfStats_t *stats);
+uint32_t ulPortGetTlsfCallers(TlsfCaller_t *callers, uint32_t max_callers);
+
+#endif
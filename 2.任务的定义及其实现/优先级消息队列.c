@@ -0,0 +1,571 @@
+/*
+ * Demo: 带优先级和老化机制的消息队列
+ * 学习要点：
+ * 1. 每条消息带优先级，紧急命令不用排在大批传感器数据后面
+ * 2. 有限个优先级带（band），每个带内部仍然是FIFO
+ * 3. 非空带位图 + 找最低置位，O(1)选出最高优先级的带
+ * 4. 老化（aging）：低优先级消息等待超过阈值就提升一级，防止饿死
+ * 5. 用两个计数信号量实现阻塞发送/接收，接口和xQueueSend/xQueueReceive一致
+ * 6. 与普通FIFO队列对比：入队/出队开销、饱和时高优先级消息的尾延迟
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 优先级队列 ====================
+#define PRIO_QUEUE_MAX_BANDS    32          //优先级带上限（位图宽度）
+#define PRIO_QUEUE_NO_SLOT      0xFFFF      //链表结束标志
+
+//每个优先级带：一条FIFO链表
+typedef struct{
+    uint16_t head;              //最早入队的槽
+    uint16_t tail;              //最晚入队的槽
+    uint16_t count;             //消息数
+    uint32_t enqueued;          //累计入队数
+    uint32_t dequeued;          //累计出队数
+    uint32_t promoted;          //因老化被提升到上一级的消息数
+}PrioBand_t;
+
+//消息槽
+typedef struct{
+    uint16_t next;              //同一带/空闲链表中的下一个槽
+    uint8_t band;               //当前所在的带
+    uint8_t original_band;      //入队时的优先级
+    TickType_t enqueue_tick;    //进入当前带的时间（老化计时）
+}PrioSlot_t;
+
+//优先级队列控制块
+typedef struct{
+    uint8_t *storage;           //消息存储区：capacity*item_size
+    PrioSlot_t *slots;          //槽信息
+    PrioBand_t bands[PRIO_QUEUE_MAX_BANDS];
+    uint16_t free_head;         //空闲槽链表
+    uint16_t capacity;          //容量
+    uint16_t item_size;         //每条消息的字节数
+    uint8_t band_count;         //优先级带数
+    volatile uint32_t band_bitmap;  //bit b：带b非空（b=0最高优先级）
+    TickType_t aging_ticks;     //老化阈值，0表示不老化
+
+    SemaphoreHandle_t items;    //可读消息数
+    SemaphoreHandle_t spaces;   //空闲槽数
+}PrioQueue_t;
+
+typedef PrioQueue_t* PrioQueueHandle_t;
+
+
+/**
+ * 创建优先级队列
+ * 参数：capacity - 最多容纳的消息数（所有带共享）
+ *       item_size - 每条消息的字节数
+ *       band_count - 优先级带数（1~32），优先级0最高
+ *       aging_ticks - 消息在一个带里等待多久后提升一级，0表示不老化
+ * 返回：队列句柄，失败返回NULL
+ */
+PrioQueueHandle_t PrioQueue_Create(uint16_t capacity, uint16_t item_size,
+                                   uint8_t band_count, TickType_t aging_ticks){
+    PrioQueue_t *queue;
+
+    if(band_count==0||band_count>PRIO_QUEUE_MAX_BANDS||capacity==0||capacity>=PRIO_QUEUE_NO_SLOT){
+        return NULL;
+    }
+
+    queue=pvPortMalloc(sizeof(PrioQueue_t));
+    if(queue==NULL){
+        return NULL;
+    }
+    memset(queue,0,sizeof(PrioQueue_t));
+
+    queue->storage=pvPortMalloc((size_t)capacity*item_size);
+    queue->slots=pvPortMalloc((size_t)capacity*sizeof(PrioSlot_t));
+    queue->items=xSemaphoreCreateCounting(capacity,0);
+    queue->spaces=xSemaphoreCreateCounting(capacity,capacity);
+    if(queue->storage==NULL||queue->slots==NULL||queue->items==NULL||queue->spaces==NULL){
+        //创建失败时释放已分配的部分
+        if(queue->items!=NULL) vSemaphoreDelete(queue->items);
+        if(queue->spaces!=NULL) vSemaphoreDelete(queue->spaces);
+        vPortFree(queue->slots);
+        vPortFree(queue->storage);
+        vPortFree(queue);
+        return NULL;
+    }
+
+    queue->capacity=capacity;
+    queue->item_size=item_size;
+    queue->band_count=band_count;
+    queue->aging_ticks=aging_ticks;
+
+    for(uint32_t b=0;b<PRIO_QUEUE_MAX_BANDS;b++){
+        queue->bands[b].head=PRIO_QUEUE_NO_SLOT;
+        queue->bands[b].tail=PRIO_QUEUE_NO_SLOT;
+    }
+    for(uint16_t i=0;i<capacity;i++){
+        queue->slots[i].next=(uint16_t)((i+1<capacity)?i+1:PRIO_QUEUE_NO_SLOT);
+    }
+    queue->free_head=0;
+
+    return queue;
+}
+
+
+//把槽挂到带的尾部，调用者负责临界段
+static void band_push_tail(PrioQueue_t *queue, uint8_t band, uint16_t slot, TickType_t now){
+    PrioBand_t *pb=&queue->bands[band];
+
+    queue->slots[slot].next=PRIO_QUEUE_NO_SLOT;
+    queue->slots[slot].band=band;
+    queue->slots[slot].enqueue_tick=now;
+
+    if(pb->tail==PRIO_QUEUE_NO_SLOT){
+        pb->head=slot;
+    }else{
+        queue->slots[pb->tail].next=slot;
+    }
+    pb->tail=slot;
+    pb->count++;
+
+    queue->band_bitmap|=(1UL<<band);
+}
+
+//从带的头部摘下一个槽，调用者负责临界段
+static uint16_t band_pop_head(PrioQueue_t *queue, uint8_t band){
+    PrioBand_t *pb=&queue->bands[band];
+    uint16_t slot=pb->head;
+
+    pb->head=queue->slots[slot].next;
+    if(pb->head==PRIO_QUEUE_NO_SLOT){
+        pb->tail=PRIO_QUEUE_NO_SLOT;
+        queue->band_bitmap&=~(1UL<<band);
+    }
+    pb->count--;
+
+    return slot;
+}
+
+
+/**
+ * 老化处理
+ * 每个带是FIFO，带头就是该带里等待最久的消息，所以只需检查每个非空带的带头
+ * 超时的带头移到上一级带的尾部；检查次数不超过带数（常数）
+ */
+static void prio_queue_age(PrioQueue_t *queue, TickType_t now){
+    //最高优先级带不需要老化，从第二个非空带开始
+    uint32_t pending=queue->band_bitmap&~1UL;
+
+    while(pending!=0){
+        uint8_t band=(uint8_t)__builtin_ctz(pending);
+        uint16_t slot=queue->bands[band].head;
+
+        pending&=pending-1;     //清掉最低位
+
+        if(now-queue->slots[slot].enqueue_tick>=queue->aging_ticks){
+            band_pop_head(queue,band);
+            band_push_tail(queue,(uint8_t)(band-1),slot,now);
+            queue->bands[band].promoted++;
+        }
+    }
+}
+
+
+//入队：取空闲槽→拷贝数据→挂到带尾，调用者负责临界段
+static void prio_queue_insert(PrioQueue_t *queue, const void *item, uint8_t priority, TickType_t now){
+    uint16_t slot=queue->free_head;
+
+    if(priority>=queue->band_count){
+        priority=queue->band_count-1;
+    }
+
+    queue->free_head=queue->slots[slot].next;
+    memcpy(queue->storage+(uint32_t)slot*queue->item_size,item,queue->item_size);
+    queue->slots[slot].original_band=priority;
+    band_push_tail(queue,priority,slot,now);
+    queue->bands[priority].enqueued++;
+}
+
+//出队：老化→位图选最高优先级带→摘头→拷贝数据→还槽，调用者负责临界段
+static void prio_queue_remove(PrioQueue_t *queue, void *buffer, uint8_t *priority, TickType_t now){
+    uint8_t band;
+    uint16_t slot;
+
+    if(queue->aging_ticks!=0){
+        prio_queue_age(queue,now);
+    }
+
+    band=(uint8_t)__builtin_ctz(queue->band_bitmap);
+    slot=band_pop_head(queue,band);
+    queue->bands[band].dequeued++;
+
+    memcpy(buffer,queue->storage+(uint32_t)slot*queue->item_size,queue->item_size);
+    if(priority!=NULL){
+        *priority=queue->slots[slot].original_band;
+    }
+
+    queue->slots[slot].next=queue->free_head;
+    queue->free_head=slot;
+}
+
+
+/**
+ * 发送消息
+ * 参数：priority - 消息优先级（0最高），超出范围按最低优先级处理
+ *       timeout - 队列满时的最长等待时间
+ * 说明：多个发送者都在等空间时，FreeRTOS按任务优先级唤醒，紧急发送者先拿到空间
+ */
+BaseType_t PrioQueue_Send(PrioQueueHandle_t queue, const void *item, uint8_t priority, TickType_t timeout){
+    if(xSemaphoreTake(queue->spaces,timeout)!=pdTRUE){
+        return errQUEUE_FULL;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        prio_queue_insert(queue,item,priority,xTaskGetTickCount());
+    }
+    taskEXIT_CRITICAL();
+
+    xSemaphoreGive(queue->items);
+    return pdPASS;
+}
+
+BaseType_t PrioQueue_SendFromISR(PrioQueueHandle_t queue, const void *item, uint8_t priority,
+                                 BaseType_t *pxHigherPriorityTaskWoken){
+    UBaseType_t saved;
+
+    if(xSemaphoreTakeFromISR(queue->spaces,NULL)!=pdTRUE){
+        return errQUEUE_FULL;
+    }
+
+    saved=taskENTER_CRITICAL_FROM_ISR();
+    {
+        prio_queue_insert(queue,item,priority,xTaskGetTickCountFromISR());
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    xSemaphoreGiveFromISR(queue->items,pxHigherPriorityTaskWoken);
+    return pdPASS;
+}
+
+
+/**
+ * 接收消息
+ * 参数：buffer - 接收缓冲区（item_size字节）
+ *       priority - 输出消息入队时的优先级，可以传NULL
+ *       timeout - 队列空时的最长等待时间
+ */
+BaseType_t PrioQueue_Receive(PrioQueueHandle_t queue, void *buffer, uint8_t *priority, TickType_t timeout){
+    if(xSemaphoreTake(queue->items,timeout)!=pdTRUE){
+        return errQUEUE_EMPTY;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        prio_queue_remove(queue,buffer,priority,xTaskGetTickCount());
+    }
+    taskEXIT_CRITICAL();
+
+    xSemaphoreGive(queue->spaces);
+    return pdPASS;
+}
+
+UBaseType_t PrioQueue_MessagesWaiting(PrioQueueHandle_t queue){
+    return uxSemaphoreGetCount(queue->items);
+}
+
+
+// ==================== demo7的数据结构 ====================
+typedef struct{
+    char text[50];
+    uint8_t priority;
+    uint32_t sender_id;
+}message_t;
+
+//消息优先级带
+#define MSG_PRIO_URGENT     0   //中断紧急消息、命令
+#define MSG_PRIO_STATUS     1   //状态消息
+#define MSG_PRIO_BULK       2   //大批传感器数据
+#define MSG_PRIO_BANDS      3
+
+#define MSG_AGING_MS        500 //低优先级消息最多在一个带里等500ms
+
+static PrioQueueHandle_t message_queue;
+
+
+// ==================== 优先级队列示例 ====================
+// 批量数据任务：持续产生低优先级消息，把队列塞满
+void bulk_sensor_task(void *pvParameters){
+    message_t msg={.priority=MSG_PRIO_BULK,.sender_id=1};
+    uint32_t seq=0;
+
+    for(;;){
+        snprintf(msg.text,sizeof(msg.text),"传感器批量数据 #%lu",seq++);
+        PrioQueue_Send(message_queue,&msg,msg.priority,portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
+// 状态任务：中等优先级
+void status_task(void *pvParameters){
+    message_t msg={.priority=MSG_PRIO_STATUS,.sender_id=99};
+
+    for(;;){
+        strcpy(msg.text,"系统运行正常");
+        PrioQueue_Send(message_queue,&msg,msg.priority,portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+// 模拟中断服务程序 - 紧急消息插到所有普通消息前面
+void simulate_interrupt_send_message(void){
+    BaseType_t higher_priority_task_woken=pdFALSE;
+    message_t urgent_msg={.priority=MSG_PRIO_URGENT,.sender_id=0};
+
+    strcpy(urgent_msg.text,"紧急中断消息!");
+    PrioQueue_SendFromISR(message_queue,&urgent_msg,urgent_msg.priority,&higher_priority_task_woken);
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+void interrupt_simulator_task(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(2000));
+        simulate_interrupt_send_message();
+    }
+}
+
+// 显示任务：处理速度比产生速度慢，队列会一直处于饱和状态
+void display_task(void *pvParameters){
+    message_t msg;
+    uint8_t priority;
+
+    for(;;){
+        if(PrioQueue_Receive(message_queue,&msg,&priority,portMAX_DELAY)==pdPASS){
+            printf("[显示器] 优先级:%d(当前剩余%lu条) 发送者:%lu 内容:%s\n",
+                   priority, PrioQueue_MessagesWaiting(message_queue), msg.sender_id, msg.text);
+        }
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
+// 监控任务：打印每个带的统计
+void prio_monitor_task(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(5000));
+
+        printf("\n=== 优先级队列状态 ===\n");
+        for(uint32_t b=0;b<MSG_PRIO_BANDS;b++){
+            PrioBand_t *pb=&message_queue->bands[b];
+            printf("带%lu: 当前%u 入队%lu 出队%lu 老化提升%lu\n",
+                   b, pb->count, pb->enqueued, pb->dequeued, pb->promoted);
+        }
+        printf("======================\n\n");
+    }
+}
+
+
+// ==================== 性能对比 ====================
+#define BENCH_OPS           1000    //入队/出队开销测试次数
+#define BENCH_QUEUE_LEN     16      //饱和测试的队列长度
+#define BENCH_URGENT_MSGS   100     //饱和测试中发送的紧急消息数
+
+//基准消息：只带发送时间戳
+typedef struct{
+    uint32_t sent_at;
+    uint8_t urgent;
+}bench_msg_t;
+
+static PrioQueueHandle_t bench_prio_queue;
+static QueueHandle_t bench_fifo_queue;
+static volatile BaseType_t bench_use_prio;
+static volatile BaseType_t bench_running;
+static uint32_t bench_latency[BENCH_URGENT_MSGS];
+static volatile uint32_t bench_latency_count;
+static TaskHandle_t bench_controller_handle;
+
+static int compare_u32(const void *a, const void *b){
+    uint32_t x=*(const uint32_t*)a,y=*(const uint32_t*)b;
+    return (x>y)-(x<y);
+}
+
+static BaseType_t bench_send(bench_msg_t *msg, TickType_t timeout){
+    if(bench_use_prio){
+        return PrioQueue_Send(bench_prio_queue,msg,msg->urgent?0:2,timeout);
+    }
+    return xQueueSend(bench_fifo_queue,msg,timeout);
+}
+
+// 批量发送者：只要队列有空间就塞低优先级消息，保持饱和
+void bench_bulk_task(void *pvParameters){
+    bench_msg_t msg={0};
+
+    for(;;){
+        if(bench_running){
+            msg.sent_at=cycle_counter_get();
+            bench_send(&msg,pdMS_TO_TICKS(10));
+        }else{
+            vTaskDelay(1);
+        }
+    }
+}
+
+// 紧急发送者：任务优先级比批量发送者高，队列有空位时先拿到
+void bench_urgent_task(void *pvParameters){
+    bench_msg_t msg={.urgent=1};
+
+    for(;;){
+        if(bench_running){
+            msg.sent_at=cycle_counter_get();
+            bench_send(&msg,portMAX_DELAY);
+        }
+        vTaskDelay(7);
+    }
+}
+
+// 慢速消费者：每个tick处理一条消息
+void bench_consumer_task(void *pvParameters){
+    bench_msg_t msg;
+    BaseType_t got;
+
+    for(;;){
+        if(bench_use_prio){
+            got=PrioQueue_Receive(bench_prio_queue,&msg,NULL,pdMS_TO_TICKS(10));
+        }else{
+            got=xQueueReceive(bench_fifo_queue,&msg,pdMS_TO_TICKS(10));
+        }
+
+        if(got==pdPASS&&msg.urgent&&bench_running){
+            bench_latency[bench_latency_count++]=cycle_counter_get()-msg.sent_at;
+            if(bench_latency_count==BENCH_URGENT_MSGS){
+                bench_running=pdFALSE;
+                xTaskNotifyGive(bench_controller_handle);
+            }
+        }
+        vTaskDelay(1);
+    }
+}
+
+//清空两个队列，保证下一轮从空队列开始
+static void bench_drain(void){
+    bench_msg_t msg;
+
+    while(PrioQueue_Receive(bench_prio_queue,&msg,NULL,0)==pdPASS);
+    while(xQueueReceive(bench_fifo_queue,&msg,0)==pdPASS);
+}
+
+/**
+ * 基准控制任务
+ * 1. 入队/出队开销：空队列上反复Send+Receive，测单次操作耗时
+ * 2. 饱和尾延迟：批量发送者把队列塞满，统计紧急消息的P50/P99/最大延迟
+ */
+void bench_controller_task(void *pvParameters){
+    bench_msg_t msg={0};
+    uint32_t start,prio_send=0,prio_recv=0,fifo_send=0,fifo_recv=0;
+
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    cycle_counter_init();
+
+    //1. 单次操作开销
+    for(uint32_t i=0;i<BENCH_OPS;i++){
+        start=cycle_counter_get();
+        PrioQueue_Send(bench_prio_queue,&msg,(uint8_t)(i%3),0);
+        prio_send+=cycle_counter_get()-start;
+
+        start=cycle_counter_get();
+        PrioQueue_Receive(bench_prio_queue,&msg,NULL,0);
+        prio_recv+=cycle_counter_get()-start;
+
+        start=cycle_counter_get();
+        xQueueSend(bench_fifo_queue,&msg,0);
+        fifo_send+=cycle_counter_get()-start;
+
+        start=cycle_counter_get();
+        xQueueReceive(bench_fifo_queue,&msg,0);
+        fifo_recv+=cycle_counter_get()-start;
+    }
+
+    printf("\n[性能测试] 单次操作平均开销（%s）\n", CYCLE_UNIT);
+    printf("  优先级队列: 入队%lu 出队%lu\n", prio_send/BENCH_OPS, prio_recv/BENCH_OPS);
+    printf("  FIFO队列:   入队%lu 出队%lu\n", fifo_send/BENCH_OPS, fifo_recv/BENCH_OPS);
+
+    //2. 饱和状态下紧急消息的尾延迟
+    printf("[性能测试] 饱和时紧急消息延迟（队列长度%d，%s）\n", BENCH_QUEUE_LEN, CYCLE_UNIT);
+    for(BaseType_t use_prio=pdTRUE;use_prio>=pdFALSE;use_prio--){
+        bench_drain();
+        bench_use_prio=use_prio;
+        bench_latency_count=0;
+        bench_running=pdTRUE;
+
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+
+        qsort(bench_latency,BENCH_URGENT_MSGS,sizeof(uint32_t),compare_u32);
+        printf("  %s P50:%lu P99:%lu 最大:%lu\n",
+               use_prio?"优先级队列":"FIFO队列  ",
+               bench_latency[BENCH_URGENT_MSGS/2],
+               bench_latency[BENCH_URGENT_MSGS*99/100],
+               bench_latency[BENCH_URGENT_MSGS-1]);
+    }
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 带优先级和老化机制的消息队列\n");
+
+    message_queue=PrioQueue_Create(10,sizeof(message_t),MSG_PRIO_BANDS,pdMS_TO_TICKS(MSG_AGING_MS));
+    bench_prio_queue=PrioQueue_Create(BENCH_QUEUE_LEN,sizeof(bench_msg_t),3,0);
+    bench_fifo_queue=xQueueCreate(BENCH_QUEUE_LEN,sizeof(bench_msg_t));
+    if(message_queue==NULL||bench_prio_queue==NULL||bench_fifo_queue==NULL){
+        printf("队列创建失败!\n");
+        return -1;
+    }
+
+    xTaskCreate(bulk_sensor_task, "Bulk", 256, NULL, 2, NULL);
+    xTaskCreate(status_task, "Status", 256, NULL, 2, NULL);
+    xTaskCreate(interrupt_simulator_task, "IntSim", 256, NULL, 3, NULL);
+    xTaskCreate(display_task, "Display", 512, NULL, 3, NULL);
+    xTaskCreate(prio_monitor_task, "PrioMon", 512, NULL, 1, NULL);
+
+    xTaskCreate(bench_bulk_task, "BenchBulk", 256, NULL, 1, NULL);
+    xTaskCreate(bench_urgent_task, "BenchUrgent", 256, NULL, 2, NULL);
+    xTaskCreate(bench_consumer_task, "BenchCons", 256, NULL, 3, NULL);
+    xTaskCreate(bench_controller_task, "BenchCtrl", 512, NULL, 4, &bench_controller_handle);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败!\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 为什么需要优先级队列：
+   - 普通队列严格FIFO，紧急命令要等前面所有数据处理完
+   - 队列饱和时，紧急消息的延迟 = 队列长度 x 单条处理时间
+   - 优先级队列中紧急消息只需要等当前正在处理的那一条
+
+2. 数据结构：
+   - 所有带共享一个槽池，容量固定，不会出现某个带单独满的情况
+   - 每个带是一条单向FIFO链表（头、尾、计数）
+   - 带位图的最低置位就是最高优先级的非空带
+
+3. 老化机制：
+   - 带内FIFO，带头就是等待最久的消息，只检查带头即可
+   - 超过阈值就移到上一级带的尾部，并重新计时
+   - 最坏情况下，最低优先级消息经过 (带数-1) x 阈值 后进入最高带，不会饿死
+
+4. 阻塞语义：
+   - items信号量计数可读消息，spaces信号量计数空闲槽
+   - 发送：先拿spaces（可阻塞）再入队；接收：先拿items（可阻塞）再出队
+   - 结构体修改只在很短的临界段里完成
+
+5. 注意事项：
+   - 优先级只影响出队顺序，不影响等待空间的顺序（那由发送任务的优先级决定）
+   - 老化阈值太小会让优先级失去意义，太大则低优先级延迟变长
+*/
@@ -0,0 +1,621 @@
+/*
+ * Demo: 按位索引等待者的事件组
+ * 学习要点：
+ * 1. 原生事件组设置事件位时，要扫描所有阻塞在它上面的任务，逐个检查等待条件
+ * 2. 按位索引：每个事件位有自己的等待者链表，设置某一位只检查关心这一位的任务
+ * 3. 等待任意位（wait-any）：任务挂在它等待的每一位的链表上，任意一位置位就唤醒
+ * 4. 等待所有位（wait-all）：任务只挂在"还缺的某一位"上（监视位），
+ *    监视位置位后若仍不满足，就换到下一个还缺的位，不会被无关的置位反复检查
+ * 5. 中断中置位：只在中断里把位写进去并登记，唤醒等待者的工作交给专用的分发任务，
+ *    不经过定时器守护任务的命令队列，多次中断置位合并成一次处理
+ * 6. 性能测试：120个等待任务下，每次置位检查的等待者数量和耗时
+ *
+ * 对应场景：demo8的system_events、sensor_events、network_events
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "../cycle_counter.h"
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES < 2)
+    #error "本demo需要至少2个任务通知槽"
+#endif
+
+
+// ==================== 位索引事件组 ====================
+#define EG_NUM_BITS         24              //与原生事件组一致，24个事件位
+#define EG_BITS_MASK        0x00FFFFFFUL
+#define EG_NOTIFY_INDEX     (configTASK_NOTIFICATION_ARRAY_ENTRIES-1)   //唤醒等待者用的通知槽
+
+//链表节点：pprev指向前一个节点的next（或链表头），摘除时不需要遍历
+typedef struct EgNode{
+    struct EgNode *next;
+    struct EgNode **pprev;
+}EgNode_t;
+
+//等待者：放在等待任务自己的栈上，每个事件位一个节点，只使用等待掩码中的那些
+typedef struct{
+    TaskHandle_t task;
+    uint32_t mask;                  //等待的事件位
+    uint8_t wait_all;               //pdTRUE等待所有位，pdFALSE等待任意位
+    uint8_t clear_on_exit;          //满足后清除等待的位
+    uint8_t watch_bit;              //wait-all当前挂在哪一位上
+    volatile uint8_t done;          //置位方已经唤醒了这个等待者
+    uint32_t result;                //唤醒时的事件位
+    EgNode_t nodes[EG_NUM_BITS];
+}EgWaiter_t;
+
+typedef struct IdxEventGroup{
+    volatile uint32_t bits;                     //当前事件位
+    volatile uint32_t isr_pending;              //中断里置位、还没处理等待者的位
+    struct IdxEventGroup *next_pending;         //待分发链表
+    volatile uint8_t queued;                    //是否已在待分发链表上
+    BaseType_t use_index;                       //pdFALSE时退化为线性扫描（用于对比）
+
+    EgNode_t *any_list[EG_NUM_BITS];            //按位索引的wait-any等待者
+    EgNode_t *all_list[EG_NUM_BITS];            //按监视位索引的wait-all等待者
+    EgNode_t *linear_list;                      //线性模式：所有等待者一条链表
+
+    //统计信息
+    uint32_t waiter_count;
+    uint32_t set_calls;
+    uint32_t waiters_examined;                  //置位时检查过的等待者总数
+    uint32_t wakeups;
+    uint32_t isr_sets;
+    uint32_t deferred_batches;                  //分发任务处理的批次
+}IdxEventGroup_t;
+
+static IdxEventGroup_t *eg_pending_head;        //中断置位后等待分发的事件组
+static TaskHandle_t eg_dispatch_handle;
+
+
+void EventGroup_Init(IdxEventGroup_t *eg, BaseType_t use_index){
+    memset(eg,0,sizeof(IdxEventGroup_t));
+    eg->use_index=use_index;
+}
+
+
+static inline uint32_t lowest_bit(uint32_t value){
+    return (uint32_t)__builtin_ctz(value);
+}
+
+static void node_push(EgNode_t **head, EgNode_t *node){
+    node->next=*head;
+    node->pprev=head;
+    if(*head!=NULL){
+        (*head)->pprev=&node->next;
+    }
+    *head=node;
+}
+
+static void node_unlink(EgNode_t *node){
+    *node->pprev=node->next;
+    if(node->next!=NULL){
+        node->next->pprev=node->pprev;
+    }
+}
+
+//由第bit个节点找到所属的等待者
+static inline EgWaiter_t *node_owner(EgNode_t *node, uint32_t bit){
+    return (EgWaiter_t*)((char*)(node-bit)-offsetof(EgWaiter_t,nodes));
+}
+
+static inline BaseType_t waiter_satisfied(const EgWaiter_t *w, uint32_t bits){
+    return w->wait_all?((bits&w->mask)==w->mask):((bits&w->mask)!=0);
+}
+
+//事件位的读改写：任务和中断都会修改，用可在中断中使用的临界段保护
+static void eg_bits_clear(IdxEventGroup_t *eg, uint32_t clear){
+    UBaseType_t saved=taskENTER_CRITICAL_FROM_ISR();
+    eg->bits&=~clear;
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+}
+
+static void eg_bits_set(IdxEventGroup_t *eg, uint32_t set){
+    UBaseType_t saved=taskENTER_CRITICAL_FROM_ISR();
+    eg->bits|=set;
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+}
+
+
+//以下等待者链表操作都在vTaskSuspendAll()下进行，中断不会碰这些链表
+
+/**
+ * 挂入等待者
+ * bits：判断不满足时用的事件位快照。快照之后中断设置的位记在isr_pending里，
+ *       分发任务处理时一定能在链表上看到这个等待者，不会丢失唤醒
+ */
+static void eg_link_waiter(IdxEventGroup_t *eg, EgWaiter_t *w, uint32_t bits){
+    if(!eg->use_index){
+        node_push(&eg->linear_list,&w->nodes[0]);
+    }else if(w->wait_all){
+        uint32_t bit=lowest_bit(w->mask&~bits);
+        w->watch_bit=(uint8_t)bit;
+        node_push(&eg->all_list[bit],&w->nodes[bit]);
+    }else{
+        for(uint32_t todo=w->mask;todo!=0;todo&=todo-1){
+            uint32_t bit=lowest_bit(todo);
+            node_push(&eg->any_list[bit],&w->nodes[bit]);
+        }
+    }
+    eg->waiter_count++;
+}
+
+static void eg_unlink_waiter(IdxEventGroup_t *eg, EgWaiter_t *w){
+    if(!eg->use_index){
+        node_unlink(&w->nodes[0]);
+    }else if(w->wait_all){
+        node_unlink(&w->nodes[w->watch_bit]);
+    }else{
+        for(uint32_t todo=w->mask;todo!=0;todo&=todo-1){
+            node_unlink(&w->nodes[lowest_bit(todo)]);
+        }
+    }
+    eg->waiter_count--;
+}
+
+//唤醒等待者：先摘链表、写结果，最后才通知（通知之后等待者的栈可能就失效了）
+static void eg_wake_waiter(IdxEventGroup_t *eg, EgWaiter_t *w, uint32_t bits, uint32_t *clear){
+    eg_unlink_waiter(eg,w);
+    if(w->clear_on_exit){
+        *clear|=w->mask;
+    }
+    w->result=bits;
+    w->done=pdTRUE;
+    eg->wakeups++;
+    xTaskNotifyGiveIndexed(w->task,EG_NOTIFY_INDEX);
+}
+
+/**
+ * 处理新置位的事件位
+ * 功能：只检查关心changed中某一位的等待者；满足的唤醒，
+ *      不满足的wait-all等待者换到下一个还缺的位上继续监视
+ */
+static void eg_process(IdxEventGroup_t *eg, uint32_t changed){
+    uint32_t bits=eg->bits;
+    uint32_t clear=0;
+    EgNode_t *node,*next;
+
+    if(!eg->use_index){
+        //线性模式：与原生事件组一样扫描全部等待者
+        for(node=eg->linear_list;node!=NULL;node=next){
+            EgWaiter_t *w=node_owner(node,0);
+            next=node->next;
+            eg->waiters_examined++;
+            if(waiter_satisfied(w,bits)){
+                eg_wake_waiter(eg,w,bits,&clear);
+            }
+        }
+    }else{
+        for(uint32_t todo=changed&bits;todo!=0;todo&=todo-1){
+            uint32_t bit=lowest_bit(todo);
+
+            //wait-any：这一位置位，链表上的等待者全部满足
+            for(node=eg->any_list[bit];node!=NULL;node=next){
+                next=node->next;
+                eg->waiters_examined++;
+                eg_wake_waiter(eg,node_owner(node,bit),bits,&clear);
+            }
+
+            //wait-all：满足就唤醒，否则换到下一个还缺的位（那一位没置位，不在todo里）
+            for(node=eg->all_list[bit];node!=NULL;node=next){
+                EgWaiter_t *w=node_owner(node,bit);
+                next=node->next;
+                eg->waiters_examined++;
+                if(waiter_satisfied(w,bits)){
+                    eg_wake_waiter(eg,w,bits,&clear);
+                }else{
+                    uint32_t watch=lowest_bit(w->mask&~bits);
+                    node_unlink(node);
+                    w->watch_bit=(uint8_t)watch;
+                    node_push(&eg->all_list[watch],&w->nodes[watch]);
+                }
+            }
+        }
+    }
+
+    //与原生事件组一样，所有等待者处理完之后才执行退出时清除
+    if(clear!=0){
+        eg_bits_clear(eg,clear);
+    }
+}
+
+
+/**
+ * 设置事件位（任务中调用）
+ * 返回：处理完等待者（含退出时清除）之后的事件位
+ */
+uint32_t EventGroup_SetBits(IdxEventGroup_t *eg, uint32_t set){
+    uint32_t bits;
+
+    set&=EG_BITS_MASK;
+
+    vTaskSuspendAll();
+    {
+        eg_bits_set(eg,set);
+        eg->set_calls++;
+        eg_process(eg,set);
+        bits=eg->bits;
+    }
+    xTaskResumeAll();
+
+    return bits;
+}
+
+/**
+ * 清除事件位
+ * 返回：清除之前的事件位
+ */
+uint32_t EventGroup_ClearBits(IdxEventGroup_t *eg, uint32_t clear){
+    uint32_t old;
+    UBaseType_t saved=taskENTER_CRITICAL_FROM_ISR();
+
+    old=eg->bits;
+    eg->bits&=~(clear&EG_BITS_MASK);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    return old;
+}
+
+static inline uint32_t EventGroup_GetBits(IdxEventGroup_t *eg){
+    return eg->bits;
+}
+
+
+/**
+ * 在中断中设置事件位
+ * 功能：位立即生效（GetBits和不阻塞的等待马上能看到），唤醒等待者推迟到分发任务
+ *      同一个事件组在分发前多次置位只登记一次，合并成一批处理
+ */
+void EventGroup_SetBitsFromISR(IdxEventGroup_t *eg, uint32_t set, BaseType_t *pxHigherPriorityTaskWoken){
+    UBaseType_t saved;
+
+    set&=EG_BITS_MASK;
+
+    saved=taskENTER_CRITICAL_FROM_ISR();
+    {
+        eg->bits|=set;
+        eg->isr_pending|=set;
+        eg->isr_sets++;
+        if(!eg->queued){
+            eg->queued=pdTRUE;
+            eg->next_pending=eg_pending_head;
+            eg_pending_head=eg;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    vTaskNotifyGiveFromISR(eg_dispatch_handle,pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 分发任务：处理中断里置位的事件组
+ * 优先级应高于所有等待事件的任务，唤醒延迟只是一次任务切换
+ */
+void EventGroup_DispatchTask(void *pvParameters){
+    for(;;){
+        IdxEventGroup_t *list;
+
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+
+        taskENTER_CRITICAL();
+        list=eg_pending_head;
+        eg_pending_head=NULL;
+        taskEXIT_CRITICAL();
+
+        while(list!=NULL){
+            IdxEventGroup_t *eg=list;
+            uint32_t pending;
+
+            //先取next再清queued，清了之后中断可能立刻把它重新挂到新链表上
+            taskENTER_CRITICAL();
+            list=eg->next_pending;
+            pending=eg->isr_pending;
+            eg->isr_pending=0;
+            eg->queued=pdFALSE;
+            taskEXIT_CRITICAL();
+
+            vTaskSuspendAll();
+            eg->deferred_batches++;
+            eg_process(eg,pending);
+            xTaskResumeAll();
+        }
+    }
+}
+
+
+/**
+ * 等待事件位
+ * 参数：mask - 等待的位；clear_on_exit - 满足后清除这些位；
+ *      wait_all - pdTRUE等待所有位；timeout - 最长等待时间
+ * 返回：满足时的事件位（清除前），超时返回当前事件位
+ */
+uint32_t EventGroup_WaitBits(IdxEventGroup_t *eg, uint32_t mask, BaseType_t clear_on_exit,
+                             BaseType_t wait_all, TickType_t timeout){
+    EgWaiter_t w;
+    uint32_t bits;
+    TickType_t start_tick=xTaskGetTickCount();
+    BaseType_t stale=pdFALSE;
+
+    mask&=EG_BITS_MASK;
+    configASSERT(mask!=0);
+
+    w.task=xTaskGetCurrentTaskHandle();
+    w.mask=mask;
+    w.wait_all=(uint8_t)(wait_all?pdTRUE:pdFALSE);
+    w.clear_on_exit=(uint8_t)(clear_on_exit?pdTRUE:pdFALSE);
+    w.done=pdFALSE;
+
+    vTaskSuspendAll();
+    {
+        bits=eg->bits;
+        if(waiter_satisfied(&w,bits)){
+            if(clear_on_exit){
+                eg_bits_clear(eg,mask);
+            }
+            xTaskResumeAll();
+            return bits;
+        }
+        if(timeout==0){
+            xTaskResumeAll();
+            return bits;
+        }
+        eg_link_waiter(eg,&w,bits);
+    }
+    xTaskResumeAll();
+
+    for(;;){
+        TickType_t elapsed=xTaskGetTickCount()-start_tick;
+        TickType_t remaining=(timeout==portMAX_DELAY)?portMAX_DELAY:
+                             (elapsed>=timeout?0:timeout-elapsed);
+
+        ulTaskNotifyTakeIndexed(EG_NOTIFY_INDEX,pdTRUE,remaining);
+        if(w.done){
+            return w.result;
+        }
+        if(remaining==0){
+            break;
+        }
+    }
+
+    //超时：退出链表；如果恰好被唤醒，以唤醒为准并清掉迟到的通知
+    vTaskSuspendAll();
+    {
+        if(w.done){
+            bits=w.result;
+            stale=pdTRUE;
+        }else{
+            eg_unlink_waiter(eg,&w);
+            bits=eg->bits;
+        }
+    }
+    xTaskResumeAll();
+
+    if(stale){
+        ulTaskNotifyValueClearIndexed(NULL,EG_NOTIFY_INDEX,0xFFFFFFFF);
+    }
+    return bits;
+}
+
+
+// ==================== demo8的系统初始化与传感器事件 ====================
+static IdxEventGroup_t system_events;
+static IdxEventGroup_t sensor_events;
+
+//系统事件位定义
+#define SYSTEM_INIT_COMPLETE    (1<<0)      //系统初始化完成
+#define HARDWARE_READY          (1<<1)      //硬件准备就绪
+#define CONFIG_LOADED           (1<<2)      //配置加载完成
+#define NETWORK_CONNECTED       (1<<3)      //网络连接成功
+#define ALL_SYSTEMS_READY       (SYSTEM_INIT_COMPLETE | HARDWARE_READY | CONFIG_LOADED | NETWORK_CONNECTED)
+
+// 传感器事件位定义
+#define TEMP_SENSOR_READY      (1 << 0)     //温度传感器就绪
+#define HUMIDITY_SENSOR_READY  (1 << 1)     //湿度传感器就绪
+#define PRESSURE_SENSOR_READY  (1 << 2)     //压力传感器就绪
+#define LIGHT_SENSOR_READY     (1 << 3)     //光照传感器就绪
+#define ALL_SENSORS_READY      (TEMP_SENSOR_READY | HUMIDITY_SENSOR_READY | PRESSURE_SENSOR_READY | LIGHT_SENSOR_READY)
+
+// 初始化任务：参数是它负责的事件位，延时模拟初始化耗时
+void init_task(void *pvParameters){
+    uint32_t bit=(uint32_t)(uintptr_t)pvParameters;
+
+    vTaskDelay(pdMS_TO_TICKS(500+bit*300));
+    printf("[初始化] 事件位0x%02lX完成\n", bit);
+
+    if(bit==NETWORK_CONNECTED){
+        //网络需要等硬件和配置就绪
+        EventGroup_WaitBits(&system_events,HARDWARE_READY|CONFIG_LOADED,pdFALSE,pdTRUE,portMAX_DELAY);
+    }
+    EventGroup_SetBits(&system_events,bit);
+
+    vTaskDelete(NULL);
+}
+
+void main_app_task(void *pvParameters){
+    uint32_t bits;
+
+    printf("[主应用] 等待所有子系统准备就绪...\n");
+    bits=EventGroup_WaitBits(&system_events,ALL_SYSTEMS_READY,pdFALSE,pdTRUE,pdMS_TO_TICKS(15000));
+
+    if((bits&ALL_SYSTEMS_READY)==ALL_SYSTEMS_READY){
+        printf("[主应用] 所有子系统准备就绪，主应用开始运行！\n");
+    }else{
+        printf("[主应用] 系统初始化超时！当前状态: 0x%02lX\n", bits);
+    }
+
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(5000));
+        printf("[主应用] 系统事件0x%02lX 传感器事件0x%02lX，中断置位%lu次，分发%lu批\n",
+               EventGroup_GetBits(&system_events), EventGroup_GetBits(&sensor_events),
+               sensor_events.isr_sets, sensor_events.deferred_batches);
+    }
+}
+
+// 模拟中断：传感器数据就绪中断在ISR里置位
+void simulate_sensor_interrupt(uint32_t sensor_bit){
+    BaseType_t higher_priority_task_woken=pdFALSE;
+
+    EventGroup_SetBitsFromISR(&sensor_events,sensor_bit,&higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+void interrupt_simulator_task(void *pvParameters){
+    uint32_t sensor=0;
+
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(700));
+        simulate_sensor_interrupt(1UL<<(sensor++%4));
+    }
+}
+
+void sensor_monitor_task(void *pvParameters){
+    for(;;){
+        //任意传感器就绪，并清除这些位
+        uint32_t bits=EventGroup_WaitBits(&sensor_events,ALL_SENSORS_READY,pdTRUE,pdFALSE,pdMS_TO_TICKS(5000));
+
+        if(bits&ALL_SENSORS_READY){
+            printf("[传感器监控] 就绪: 0x%02lX\n", bits&ALL_SENSORS_READY);
+        }else{
+            printf("[传感器监控] 5秒内没有传感器就绪\n");
+        }
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_WAITERS       120     //等待任务数量
+#define BENCH_ROUNDS        500     //每种模式置位次数
+#define BENCH_SPREAD_BITS   20      //等待者分散在0~19位上
+#define BENCH_COMMON_BIT    20      //wait-all等待者都需要的公共位
+
+static IdxEventGroup_t bench_groups[2];         //[0]按位索引 [1]线性扫描
+static IdxEventGroup_t *volatile bench_group;
+
+/**
+ * 等待任务
+ * 偶数号：wait-any等待第i/2%20位
+ * 奇数号：wait-all等待第i/2%20位和公共位20
+ */
+void bench_waiter_task(void *pvParameters){
+    uint32_t id=(uint32_t)(uintptr_t)pvParameters;
+    uint32_t bit=1UL<<((id/2)%BENCH_SPREAD_BITS);
+    BaseType_t wait_all=(id&1)?pdTRUE:pdFALSE;
+    uint32_t mask=wait_all?(bit|(1UL<<BENCH_COMMON_BIT)):bit;
+
+    for(;;){
+        IdxEventGroup_t *eg=bench_group;
+
+        if(eg==NULL){
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        //带超时，切换模式后能回到新的事件组上
+        EventGroup_WaitBits(eg,mask,pdFALSE,wait_all,pdMS_TO_TICKS(100));
+    }
+}
+
+void bench_controller_task(void *pvParameters){
+    static const char *mode_names[2]={"按位索引","线性扫描"};
+
+    vTaskDelay(pdMS_TO_TICKS(20000));       //demo8部分先跑完
+    cycle_counter_init();
+
+    printf("\n[性能测试] %d个等待任务，每种模式置位%d次（%s）\n", BENCH_WAITERS, BENCH_ROUNDS, CYCLE_UNIT);
+    printf("  模式      平均耗时/次  平均检查等待者/次  唤醒次数\n");
+
+    for(int mode=0;mode<2;mode++){
+        IdxEventGroup_t *eg=&bench_groups[mode];
+        uint32_t total_cycles=0;
+
+        bench_group=eg;
+        vTaskDelay(pdMS_TO_TICKS(200));     //等所有等待者挂到新的事件组上
+        eg->waiters_examined=0;
+        eg->wakeups=0;
+
+        for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+            uint32_t set=1UL<<(r%BENCH_SPREAD_BITS);
+            uint32_t start;
+
+            //每10轮连同公共位一起置位，让wait-all等待者也能满足
+            if(r%10==9){
+                set|=1UL<<BENCH_COMMON_BIT;
+            }
+
+            start=cycle_counter_get();
+            EventGroup_SetBits(eg,set);
+            total_cycles+=cycle_counter_get()-start;
+
+            EventGroup_ClearBits(eg,set);
+            vTaskDelay(1);                  //被唤醒的等待者重新挂回去
+        }
+
+        printf("  %s  %11lu  %17lu  %8lu\n", mode_names[mode],
+               total_cycles/BENCH_ROUNDS, eg->waiters_examined/BENCH_ROUNDS, eg->wakeups);
+    }
+
+    bench_group=NULL;
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 按位索引的事件组\n");
+
+    EventGroup_Init(&system_events,pdTRUE);
+    EventGroup_Init(&sensor_events,pdTRUE);
+    EventGroup_Init(&bench_groups[0],pdTRUE);
+    EventGroup_Init(&bench_groups[1],pdFALSE);
+
+    xTaskCreate(EventGroup_DispatchTask, "EGDispatch", 256, NULL, configMAX_PRIORITIES-1, &eg_dispatch_handle);
+
+    xTaskCreate(init_task, "SysInit", 256, (void*)SYSTEM_INIT_COMPLETE, 3, NULL);
+    xTaskCreate(init_task, "HwInit", 256, (void*)HARDWARE_READY, 3, NULL);
+    xTaskCreate(init_task, "Config", 256, (void*)CONFIG_LOADED, 3, NULL);
+    xTaskCreate(init_task, "Network", 256, (void*)NETWORK_CONNECTED, 3, NULL);
+    xTaskCreate(main_app_task, "MainApp", 256, NULL, 2, NULL);
+
+    xTaskCreate(interrupt_simulator_task, "IntSim", 256, NULL, 4, NULL);
+    xTaskCreate(sensor_monitor_task, "SensorMon", 256, NULL, 2, NULL);
+
+    for(uint32_t i=0;i<BENCH_WAITERS;i++){
+        xTaskCreate(bench_waiter_task, "BenchWait", 256, (void*)(uintptr_t)i, 1, NULL);
+    }
+    xTaskCreate(bench_controller_task, "BenchCtrl", 512, NULL, 5, NULL);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 为什么原生事件组置位慢：
+   - 所有等待任务挂在一条链表上，每次置位都要逐个检查等待条件
+   - 等待者越多越慢，而且大部分检查都是"跟这一位无关"
+
+2. wait-any的索引：
+   - 等待者在每个等待位的链表上都有一个节点（节点放在等待者栈上，不动态分配）
+   - 置位时只遍历被置位的那几条链表，链表上的等待者一定满足
+   - 唤醒时把它从所有链表上摘掉，后面的位不会重复唤醒
+
+3. wait-all的监视位：
+   - 只挂在"还缺的最低位"上，别的位置位根本不会检查它
+   - 监视位置位后若仍有缺的位，就搬到下一个缺的位上
+   - 每个等待者在满足前最多被检查"等待位数"次
+
+4. 中断置位不经过定时器守护任务：
+   - 原生xEventGroupSetBitsFromISR要往定时器命令队列发命令，队列满会失败
+   - 这里中断只写位并把事件组挂到待分发链表，分发任务一次处理所有积压的置位
+   - 位本身立即生效，只是唤醒等待者推迟了一次任务切换
+
+5. 注意事项：
+   - 等待者链表只在调度器挂起时修改，中断只改位和待分发链表
+   - 退出时清除在所有等待者处理完之后统一执行，与原生事件组语义一致
+*/
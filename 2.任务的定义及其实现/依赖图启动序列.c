@@ -0,0 +1,469 @@
+/*
+ * Demo: 按依赖图并行执行的启动序列
+ * 学习要点：
+ * 1. 每个子系统只声明"我依赖谁"，启动顺序由序列器根据依赖图自动决定
+ * 2. 依赖都满足的阶段立即交给工作任务并行执行（传感器初始化、加载配置、连接网络互不等待）
+ * 3. 启动前先做拓扑检查，发现循环依赖直接报错，而不是启动时死等
+ * 4. 某个阶段失败时，所有直接或间接依赖它的阶段都被跳过
+ * 5. 启动报告：每个阶段的开始/结束时刻、耗时、由哪个工作任务执行，
+ *    以及关键路径（决定总启动时间的那条依赖链）和相对顺序执行节省的时间
+ *
+ * 对应场景：demo8用事件位硬编码的启动顺序，
+ *          4.空闲任务与阻塞延时/工业数据采集与监控系统.c中SystemInit()顺序创建队列/互斥锁/任务
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+#include <stdio.h>
+#include <string.h>
+
+
+// ==================== 启动阶段描述 ====================
+#define BOOT_MAX_STAGES     32      //依赖用32位掩码表示
+#define BOOT_WORKERS        3       //并行执行阶段的工作任务数
+#define BOOT_WORKER_STACK   512
+#define BOOT_WORKER_PRIO    (tskIDLE_PRIORITY+3)
+
+#define BOOT_DEP(stage)     (1UL<<(stage))
+
+typedef struct{
+    const char *name;
+    BaseType_t (*init)(void);       //返回pdPASS表示成功
+    uint32_t deps;                  //依赖的阶段（BOOT_DEP(x)|BOOT_DEP(y)）
+}BootStage_t;
+
+typedef enum{
+    STAGE_PENDING=0,
+    STAGE_RUNNING,
+    STAGE_DONE,
+    STAGE_FAILED,
+    STAGE_SKIPPED                   //依赖的阶段失败
+}BootStageState_t;
+
+//每个阶段的运行记录
+typedef struct{
+    BootStageState_t state;
+    TickType_t start_tick;
+    TickType_t end_tick;
+    uint8_t worker;                 //由哪个工作任务执行
+    int8_t critical_dep;            //结束最晚的依赖（关键路径上的前驱），-1表示没有
+}BootRecord_t;
+
+//工作任务完成一个阶段后发给序列器的消息
+typedef struct{
+    uint8_t stage;
+    uint8_t worker;
+    BaseType_t result;
+}BootEvent_t;
+
+#define BOOT_STOP_WORKER    0xFF    //通知工作任务退出
+
+typedef struct{
+    const BootStage_t *stages;
+    uint32_t count;
+    BootRecord_t records[BOOT_MAX_STAGES];
+    QueueHandle_t ready_queue;      //依赖已满足、等待执行的阶段
+    QueueHandle_t done_queue;       //工作任务的完成消息
+    TickType_t boot_tick;           //序列器开始的时刻
+    TickType_t end_tick;            //所有阶段结束的时刻
+}BootSequencer_t;
+
+
+/**
+ * 拓扑检查（Kahn算法）
+ * 功能：检查依赖是否引用了不存在的阶段，以及是否存在循环依赖
+ * 返回：pdPASS依赖图合法
+ */
+static BaseType_t boot_check_graph(const BootStage_t *stages, uint32_t count){
+    uint32_t all=(count==32)?0xFFFFFFFFUL:((1UL<<count)-1);
+    uint32_t resolved=0;
+    BaseType_t progress=pdTRUE;
+
+    for(uint32_t i=0;i<count;i++){
+        if(stages[i].deps&~all){
+            printf("[启动] 阶段%s依赖了不存在的阶段\n", stages[i].name);
+            return pdFAIL;
+        }
+        if(stages[i].deps&BOOT_DEP(i)){
+            printf("[启动] 阶段%s依赖自己\n", stages[i].name);
+            return pdFAIL;
+        }
+    }
+
+    //反复找"依赖全部已解决"的阶段，直到没有进展
+    while(progress&&resolved!=all){
+        progress=pdFALSE;
+        for(uint32_t i=0;i<count;i++){
+            if(!(resolved&BOOT_DEP(i))&&(stages[i].deps&~resolved)==0){
+                resolved|=BOOT_DEP(i);
+                progress=pdTRUE;
+            }
+        }
+    }
+
+    if(resolved!=all){
+        printf("[启动] 发现循环依赖，涉及的阶段:");
+        for(uint32_t i=0;i<count;i++){
+            if(!(resolved&BOOT_DEP(i))){
+                printf(" %s", stages[i].name);
+            }
+        }
+        printf("\n");
+        return pdFAIL;
+    }
+    return pdPASS;
+}
+
+
+//工作任务：从就绪队列取阶段执行，完成后报告给序列器
+static BootSequencer_t *boot_seq;
+
+static void boot_worker_task(void *pvParameters){
+    uint8_t worker=(uint8_t)(uintptr_t)pvParameters;
+    uint8_t stage;
+
+    for(;;){
+        BootEvent_t event;
+
+        xQueueReceive(boot_seq->ready_queue,&stage,portMAX_DELAY);
+        if(stage==BOOT_STOP_WORKER){
+            //退出前回一条消息，之后不再访问任何队列，序列器收齐后才删除队列
+            event.stage=BOOT_STOP_WORKER;
+            event.worker=worker;
+            event.result=pdPASS;
+            xQueueSend(boot_seq->done_queue,&event,portMAX_DELAY);
+            vTaskDelete(NULL);
+        }
+
+        boot_seq->records[stage].start_tick=xTaskGetTickCount();
+        boot_seq->records[stage].worker=worker;
+
+        event.stage=stage;
+        event.worker=worker;
+        event.result=boot_seq->stages[stage].init();
+
+        boot_seq->records[stage].end_tick=xTaskGetTickCount();
+        xQueueSend(boot_seq->done_queue,&event,portMAX_DELAY);
+    }
+}
+
+
+//把依赖已满足的阶段放进就绪队列；依赖失败的阶段标记为跳过
+static uint32_t boot_dispatch_ready(BootSequencer_t *seq, uint32_t done_mask, uint32_t failed_mask){
+    uint32_t dispatched=0;
+    BaseType_t changed=pdTRUE;
+
+    //跳过可能是传递的（A失败→B跳过→C跳过），所以反复扫描直到稳定
+    while(changed){
+        changed=pdFALSE;
+        for(uint32_t i=0;i<seq->count;i++){
+            BootRecord_t *rec=&seq->records[i];
+
+            if(rec->state!=STAGE_PENDING){
+                continue;
+            }
+            if(seq->stages[i].deps&failed_mask){
+                rec->state=STAGE_SKIPPED;
+                failed_mask|=BOOT_DEP(i);
+                changed=pdTRUE;
+            }else if((seq->stages[i].deps&~done_mask)==0){
+                uint8_t stage=(uint8_t)i;
+                rec->state=STAGE_RUNNING;
+                xQueueSend(seq->ready_queue,&stage,0);     //队列长度等于阶段数，不会满
+                dispatched++;
+            }
+        }
+    }
+    return dispatched;
+}
+
+
+/**
+ * 运行启动序列
+ * 功能：检查依赖图，创建工作任务，按依赖关系并行执行所有阶段，结束后回收工作任务
+ *      必须在任务中调用（调度器已启动）
+ * 返回：pdPASS所有阶段都成功
+ */
+BaseType_t BootSequencer_Run(BootSequencer_t *seq, const BootStage_t *stages, uint32_t count){
+    uint32_t done_mask=0,failed_mask=0;
+    uint32_t in_flight;
+    uint8_t stop=BOOT_STOP_WORKER;
+
+    configASSERT(count>0&&count<=BOOT_MAX_STAGES);
+
+    memset(seq,0,sizeof(BootSequencer_t));
+    seq->stages=stages;
+    seq->count=count;
+    seq->boot_tick=xTaskGetTickCount();
+
+    if(boot_check_graph(stages,count)!=pdPASS){
+        return pdFAIL;
+    }
+
+    seq->ready_queue=xQueueCreate(count+BOOT_WORKERS,sizeof(uint8_t));
+    seq->done_queue=xQueueCreate(count,sizeof(BootEvent_t));
+    if(seq->ready_queue==NULL||seq->done_queue==NULL){
+        printf("[启动] 序列器队列创建失败\n");
+        return pdFAIL;
+    }
+
+    boot_seq=seq;
+    for(uint32_t w=0;w<BOOT_WORKERS;w++){
+        xTaskCreate(boot_worker_task,"BootWorker",BOOT_WORKER_STACK,(void*)(uintptr_t)w,BOOT_WORKER_PRIO,NULL);
+    }
+
+    in_flight=boot_dispatch_ready(seq,done_mask,failed_mask);
+
+    while(in_flight>0){
+        BootEvent_t event;
+
+        xQueueReceive(seq->done_queue,&event,portMAX_DELAY);
+        in_flight--;
+
+        if(event.result==pdPASS){
+            seq->records[event.stage].state=STAGE_DONE;
+            done_mask|=BOOT_DEP(event.stage);
+        }else{
+            seq->records[event.stage].state=STAGE_FAILED;
+            failed_mask|=BOOT_DEP(event.stage);
+            printf("[启动] 阶段%s失败\n", stages[event.stage].name);
+        }
+
+        in_flight+=boot_dispatch_ready(seq,done_mask,failed_mask);
+    }
+    seq->end_tick=xTaskGetTickCount();
+
+    for(uint32_t w=0;w<BOOT_WORKERS;w++){
+        xQueueSend(seq->ready_queue,&stop,portMAX_DELAY);
+    }
+
+    //等所有工作任务回复退出消息后才能删除队列，否则可能有工作任务还阻塞在队列上
+    for(uint32_t exited=0;exited<BOOT_WORKERS;){
+        BootEvent_t event;
+
+        xQueueReceive(seq->done_queue,&event,portMAX_DELAY);
+        if(event.stage==BOOT_STOP_WORKER){
+            exited++;
+        }
+    }
+    vQueueDelete(seq->ready_queue);
+    vQueueDelete(seq->done_queue);
+
+    return (failed_mask==0)?pdPASS:pdFAIL;
+}
+
+
+/**
+ * 启动报告
+ * 关键路径：从最后结束的阶段开始，沿"结束最晚的依赖"往回走
+ * 顺序执行耗时：所有阶段耗时之和，即原来SystemInit()一个接一个做的时间
+ */
+void BootSequencer_Report(BootSequencer_t *seq){
+    static const char *state_names[]={"等待","运行","完成","失败","跳过"};
+    uint32_t sequential=0;
+    int32_t last=-1;
+    TickType_t last_end=0;
+    int32_t path[BOOT_MAX_STAGES];
+    uint32_t path_len=0;
+
+    printf("\n========== 启动报告 ==========\n");
+    printf("  阶段          状态  工作者  开始(ms)  结束(ms)  耗时(ms)\n");
+
+    for(uint32_t i=0;i<seq->count;i++){
+        BootRecord_t *rec=&seq->records[i];
+        TickType_t latest=0;
+
+        rec->critical_dep=-1;
+        if(rec->state!=STAGE_DONE&&rec->state!=STAGE_FAILED){
+            printf("  %-12s  %s\n", seq->stages[i].name, state_names[rec->state]);
+            continue;
+        }
+
+        //关键前驱：结束最晚的依赖
+        for(uint32_t d=0;d<seq->count;d++){
+            if((seq->stages[i].deps&BOOT_DEP(d))&&seq->records[d].end_tick-seq->boot_tick>=latest){
+                latest=seq->records[d].end_tick-seq->boot_tick;
+                rec->critical_dep=(int8_t)d;
+            }
+        }
+
+        sequential+=(rec->end_tick-rec->start_tick)*portTICK_PERIOD_MS;
+        if(last<0||rec->end_tick-seq->boot_tick>=last_end){
+            last_end=rec->end_tick-seq->boot_tick;
+            last=(int32_t)i;
+        }
+
+        printf("  %-12s  %s  %6u  %8lu  %8lu  %8lu\n", seq->stages[i].name, state_names[rec->state],
+               rec->worker,
+               (uint32_t)((rec->start_tick-seq->boot_tick)*portTICK_PERIOD_MS),
+               (uint32_t)((rec->end_tick-seq->boot_tick)*portTICK_PERIOD_MS),
+               (uint32_t)((rec->end_tick-rec->start_tick)*portTICK_PERIOD_MS));
+    }
+
+    for(int32_t s=last;s>=0&&path_len<BOOT_MAX_STAGES;s=seq->records[s].critical_dep){
+        path[path_len++]=s;
+    }
+
+    printf("关键路径:");
+    while(path_len>0){
+        path_len--;
+        printf(" %s%s", seq->stages[path[path_len]].name, path_len?" ->":"");
+    }
+    printf("\n");
+
+    printf("并行启动总耗时: %lums，顺序执行需要: %lums，节省: %lums\n",
+           (uint32_t)((seq->end_tick-seq->boot_tick)*portTICK_PERIOD_MS), sequential,
+           sequential-(uint32_t)((seq->end_tick-seq->boot_tick)*portTICK_PERIOD_MS));
+}
+
+
+// ==================== 工业数据采集系统的启动阶段 ====================
+typedef struct {
+    float temperature;    // 温度 (°C)
+    float humidity;      // 湿度 (%)
+    float pressure;      // 压力 (kPa)
+    uint32_t timestamp;  // 时间戳
+    uint8_t status;      // 状态标志
+} SensorData_t;
+
+QueueHandle_t xSensorDataQueue;     // 原始数据队列
+SemaphoreHandle_t xDisplayMutex;   // 显示互斥锁
+EventGroupHandle_t xSystemEvents;  // 系统事件组
+
+typedef enum{
+    STAGE_KERNEL_OBJECTS=0,
+    STAGE_HARDWARE,
+    STAGE_BUS,
+    STAGE_SENSORS,
+    STAGE_CONFIG,
+    STAGE_NETWORK,
+    STAGE_MQTT,
+    STAGE_APPLICATION,
+    STAGE_COUNT
+}BootStageId_t;
+
+// SystemInit()里的队列/互斥锁/事件组创建
+static BaseType_t init_kernel_objects(void){
+    xSensorDataQueue=xQueueCreate(10,sizeof(SensorData_t));
+    xDisplayMutex=xSemaphoreCreateMutex();
+    xSystemEvents=xEventGroupCreate();
+    return (xSensorDataQueue&&xDisplayMutex&&xSystemEvents)?pdPASS:pdFAIL;
+}
+
+// demo8 hardware_init_task：GPIO+串口
+static BaseType_t init_hardware(void){
+    vTaskDelay(pdMS_TO_TICKS(600));
+    vTaskDelay(pdMS_TO_TICKS(400));
+    return pdPASS;
+}
+
+// demo8 hardware_init_task：SPI/I2C总线
+static BaseType_t init_bus(void){
+    vTaskDelay(pdMS_TO_TICKS(700));
+    return pdPASS;
+}
+
+// demo8 sensor_task：4个传感器初始化
+static BaseType_t init_sensors(void){
+    vTaskDelay(pdMS_TO_TICKS(800));
+    return pdPASS;
+}
+
+// demo8 config_task：读Flash+验证
+static BaseType_t init_config(void){
+    vTaskDelay(pdMS_TO_TICKS(1200));
+    vTaskDelay(pdMS_TO_TICKS(300));
+    return pdPASS;
+}
+
+// demo8 network_task：WiFi连接（需要串口模块和配置里的SSID）
+static BaseType_t init_network(void){
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    return pdPASS;
+}
+
+// demo8 network_service_task：MQTT连接
+static BaseType_t init_mqtt(void){
+    vTaskDelay(pdMS_TO_TICKS(500));
+    return pdPASS;
+}
+
+void main_app_task(void *pvParameters){
+    for(;;){
+        printf("[主应用] 运行中...\n");
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
+// SystemInit()里的任务创建：只依赖它真正需要的阶段
+static BaseType_t init_application(void){
+    return xTaskCreate(main_app_task,"MainApp",256,NULL,2,NULL);
+}
+
+static const BootStage_t system_stages[STAGE_COUNT]={
+    [STAGE_KERNEL_OBJECTS]={"内核对象", init_kernel_objects, 0},
+    [STAGE_HARDWARE]      ={"硬件",     init_hardware,       0},
+    [STAGE_BUS]           ={"总线",     init_bus,            BOOT_DEP(STAGE_HARDWARE)},
+    [STAGE_SENSORS]       ={"传感器",   init_sensors,        BOOT_DEP(STAGE_BUS)},
+    [STAGE_CONFIG]        ={"配置",     init_config,         0},
+    [STAGE_NETWORK]       ={"网络",     init_network,        BOOT_DEP(STAGE_HARDWARE)|BOOT_DEP(STAGE_CONFIG)},
+    [STAGE_MQTT]          ={"MQTT",     init_mqtt,           BOOT_DEP(STAGE_NETWORK)},
+    [STAGE_APPLICATION]   ={"应用任务", init_application,
+                            BOOT_DEP(STAGE_KERNEL_OBJECTS)|BOOT_DEP(STAGE_SENSORS)|BOOT_DEP(STAGE_CONFIG)},
+};
+
+static BootSequencer_t system_boot;
+
+void boot_task(void *pvParameters){
+    printf("=== 工业数据采集与监控系统启动 ===\n");
+
+    if(BootSequencer_Run(&system_boot,system_stages,STAGE_COUNT)==pdPASS){
+        printf("[启动] 所有阶段完成\n");
+    }else{
+        printf("[启动] 启动未完全成功\n");
+    }
+    BootSequencer_Report(&system_boot);
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 依赖图启动序列\n");
+
+    //序列器本身优先级高于工作任务，完成消息一到就能派发下一批
+    xTaskCreate(boot_task, "Boot", 512, NULL, BOOT_WORKER_PRIO+1, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 声明式依赖：
+   - 每个阶段只写deps，不再用事件位手工编排"谁等谁"
+   - 新增阶段只需要在表里加一行，序列器自动找到能并行的位置
+
+2. 调度方式：
+   - 序列器任务维护"已完成"掩码，依赖全部完成的阶段放进就绪队列
+   - 固定数量的工作任务从就绪队列取阶段执行，同时最多BOOT_WORKERS个阶段并行
+   - 阶段内部的vTaskDelay（等待硬件）不会占用其他阶段的执行机会
+
+3. 关键路径：
+   - 每个阶段的关键前驱是它结束最晚的依赖
+   - 从最后结束的阶段往回走，得到的链就是决定总启动时间的路径
+   - 要缩短启动时间，只有缩短关键路径上的阶段才有效
+
+4. 本例的结果：
+   - 顺序执行：所有阶段耗时之和，约6.5秒
+   - 并行执行：关键路径 配置 -> 网络 -> MQTT，约4秒
+
+5. 注意事项：
+   - 阶段函数在工作任务里执行，栈大小要按最大的阶段来设置
+   - 失败的阶段会让所有依赖它的阶段被跳过，报告里可以看到原因
+*/
@@ -0,0 +1,623 @@
+/*
+ * Demo: 可扩展的软件看门狗（O(1)喂狗 + 截止时间最小堆）
+ * 学习要点：
+ * 1. 看门狗.c的喂狗要按任务句柄线性查找，检查定时器每100ms扫一遍全部任务，最多10个任务
+ * 2. 线程本地存储指针：注册时把监控条目挂在任务上，喂狗只是取指针、写一次时间戳，O(1)
+ * 3. 截止时间最小堆：检查任务只看堆顶，睡到最早的截止时间才醒
+ * 4. 惰性更新：喂狗不动堆，堆顶到期时才看最近一次喂狗时间，喂过的重新算截止时间下沉
+ *    每个条目最多每个超时周期被调整一次，与喂狗频率无关
+ * 5. 每个任务独立的超时时间和恢复策略钩子（重新计时/停止监控/重启任务/系统复位）
+ * 6. 硬件看门狗只由检查任务喂，有任务超时且策略要求复位时停止喂硬件看门狗
+ * 7. 性能测试：200个被监控任务，与看门狗.c的线性查找对比喂狗和检查的开销
+ *
+ * 对应场景：看门狗.c的Example_Task，以及工业数据采集系统里几十上百个采集/通信任务的存活监控
+ *
+ * 需要在FreeRTOSConfig.h中设置：
+ *   #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 2   （索引0留给自适应互斥锁）
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../cycle_counter.h"
+
+#if (configNUM_THREAD_LOCAL_STORAGE_POINTERS < 2)
+    #error "本demo需要至少2个线程本地存储指针"
+#endif
+
+
+// ==================== 看门狗 ====================
+#define WATCHDOG_TLS_INDEX          1       //线程本地存储：任务的监控条目
+#define WATCHDOG_MAX_TASKS          512     //最大监控任务数
+#define WATCHDOG_EXPIRED_BATCH      8       //一次取出的超时条目上限，恢复钩子在临界段外执行
+#define WATCHDOG_HW_KICK_MS         500     //硬件看门狗喂狗间隔，必须小于硬件超时
+#define WATCHDOG_CHECKER_PRIORITY   (configMAX_PRIORITIES-1)
+#define WATCHDOG_CHECKER_STACK      512
+#define WATCHDOG_NOT_IN_HEAP        0xFFFFFFFFUL    //条目已被检查任务摘出，等待执行恢复钩子
+
+typedef enum{
+    WATCHDOG_ACTION_REARM=0,        //重新开始计时（只记录，继续监控）
+    WATCHDOG_ACTION_DISABLE,        //停止监控这个任务
+    WATCHDOG_ACTION_RESTARTED,      //钩子已经删除并重建了任务（新任务会重新注册）
+    WATCHDOG_ACTION_SYSTEM_RESET    //停止喂硬件看门狗，等待硬件复位
+}WatchdogAction_t;
+
+struct WatchdogEntry;
+
+/**
+ * 恢复策略钩子：在检查任务中调用（临界段外）
+ * 参数：entry 超时的条目；overdue 超过截止时间的tick数
+ * 返回：要执行的动作
+ */
+typedef WatchdogAction_t (*WatchdogRecovery_t)(struct WatchdogEntry *entry, TickType_t overdue);
+
+typedef struct WatchdogEntry{
+    TaskHandle_t task;
+    volatile TickType_t last_feed;      //喂狗只写这一个字段
+    TickType_t timeout;
+    TickType_t deadline;                //堆里的键：上次整理时算出的截止时间，可能落后于last_feed+timeout
+    uint32_t heap_index;
+    uint32_t timeouts;                  //超时次数
+    WatchdogRecovery_t recovery;        //NULL时使用默认钩子
+    void *context;                      //钩子用的用户数据（如重启任务用的入口函数）
+    struct WatchdogEntry *next_free;
+}WatchdogEntry_t;
+
+typedef struct{
+    WatchdogEntry_t entries[WATCHDOG_MAX_TASKS];
+    WatchdogEntry_t *heap[WATCHDOG_MAX_TASKS];
+    WatchdogEntry_t *free_list;
+    uint32_t heap_size;
+    TaskHandle_t checker;
+    TickType_t wake_tick;               //检查任务计划醒来的时刻
+    volatile bool system_reset;         //有策略要求复位，停止喂硬件看门狗
+
+    //统计信息
+    uint32_t checks;                    //检查任务醒来的次数
+    uint32_t rekeys;                    //堆顶到期但已喂过、重新下沉的次数
+    uint32_t expirations;
+    uint32_t check_cycles_max;          //一次检查在临界段内的最长时间
+    uint64_t check_cycles;
+}Watchdog_t;
+
+static Watchdog_t watchdog;
+
+
+static inline bool deadline_before(TickType_t a, TickType_t b){
+    return (int32_t)(a-b)<0;
+}
+
+static void heap_swap(uint32_t a, uint32_t b){
+    WatchdogEntry_t *tmp=watchdog.heap[a];
+    watchdog.heap[a]=watchdog.heap[b];
+    watchdog.heap[b]=tmp;
+    watchdog.heap[a]->heap_index=a;
+    watchdog.heap[b]->heap_index=b;
+}
+
+static void heap_sift_up(uint32_t i){
+    while(i>0){
+        uint32_t parent=(i-1)/2;
+        if(!deadline_before(watchdog.heap[i]->deadline,watchdog.heap[parent]->deadline)){
+            break;
+        }
+        heap_swap(i,parent);
+        i=parent;
+    }
+}
+
+static void heap_sift_down(uint32_t i){
+    for(;;){
+        uint32_t left=2*i+1,right=left+1,smallest=i;
+
+        if(left<watchdog.heap_size&&deadline_before(watchdog.heap[left]->deadline,watchdog.heap[smallest]->deadline)){
+            smallest=left;
+        }
+        if(right<watchdog.heap_size&&deadline_before(watchdog.heap[right]->deadline,watchdog.heap[smallest]->deadline)){
+            smallest=right;
+        }
+        if(smallest==i){
+            break;
+        }
+        heap_swap(i,smallest);
+        i=smallest;
+    }
+}
+
+static void heap_insert(WatchdogEntry_t *entry){
+    entry->heap_index=watchdog.heap_size;
+    watchdog.heap[watchdog.heap_size++]=entry;
+    heap_sift_up(entry->heap_index);
+}
+
+static void heap_remove(WatchdogEntry_t *entry){
+    uint32_t i=entry->heap_index;
+    uint32_t last=--watchdog.heap_size;
+
+    if(i!=last){
+        heap_swap(i,last);
+        heap_sift_down(i);
+        heap_sift_up(i);
+    }
+    entry->heap_index=WATCHDOG_NOT_IN_HEAP;
+}
+
+//把条目挂回堆里，截止时间比检查任务计划醒来的时刻早时通知它，调用者持有临界段
+static bool watchdog_arm_locked(WatchdogEntry_t *entry, TickType_t now){
+    entry->last_feed=now;
+    entry->deadline=now+entry->timeout;
+    heap_insert(entry);
+    return deadline_before(entry->deadline,watchdog.wake_tick);
+}
+
+//默认钩子：与看门狗.c一致，打印后停止监控
+static WatchdogAction_t watchdog_default_recovery(WatchdogEntry_t *entry, TickType_t overdue){
+    printf("[看门狗] 任务 %s 超时（超过%lu ms）\n", pcTaskGetName(entry->task), overdue*portTICK_PERIOD_MS);
+    return WATCHDOG_ACTION_DISABLE;
+}
+
+//喂硬件看门狗（实际工程中写IWDG->KR=0xAAAA之类的寄存器）
+static void hardware_watchdog_kick(void){
+}
+
+
+/**
+ * 喂狗：取当前任务的条目，写一次时间戳
+ * 没有查找、没有加锁，也不碰堆；未注册的任务调用直接返回
+ */
+void Watchdog_Feed(void){
+    WatchdogEntry_t *entry=pvTaskGetThreadLocalStoragePointer(NULL,WATCHDOG_TLS_INDEX);
+
+    if(entry!=NULL){
+        entry->last_feed=xTaskGetTickCount();
+    }
+}
+
+/**
+ * 注册任务到看门狗
+ * 参数：task 被监控任务（NULL表示当前任务）；timeout 超时时间；recovery 恢复钩子（NULL用默认钩子）
+ *      context 传给钩子的用户数据
+ * 返回：成功返回条目，条目用完返回NULL
+ */
+WatchdogEntry_t *Watchdog_RegisterTask(TaskHandle_t task, TickType_t timeout,
+                                       WatchdogRecovery_t recovery, void *context){
+    WatchdogEntry_t *entry;
+    bool kick;
+
+    if(task==NULL){
+        task=xTaskGetCurrentTaskHandle();
+    }
+
+    taskENTER_CRITICAL();
+    entry=watchdog.free_list;
+    if(entry==NULL){
+        taskEXIT_CRITICAL();
+        return NULL;
+    }
+    watchdog.free_list=entry->next_free;
+
+    entry->task=task;
+    entry->timeout=timeout;
+    entry->timeouts=0;
+    entry->recovery=(recovery!=NULL)?recovery:watchdog_default_recovery;
+    entry->context=context;
+    kick=watchdog_arm_locked(entry,xTaskGetTickCount());
+    vTaskSetThreadLocalStoragePointer(task,WATCHDOG_TLS_INDEX,entry);
+    taskEXIT_CRITICAL();
+
+    if(kick&&watchdog.checker!=NULL){
+        xTaskNotifyGive(watchdog.checker);
+    }
+    return entry;
+}
+
+//把条目还回空闲链表，调用者持有临界段，条目已经不在堆里
+static void watchdog_release_locked(WatchdogEntry_t *entry){
+    vTaskSetThreadLocalStoragePointer(entry->task,WATCHDOG_TLS_INDEX,NULL);
+    entry->task=NULL;
+    entry->next_free=watchdog.free_list;
+    watchdog.free_list=entry;
+}
+
+/**
+ * 取消监控（任务正常退出前调用）
+ * 参数：task 被监控任务，NULL表示当前任务
+ */
+void Watchdog_UnregisterTask(TaskHandle_t task){
+    WatchdogEntry_t *entry;
+
+    taskENTER_CRITICAL();
+    entry=pvTaskGetThreadLocalStoragePointer(task,WATCHDOG_TLS_INDEX);
+    if(entry!=NULL){
+        if(entry->heap_index!=WATCHDOG_NOT_IN_HEAP){
+            heap_remove(entry);
+            watchdog_release_locked(entry);
+        }else{
+            //检查任务正准备对它执行恢复钩子，交给检查任务回收
+            vTaskSetThreadLocalStoragePointer(entry->task,WATCHDOG_TLS_INDEX,NULL);
+            entry->task=NULL;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+/**
+ * 检查任务
+ * 1. 堆顶截止时间没到：睡到那个时刻（最长WATCHDOG_HW_KICK_MS，顺便喂硬件看门狗）
+ * 2. 堆顶到期但期间喂过：按最近一次喂狗重算截止时间，下沉，继续看新的堆顶
+ * 3. 真正超时：摘出来，退出临界段后调用恢复钩子
+ */
+static void watchdog_checker_task(void *pvParameters){
+    WatchdogEntry_t *expired[WATCHDOG_EXPIRED_BATCH];
+    TickType_t overdue[WATCHDOG_EXPIRED_BATCH];
+
+    for(;;){
+        TickType_t now=xTaskGetTickCount();
+        TickType_t delay=pdMS_TO_TICKS(WATCHDOG_HW_KICK_MS);
+        uint32_t count=0,start,cycles;
+        bool rearmed_sooner=false;
+
+        watchdog.checks++;
+
+        start=cycle_counter_get();
+        taskENTER_CRITICAL();
+        while(watchdog.heap_size>0&&count<WATCHDOG_EXPIRED_BATCH){
+            WatchdogEntry_t *top=watchdog.heap[0];
+            TickType_t fed_deadline;
+
+            if(deadline_before(now,top->deadline)){
+                break;
+            }
+            fed_deadline=top->last_feed+top->timeout;
+            if(deadline_before(now,fed_deadline)){
+                top->deadline=fed_deadline;
+                heap_sift_down(0);
+                watchdog.rekeys++;
+                continue;
+            }
+            heap_remove(top);
+            overdue[count]=now-fed_deadline;
+            expired[count++]=top;
+        }
+        if(watchdog.heap_size>0&&deadline_before(watchdog.heap[0]->deadline,now+delay)){
+            delay=watchdog.heap[0]->deadline-now;
+        }
+        watchdog.wake_tick=now+delay;
+        taskEXIT_CRITICAL();
+
+        cycles=cycle_counter_get()-start;
+        watchdog.check_cycles+=cycles;
+        if(cycles>watchdog.check_cycles_max){
+            watchdog.check_cycles_max=cycles;
+        }
+
+        for(uint32_t i=0;i<count;i++){
+            WatchdogEntry_t *entry=expired[i];
+            WatchdogAction_t action;
+
+            taskENTER_CRITICAL();
+            if(entry->task==NULL){
+                //摘出之后任务自己取消了监控
+                entry->next_free=watchdog.free_list;
+                watchdog.free_list=entry;
+                taskEXIT_CRITICAL();
+                continue;
+            }
+            taskEXIT_CRITICAL();
+
+            entry->timeouts++;
+            watchdog.expirations++;
+            action=entry->recovery(entry,overdue[i]);
+
+            taskENTER_CRITICAL();
+            if(entry->task==NULL){
+                //钩子执行期间任务取消了监控，不管钩子返回什么都只回收条目
+                entry->next_free=watchdog.free_list;
+                watchdog.free_list=entry;
+                taskEXIT_CRITICAL();
+                continue;
+            }
+            switch(action){
+                case WATCHDOG_ACTION_REARM:
+                    //新的截止时间可能早于上面算好的醒来时刻
+                    if(watchdog_arm_locked(entry,xTaskGetTickCount())){
+                        rearmed_sooner=true;
+                    }
+                    break;
+                case WATCHDOG_ACTION_SYSTEM_RESET:
+                    watchdog.system_reset=true;
+                    watchdog_release_locked(entry);
+                    break;
+                case WATCHDOG_ACTION_RESTARTED:
+                    //旧任务已被删除，不能再访问它的线程本地存储
+                    entry->task=NULL;
+                    entry->next_free=watchdog.free_list;
+                    watchdog.free_list=entry;
+                    break;
+                default:
+                    watchdog_release_locked(entry);
+                    break;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        if(!watchdog.system_reset){
+            hardware_watchdog_kick();
+        }
+
+        //一批没取完，或者重新挂回的条目比计划的醒来时刻更早到期，马上再检查一次
+        if(count==WATCHDOG_EXPIRED_BATCH||rearmed_sooner){
+            continue;
+        }
+        ulTaskNotifyTake(pdTRUE,delay);
+    }
+}
+
+
+//初始化看门狗
+BaseType_t Watchdog_Init(void){
+    memset(&watchdog,0,sizeof(watchdog));
+    for(uint32_t i=0;i<WATCHDOG_MAX_TASKS;i++){
+        watchdog.entries[i].next_free=(i+1<WATCHDOG_MAX_TASKS)?&watchdog.entries[i+1]:NULL;
+    }
+    watchdog.free_list=&watchdog.entries[0];
+    watchdog.wake_tick=xTaskGetTickCount();
+
+    return xTaskCreate(watchdog_checker_task,"WdgCheck",WATCHDOG_CHECKER_STACK,NULL,
+                       WATCHDOG_CHECKER_PRIORITY,&watchdog.checker);
+}
+
+
+// ==================== 示例任务 ====================
+static volatile uint32_t hang_generation=0;
+
+void Example_Task(void *pvParameters){
+    //注册任务：1秒超时，默认钩子
+    Watchdog_RegisterTask(NULL,pdMS_TO_TICKS(1000),NULL,NULL);
+
+    while(1){
+        //模拟正常任务
+        Watchdog_Feed();
+        printf("Task %s running...\n", pcTaskGetName(NULL));
+        vTaskDelay(pdMS_TO_TICKS(500)); //每500ms喂狗
+    }
+}
+
+//恢复钩子：删除卡死的任务，用注册时保存的入口函数重建
+//任务可能在钩子执行期间取消监控（entry->task被清成NULL），所以先取一份句柄；
+//句柄为NULL时不能继续，否则vTaskDelete(NULL)删掉的是检查任务自己
+static WatchdogAction_t restart_task_recovery(WatchdogEntry_t *entry, TickType_t overdue){
+    TaskFunction_t entry_point=(TaskFunction_t)entry->context;
+    TaskHandle_t task=entry->task;
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t priority;
+
+    if(task==NULL){
+        return WATCHDOG_ACTION_DISABLE;
+    }
+    priority=uxTaskPriorityGet(task);
+    strncpy(name,pcTaskGetName(task),sizeof(name)-1);
+    name[sizeof(name)-1]='\0';
+    printf("[看门狗] 任务 %s 超时%lu ms，重启任务\n", name, overdue*portTICK_PERIOD_MS);
+
+    vTaskDelete(task);
+    xTaskCreate(entry_point,name,256,NULL,priority,NULL);
+    return WATCHDOG_ACTION_RESTARTED;
+}
+
+/**
+ * 会卡死的任务：喂10次后进入死循环等待（模拟等一个永远不来的信号）
+ */
+void Hanging_Task(void *pvParameters){
+    Watchdog_RegisterTask(NULL,pdMS_TO_TICKS(300),restart_task_recovery,(void*)Hanging_Task);
+    hang_generation++;
+    printf("Task %s 第%lu次启动\n", pcTaskGetName(NULL), hang_generation);
+
+    for(uint32_t i=0;i<10;i++){
+        Watchdog_Feed();
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+//恢复钩子：只记录，继续监控（允许偶尔超时的慢任务）
+static WatchdogAction_t log_only_recovery(WatchdogEntry_t *entry, TickType_t overdue){
+    printf("[看门狗] 任务 %s 第%lu次超时，继续监控\n", pcTaskGetName(entry->task), entry->timeouts);
+    return WATCHDOG_ACTION_REARM;
+}
+
+/**
+ * 慢任务：5秒超时，偶尔一次处理要6秒
+ */
+void Slow_Task(void *pvParameters){
+    uint32_t round=0;
+
+    Watchdog_RegisterTask(NULL,pdMS_TO_TICKS(5000),log_only_recovery,NULL);
+
+    for(;;){
+        Watchdog_Feed();
+        round++;
+        vTaskDelay(pdMS_TO_TICKS((round%4==0)?6000:2000));
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_TASKS             200     //被监控任务数
+#define BENCH_RUN_MS            5000
+#define BENCH_LEGACY_CHECK_MS   100     //看门狗.c的检查周期
+
+//看门狗.c的做法：按句柄线性查找的表
+typedef struct{
+    TaskHandle_t task_handle;
+    uint32_t last_feed_time;
+    bool is_active;
+}LegacyWatchdogTask_t;
+
+static LegacyWatchdogTask_t legacy_tasks[BENCH_TASKS];
+static volatile uint32_t legacy_count=0;
+
+static volatile uint64_t bench_feed_cycles;
+static volatile uint64_t bench_legacy_feed_cycles;
+static volatile uint32_t bench_feeds;
+static volatile bool bench_running=false;
+
+static void legacy_feed(void){
+    TaskHandle_t current_task=xTaskGetCurrentTaskHandle();
+    for(uint32_t i=0;i<legacy_count;i++){
+        if(legacy_tasks[i].task_handle==current_task&&legacy_tasks[i].is_active){
+            legacy_tasks[i].last_feed_time=xTaskGetTickCount();
+            break;
+        }
+    }
+}
+
+static uint32_t legacy_check(void){
+    uint32_t current_time=xTaskGetTickCount(),missed=0;
+    for(uint32_t i=0;i<legacy_count;i++){
+        if(legacy_tasks[i].is_active&&(current_time-legacy_tasks[i].last_feed_time)>pdMS_TO_TICKS(1000)){
+            missed++;
+        }
+    }
+    return missed;
+}
+
+/**
+ * 被监控的工作任务：超时时间100ms~2s不等，按超时的一半喂狗，两种喂法都计时
+ */
+void bench_worker_task(void *pvParameters){
+    uint32_t index=(uint32_t)(uintptr_t)pvParameters;
+    TickType_t timeout=pdMS_TO_TICKS(100+(index*37)%1900);
+
+    Watchdog_RegisterTask(NULL,timeout,NULL,NULL);
+    taskENTER_CRITICAL();
+    legacy_tasks[legacy_count].task_handle=xTaskGetCurrentTaskHandle();
+    legacy_tasks[legacy_count].last_feed_time=xTaskGetTickCount();
+    legacy_tasks[legacy_count].is_active=true;
+    legacy_count++;
+    taskEXIT_CRITICAL();
+
+    for(;;){
+        uint32_t start,mid,end;
+
+        start=cycle_counter_get();
+        Watchdog_Feed();
+        mid=cycle_counter_get();
+        legacy_feed();
+        end=cycle_counter_get();
+
+        if(bench_running){
+            taskENTER_CRITICAL();
+            bench_feed_cycles+=mid-start;
+            bench_legacy_feed_cycles+=end-mid;
+            bench_feeds++;
+            taskEXIT_CRITICAL();
+        }
+        vTaskDelay(timeout/2);
+    }
+}
+
+void bench_task(void *pvParameters){
+    uint32_t checks,rekeys;
+    uint64_t check_cycles;
+    uint64_t legacy_cycles=0;
+    uint32_t legacy_checks=0;
+    TickType_t start_tick,last_wake;
+
+    vTaskDelay(pdMS_TO_TICKS(8000));
+    cycle_counter_init();
+
+    for(uint32_t i=0;i<BENCH_TASKS;i++){
+        if(xTaskCreate(bench_worker_task,"Worker",configMINIMAL_STACK_SIZE,(void*)(uintptr_t)i,1,NULL)!=pdPASS){
+            printf("工作任务创建失败（%lu个）\n", i);
+            break;
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(2500));       //等所有工作任务至少喂过一次
+
+    checks=watchdog.checks;
+    rekeys=watchdog.rekeys;
+    check_cycles=watchdog.check_cycles;
+    bench_feeds=0;
+    bench_feed_cycles=0;
+    bench_legacy_feed_cycles=0;
+    bench_running=true;
+
+    //同时按看门狗.c的方式每100ms扫描一遍，计时
+    start_tick=xTaskGetTickCount();
+    last_wake=start_tick;
+    while(xTaskGetTickCount()-start_tick<pdMS_TO_TICKS(BENCH_RUN_MS)){
+        uint32_t start;
+
+        vTaskDelayUntil(&last_wake,pdMS_TO_TICKS(BENCH_LEGACY_CHECK_MS));
+        start=cycle_counter_get();
+        legacy_check();
+        legacy_cycles+=cycle_counter_get()-start;
+        legacy_checks++;
+    }
+    bench_running=false;
+
+    checks=watchdog.checks-checks;
+    rekeys=watchdog.rekeys-rekeys;
+    check_cycles=watchdog.check_cycles-check_cycles;
+
+    printf("\n[性能测试] %lu个被监控任务，%dms内（%s）\n", legacy_count, BENCH_RUN_MS, CYCLE_UNIT);
+    printf("  方式            平均喂狗  检查次数  检查总开销\n");
+    printf("  TLS+最小堆      %8lu  %8lu  %10lu\n",
+           (uint32_t)(bench_feed_cycles/(bench_feeds?bench_feeds:1)), checks, (uint32_t)check_cycles);
+    printf("  线性表(看门狗.c)%8lu  %8lu  %10lu\n",
+           (uint32_t)(bench_legacy_feed_cycles/(bench_feeds?bench_feeds:1)), legacy_checks, (uint32_t)legacy_cycles);
+    printf("  喂狗%lu次，堆顶重算%lu次，单次检查最长%lu\n", bench_feeds, rekeys, watchdog.check_cycles_max);
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    if(Watchdog_Init()!=pdPASS){
+        printf("Failed to create watchdog checker!\n");
+        return -1;
+    }
+
+    //创建示例任务
+    xTaskCreate(Example_Task, "ExampleTask", 256, NULL, tskIDLE_PRIORITY + 1, NULL);
+    xTaskCreate(Hanging_Task, "HangingTask", 256, NULL, tskIDLE_PRIORITY + 1, NULL);
+    xTaskCreate(Slow_Task, "SlowTask", 256, NULL, tskIDLE_PRIORITY + 1, NULL);
+    xTaskCreate(bench_task, "Bench", 512, NULL, tskIDLE_PRIORITY + 2, NULL);
+
+    //启动FreeRTOS调度器
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. O(1)喂狗：
+   - 注册时把条目指针存进任务的线程本地存储，喂狗直接取出来写时间戳
+   - 喂狗不加锁：只写一个TickType_t，32位写是原子的
+
+2. 截止时间最小堆：
+   - 检查任务只比较堆顶，睡到最早的截止时间
+   - 几百个任务时，大部分检查只看一两个条目
+
+3. 惰性更新：
+   - 喂狗不调整堆，堆里的截止时间可能是"旧的"
+   - 堆顶到期时按last_feed重算，喂过就下沉，没喂过才是真超时
+   - 每个条目每个超时周期最多被调整一次，喂得再勤也不增加检查开销
+
+4. 恢复策略：
+   - 每个任务独立的超时时间和钩子，钩子在临界段外执行
+   - 重新计时、停止监控、重启任务、停止喂硬件看门狗等待复位
+   - 重启任务后旧句柄已失效，条目直接回收，新任务自己重新注册
+
+5. 与看门狗.c相比：
+   - 不再受MAX_WATCHDOG_TASK=10限制，条目池大小可配置
+   - 检查不再固定100ms扫一遍全部任务
+*/
@@ -0,0 +1,616 @@
+/*
+ * Demo: 固定块消息内存池
+ * 学习要点：
+ * 1. 多个尺寸等级（32/64/128字节）的固定块内存池
+ * 2. 基于空闲链表的O(1)分配和释放
+ * 3. 带版本号的无锁空闲链表 - 中断中也能分配/释放，不需要长临界段
+ * 4. 每个内存池的高水位和耗尽统计
+ * 5. 作为demo7队列载荷的后备存储：队列里只传指针，不再拷贝整个结构体
+ * 6. 与pvPortMalloc()的分配/释放延迟对比
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 内存池配置 ====================
+#define POOL_CLASS_NUM      3       //尺寸等级数量
+#define POOL_INVALID_INDEX  0xFFFF  //空闲链表结束标志
+
+//每个尺寸等级的块大小和块数量
+#define POOL_SMALL_SIZE     32
+#define POOL_SMALL_COUNT    32
+#define POOL_MEDIUM_SIZE    64
+#define POOL_MEDIUM_COUNT   16
+#define POOL_LARGE_SIZE     128
+#define POOL_LARGE_COUNT    8
+
+/*
+ * 空闲链表头：低16位是块索引，高16位是版本号
+ * 每次修改链表头都让版本号+1，这样CAS（比较并交换）可以发现
+ * "A被取走→B被取走→A被还回"这种ABA情况，避免把已经分配出去的块又挂回链表
+ */
+#define POOL_HEAD_INDEX(head)       ((uint16_t)((head) & 0xFFFF))
+#define POOL_HEAD_TAG(head)         ((uint16_t)((head) >> 16))
+#define POOL_MAKE_HEAD(tag,index)   (((uint32_t)(tag) << 16) | (uint32_t)(index))
+
+//内存池控制块
+typedef struct{
+    const char *name;           //内存池名字
+    uint8_t *memory;            //块存储区起始地址
+    uint16_t *next;             //空闲链表：next[i]是块i之后的空闲块
+    uint16_t block_size;        //块大小（字节）
+    uint16_t block_count;       //块数量
+    volatile uint32_t free_head;    //空闲链表头（版本号+索引）
+
+    //统计信息
+    volatile uint32_t in_use;       //当前已分配块数
+    volatile uint32_t high_water;   //历史最大已分配块数（高水位）
+    volatile uint32_t alloc_count;  //分配成功次数
+    volatile uint32_t free_count;   //释放次数
+    volatile uint32_t exhausted;    //池耗尽（分配失败）次数
+}MemPool_t;
+
+//内存池统计快照（给监控任务打印用）
+typedef struct{
+    uint16_t block_size;
+    uint16_t block_count;
+    uint32_t in_use;
+    uint32_t high_water;
+    uint32_t alloc_count;
+    uint32_t free_count;
+    uint32_t exhausted;
+}MemPoolStats_t;
+
+
+// ==================== 内存池存储区 ====================
+// 块存储区按8字节对齐，任何结构体都可以直接放进去
+static uint8_t pool_small_memory[POOL_SMALL_COUNT*POOL_SMALL_SIZE] __attribute__((aligned(8)));
+static uint8_t pool_medium_memory[POOL_MEDIUM_COUNT*POOL_MEDIUM_SIZE] __attribute__((aligned(8)));
+static uint8_t pool_large_memory[POOL_LARGE_COUNT*POOL_LARGE_SIZE] __attribute__((aligned(8)));
+
+static uint16_t pool_small_next[POOL_SMALL_COUNT];
+static uint16_t pool_medium_next[POOL_MEDIUM_COUNT];
+static uint16_t pool_large_next[POOL_LARGE_COUNT];
+
+//按块大小从小到大排列，分配时取第一个放得下的等级
+static MemPool_t mem_pools[POOL_CLASS_NUM]={
+    {.name="Small",  .memory=pool_small_memory,  .next=pool_small_next,  .block_size=POOL_SMALL_SIZE,  .block_count=POOL_SMALL_COUNT},
+    {.name="Medium", .memory=pool_medium_memory, .next=pool_medium_next, .block_size=POOL_MEDIUM_SIZE, .block_count=POOL_MEDIUM_COUNT},
+    {.name="Large",  .memory=pool_large_memory,  .next=pool_large_next,  .block_size=POOL_LARGE_SIZE,  .block_count=POOL_LARGE_COUNT},
+};
+
+
+// ==================== 原子操作 ====================
+/*
+ * Cortex-M3/M4/M7和主机平台：用LDREX/STREX（GCC的__atomic内建函数）实现无锁CAS
+ * Cortex-M0(ARMv6-M)没有独占访问指令，退化为屏蔽中断的短临界段（只有几条指令）
+ */
+#if defined(__ARM_ARCH_6M__)
+static BaseType_t pool_cas(volatile uint32_t *ptr, uint32_t expected, uint32_t desired){
+    BaseType_t ok=pdFALSE;
+    UBaseType_t saved=portSET_INTERRUPT_MASK_FROM_ISR();
+    if(*ptr==expected){
+        *ptr=desired;
+        ok=pdTRUE;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+    return ok;
+}
+
+static uint32_t pool_atomic_add(volatile uint32_t *ptr, int32_t delta){
+    UBaseType_t saved=portSET_INTERRUPT_MASK_FROM_ISR();
+    uint32_t value=*ptr+delta;
+    *ptr=value;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+    return value;
+}
+#else
+static BaseType_t pool_cas(volatile uint32_t *ptr, uint32_t expected, uint32_t desired){
+    return __atomic_compare_exchange_n(ptr,&expected,desired,pdFALSE,
+                                       __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)?pdTRUE:pdFALSE;
+}
+
+static uint32_t pool_atomic_add(volatile uint32_t *ptr, int32_t delta){
+    return __atomic_add_fetch(ptr,delta,__ATOMIC_RELAXED);
+}
+#endif
+
+
+// ==================== 内存池API ====================
+/**
+ * 初始化所有内存池
+ * 功能：把每个池的所有块串成空闲链表，清零统计信息
+ * 必须在启动调度器之前调用
+ */
+void MemPool_Init(void){
+    for(uint32_t c=0;c<POOL_CLASS_NUM;c++){
+        MemPool_t *pool=&mem_pools[c];
+
+        for(uint16_t i=0;i<pool->block_count;i++){
+            pool->next[i]=(i+1<pool->block_count)?(uint16_t)(i+1):POOL_INVALID_INDEX;
+        }
+        pool->free_head=POOL_MAKE_HEAD(0,0);
+
+        pool->in_use=0;
+        pool->high_water=0;
+        pool->alloc_count=0;
+        pool->free_count=0;
+        pool->exhausted=0;
+    }
+}
+
+
+/**
+ * 从指定内存池取一个块
+ * 功能：无锁弹出空闲链表头，O(1)
+ * 返回：块地址，池耗尽返回NULL
+ * 说明：in_use在块离开空闲链表之前加1、回到空闲链表之后减1（见pool_push），
+ *       块在链表外的整段时间都被计数，并发释放不会把in_use减成负数
+ */
+static void* pool_pop(MemPool_t *pool){
+    uint32_t head,new_head;
+    uint16_t index;
+    uint32_t in_use=pool_atomic_add(&pool->in_use,1);
+
+    do{
+        head=pool->free_head;
+        index=POOL_HEAD_INDEX(head);
+        if(index==POOL_INVALID_INDEX){
+            pool_atomic_add(&pool->in_use,-1);
+            pool_atomic_add(&pool->exhausted,1);
+            return NULL;
+        }
+        //next[index]可能被并发修改，但那时版本号已经变了，CAS一定失败后重试
+        new_head=POOL_MAKE_HEAD(POOL_HEAD_TAG(head)+1,pool->next[index]);
+    }while(pool_cas(&pool->free_head,head,new_head)==pdFALSE);
+
+    //更新高水位；并发的失败分配会让in_use暂时多算，按块数封顶
+    if(in_use>pool->block_count){
+        in_use=pool->block_count;
+    }
+    uint32_t high=pool->high_water;
+    while(in_use>high){
+        if(pool_cas(&pool->high_water,high,in_use)==pdTRUE){
+            break;
+        }
+        high=pool->high_water;
+    }
+    pool_atomic_add(&pool->alloc_count,1);
+
+    return pool->memory+(uint32_t)index*pool->block_size;
+}
+
+
+/**
+ * 把一个块还回指定内存池
+ * 功能：无锁压入空闲链表头，O(1)
+ */
+static void pool_push(MemPool_t *pool, uint16_t index){
+    uint32_t head,new_head;
+
+    do{
+        head=pool->free_head;
+        pool->next[index]=POOL_HEAD_INDEX(head);
+        new_head=POOL_MAKE_HEAD(POOL_HEAD_TAG(head)+1,index);
+    }while(pool_cas(&pool->free_head,head,new_head)==pdFALSE);
+
+    //块已经回到空闲链表才减，与pool_pop的顺序对应
+    pool_atomic_add(&pool->in_use,-1);
+    pool_atomic_add(&pool->free_count,1);
+}
+
+
+/**
+ * 按大小分配一个固定块
+ * 功能：选出第一个放得下size的尺寸等级并分配
+ *       该等级耗尽时不会借用更大的等级，保证行为确定
+ * 参数：size - 需要的字节数
+ * 返回：块地址，失败返回NULL
+ * 说明：任务和中断中都可以调用
+ */
+void* MemPool_Alloc(size_t size){
+    for(uint32_t c=0;c<POOL_CLASS_NUM;c++){
+        if(size<=mem_pools[c].block_size){
+            return pool_pop(&mem_pools[c]);
+        }
+    }
+    return NULL;    //超过最大块大小
+}
+
+
+/**
+ * 中断版本的分配函数
+ * 空闲链表本身是无锁的，和任务版本是同一个实现，单独命名是为了和FreeRTOS的FromISR习惯一致
+ */
+void* MemPool_AllocFromISR(size_t size){
+    return MemPool_Alloc(size);
+}
+
+
+/**
+ * 释放一个固定块
+ * 功能：根据地址范围找到所属内存池（等级数固定，O(1)），压回空闲链表
+ * 参数：block - MemPool_Alloc()返回的地址
+ * 说明：任务和中断中都可以调用
+ */
+void MemPool_Free(void *block){
+    uint8_t *ptr=(uint8_t*)block;
+
+    if(ptr==NULL){
+        return;
+    }
+
+    for(uint32_t c=0;c<POOL_CLASS_NUM;c++){
+        MemPool_t *pool=&mem_pools[c];
+        uint8_t *end=pool->memory+(uint32_t)pool->block_count*pool->block_size;
+
+        if(ptr>=pool->memory&&ptr<end){
+            uint32_t offset=(uint32_t)(ptr-pool->memory);
+            configASSERT(offset%pool->block_size==0);   //必须是块起始地址
+            pool_push(pool,(uint16_t)(offset/pool->block_size));
+            return;
+        }
+    }
+
+    configASSERT(0);    //不是内存池里的地址
+}
+
+
+void MemPool_FreeFromISR(void *block){
+    MemPool_Free(block);
+}
+
+
+/**
+ * 获取某个尺寸等级的统计快照
+ * 参数：class_index - 等级索引（0~POOL_CLASS_NUM-1）
+ *       stats - 输出的统计信息
+ */
+void MemPool_GetStats(uint32_t class_index, MemPoolStats_t *stats){
+    MemPool_t *pool=&mem_pools[class_index];
+
+    stats->block_size=pool->block_size;
+    stats->block_count=pool->block_count;
+    stats->in_use=pool->in_use;
+    stats->high_water=pool->high_water;
+    stats->alloc_count=pool->alloc_count;
+    stats->free_count=pool->free_count;
+    stats->exhausted=pool->exhausted;
+}
+
+
+// ==================== demo7的数据结构 ====================
+typedef struct{
+    uint32_t id;
+    float value;
+    char unit[10];
+    uint32_t timestamp;
+}sensor_data_t;
+
+typedef struct{
+    char text[50];
+    uint8_t priority;
+    uint32_t sender_id;
+}message_t;
+
+typedef struct{
+    uint8_t cmd_type;
+    uint32_t param1;
+    uint32_t param2;
+    char description[30];
+}command_t;
+
+#define CMD_LED_ON  1
+#define CMD_LED_OFF 2
+#define CMD_RESET   3
+#define CMD_STATUS  4
+
+//队列句柄：队列元素是指向内存池块的指针，而不是整个结构体
+QueueHandle_t message_queue;
+QueueHandle_t sensor_queue;
+QueueHandle_t command_queue;
+
+
+// ==================== 使用内存池的队列示例 ====================
+// 传感器任务：从内存池取块，填数据，只把指针发进队列
+void sensor_task(void *pvParameters){
+    static uint32_t sensor_id=1;
+
+    for(;;){
+        sensor_data_t *sensor_data=MemPool_Alloc(sizeof(sensor_data_t));
+
+        if(sensor_data!=NULL){
+            sensor_data->id=sensor_id;
+            sensor_data->value=20.0f+(rand()%100)/10.0f;
+            strcpy(sensor_data->unit,"°C");
+            sensor_data->timestamp=xTaskGetTickCount();
+
+            //发送失败时块的所有权还在发送方，必须自己释放
+            if(xQueueSend(sensor_queue,&sensor_data,pdMS_TO_TICKS(1000))!=pdPASS){
+                printf("[传感器%lu] 数据发送失败，队列满!\n", sensor_id);
+                MemPool_Free(sensor_data);
+            }
+        }else{
+            printf("[传感器%lu] 内存池耗尽，丢弃本次采样\n", sensor_id);
+        }
+
+        sensor_id=(sensor_id%3)+1;
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
+
+// 显示任务：收到指针后使用数据，用完归还内存池
+void display_task(void *pvParameters){
+    sensor_data_t *sensor_data;
+    message_t *message;
+
+    for(;;){
+        if(xQueueReceive(sensor_queue,&sensor_data,0)==pdPASS){
+            printf("[显示器] 传感器数据 - ID:%lu, 值:%.1f%s, 时间:%lu\n",
+                sensor_data->id, sensor_data->value,
+                sensor_data->unit, sensor_data->timestamp);
+            MemPool_Free(sensor_data);
+        }
+
+        if(xQueueReceive(message_queue,&message,0)==pdPASS){
+            printf("[显示器] 消息 - 优先级:%d, 发送者:%lu, 内容:%s\n",
+                   message->priority, message->sender_id, message->text);
+            MemPool_Free(message);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
+
+// 命令处理任务
+void command_processor_task(void *pvParameters){
+    command_t *cmd;
+
+    for(;;){
+        if(xQueueReceive(command_queue,&cmd,portMAX_DELAY)==pdPASS){
+            printf("[命令处理器] 收到命令: %s\n", cmd->description);
+
+            if(cmd->cmd_type==CMD_STATUS){
+                message_t *status_msg=MemPool_Alloc(sizeof(message_t));
+                if(status_msg!=NULL){
+                    status_msg->priority=1;
+                    status_msg->sender_id=99;
+                    strcpy(status_msg->text,"系统运行正常");
+                    if(xQueueSend(message_queue,&status_msg,0)!=pdPASS){
+                        MemPool_Free(status_msg);
+                    }
+                }
+            }
+
+            MemPool_Free(cmd);
+            vTaskDelay(pdMS_TO_TICKS(500));
+        }
+    }
+}
+
+
+// 命令发送任务
+void command_sender_task(void *pvParameters){
+    static uint8_t cmd_sequence=0;
+
+    for(;;){
+        command_t *cmd=MemPool_Alloc(sizeof(command_t));
+
+        if(cmd!=NULL){
+            cmd_sequence++;
+            cmd->cmd_type=(cmd_sequence%4)+1;
+            cmd->param1=1;
+            cmd->param2=0;
+            snprintf(cmd->description,sizeof(cmd->description),"命令%d",cmd->cmd_type);
+
+            if(xQueueSend(command_queue,&cmd,pdMS_TO_TICKS(1000))!=pdPASS){
+                printf("[命令发送器] 命令发送失败!\n");
+                MemPool_Free(cmd);
+            }
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(4000));
+    }
+}
+
+
+// 模拟中断服务程序 - 在中断里从内存池分配紧急消息
+void simulate_interrupt_send_message(void){
+    BaseType_t higher_priority_task_woken=pdFALSE;
+    message_t *urgent_msg=MemPool_AllocFromISR(sizeof(message_t));
+
+    if(urgent_msg==NULL){
+        return;     //池耗尽：中断里不能等待，直接丢弃
+    }
+
+    urgent_msg->priority=0;
+    urgent_msg->sender_id=0;
+    strcpy(urgent_msg->text,"紧急中断消息!");
+
+    if(xQueueSendFromISR(message_queue,&urgent_msg,&higher_priority_task_woken)!=pdPASS){
+        MemPool_FreeFromISR(urgent_msg);
+    }
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+
+// 内存池监控任务
+void pool_monitor_task(void *pvParameters){
+    MemPoolStats_t stats;
+
+    for(;;){
+        printf("\n=== 内存池状态监控 ===\n");
+        for(uint32_t c=0;c<POOL_CLASS_NUM;c++){
+            MemPool_GetStats(c,&stats);
+            printf("%-6s %3u字节: 使用%lu/%u 高水位%lu 分配%lu 释放%lu 耗尽%lu\n",
+                   mem_pools[c].name, stats.block_size,
+                   stats.in_use, stats.block_count, stats.high_water,
+                   stats.alloc_count, stats.free_count, stats.exhausted);
+        }
+        printf("======================\n\n");
+
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
+
+// ==================== 性能对比 ====================
+#define BENCH_ROUNDS    1000    //测试轮数
+#define BENCH_BATCH     8       //每轮连续分配的块数
+
+//延迟统计
+typedef struct{
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t samples;
+}LatencyStats_t;
+
+static void latency_reset(LatencyStats_t *s){
+    s->min=0xFFFFFFFF;
+    s->max=0;
+    s->total=0;
+    s->samples=0;
+}
+
+static void latency_add(LatencyStats_t *s, uint32_t value){
+    if(value<s->min) s->min=value;
+    if(value>s->max) s->max=value;
+    s->total+=value;
+    s->samples++;
+}
+
+static void latency_print(const char *name, const LatencyStats_t *s){
+    printf("  %-22s 最小:%5lu 平均:%5lu 最大:%6lu %s\n",
+           name, s->min, (uint32_t)(s->total/(s->samples?s->samples:1)), s->max, CYCLE_UNIT);
+}
+
+
+/**
+ * 分配/释放延迟测试任务
+ * 功能：同样的分配模式分别跑内存池和pvPortMalloc，对比最小/平均/最大延迟
+ * 说明：通用堆的延迟和当时的碎片状态有关，最大值才是实时系统关心的
+ */
+void pool_benchmark_task(void *pvParameters){
+    static const size_t sizes[BENCH_BATCH]={24,56,44,120,16,60,32,100};
+    void *blocks[BENCH_BATCH];
+    LatencyStats_t pool_alloc,pool_free,heap_alloc,heap_free;
+    uint32_t start;
+
+    vTaskDelay(pdMS_TO_TICKS(1000));    //等其他任务进入稳定状态
+    cycle_counter_init();
+
+    latency_reset(&pool_alloc);
+    latency_reset(&pool_free);
+    latency_reset(&heap_alloc);
+    latency_reset(&heap_free);
+
+    for(uint32_t round=0;round<BENCH_ROUNDS;round++){
+        //内存池
+        for(uint32_t i=0;i<BENCH_BATCH;i++){
+            start=cycle_counter_get();
+            blocks[i]=MemPool_Alloc(sizes[i]);
+            latency_add(&pool_alloc,cycle_counter_get()-start);
+        }
+        for(uint32_t i=0;i<BENCH_BATCH;i++){
+            //交错释放顺序，打乱空闲链表
+            uint32_t k=(i*3)%BENCH_BATCH;
+            start=cycle_counter_get();
+            MemPool_Free(blocks[k]);
+            latency_add(&pool_free,cycle_counter_get()-start);
+        }
+
+        //通用堆
+        for(uint32_t i=0;i<BENCH_BATCH;i++){
+            start=cycle_counter_get();
+            blocks[i]=pvPortMalloc(sizes[i]);
+            latency_add(&heap_alloc,cycle_counter_get()-start);
+        }
+        for(uint32_t i=0;i<BENCH_BATCH;i++){
+            uint32_t k=(i*3)%BENCH_BATCH;
+            start=cycle_counter_get();
+            vPortFree(blocks[k]);
+            latency_add(&heap_free,cycle_counter_get()-start);
+        }
+
+        //每轮让出一次CPU，避免饿死其他任务
+        taskYIELD();
+    }
+
+    printf("\n[性能测试] 分配/释放延迟对比（%d轮 x %d块）\n", BENCH_ROUNDS, BENCH_BATCH);
+    latency_print("MemPool_Alloc",&pool_alloc);
+    latency_print("MemPool_Free",&pool_free);
+    latency_print("pvPortMalloc",&heap_alloc);
+    latency_print("vPortFree",&heap_free);
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 固定块消息内存池\n");
+
+    MemPool_Init();
+
+    //队列只存放指针：sizeof(void*)，比拷贝结构体省内存也省时间
+    message_queue=xQueueCreate(10,sizeof(message_t*));
+    sensor_queue=xQueueCreate(8,sizeof(sensor_data_t*));
+    command_queue=xQueueCreate(5,sizeof(command_t*));
+    if(message_queue==NULL||sensor_queue==NULL||command_queue==NULL){
+        printf("队列创建失败!\n");
+        return -1;
+    }
+
+    xTaskCreate(sensor_task, "Sensor", 256, NULL, 3, NULL);
+    xTaskCreate(display_task, "Display", 512, NULL, 3, NULL);
+    xTaskCreate(command_processor_task, "CmdProc", 512, NULL, 4, NULL);
+    xTaskCreate(command_sender_task, "CmdSender", 256, NULL, 1, NULL);
+    xTaskCreate(pool_monitor_task, "PoolMon", 512, NULL, 1, NULL);
+    xTaskCreate(pool_benchmark_task, "PoolBench", 512, NULL, 2, NULL);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败!\n");
+    return -1;
+}
+
+void vApplicationMallocFailedHook(void) {
+    printf("内存分配失败!\n");
+    for(;;);
+}
+
+/*
+学习要点总结：
+
+1. 为什么需要固定块内存池：
+   - pvPortMalloc()的耗时和堆碎片有关，最坏情况不确定
+   - 大多数heap实现不能在中断中调用
+   - 消息和数据帧大小固定，很适合按尺寸等级预先切好
+
+2. 空闲链表：
+   - 每个等级一条单向链表，分配=弹出表头，释放=压入表头，都是O(1)
+   - next[]数组放在块外面，块被分配后用户可以随意写，不会破坏链表
+
+3. 无锁与ABA问题：
+   - 表头用CAS更新，中断打断任务也不会出错，不需要关中断
+   - 表头带版本号，每次修改+1，防止ABA问题
+   - Cortex-M0没有LDREX/STREX，只能退化为几条指令的短临界段
+
+4. 统计信息：
+   - 高水位：历史上同时被占用的最大块数，用来调整每个等级的块数
+   - 耗尽次数：分配失败的次数，非零说明该等级块数不够
+
+5. 与队列配合：
+   - 队列只传指针，大结构体不再被拷贝两次
+   - 谁持有指针谁负责释放：发送失败时由发送方释放，接收成功后由接收方释放
+*/
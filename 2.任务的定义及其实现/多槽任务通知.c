@@ -0,0 +1,450 @@
+/*
+ * Demo: 多槽任务通知与32位邮箱
+ * 学习要点：
+ * 1. 每个任务有一组通知槽（configTASK_NOTIFICATION_ARRAY_ENTRIES），按索引收发
+ * 2. 不同的槽可以同时承担不同角色：计数信号量、事件位、32位邮箱
+ * 3. 等待任意槽（wait-any）：槽0作为"待处理槽位图"，一次阻塞等待多个槽
+ * 4. 邮箱模式：不覆盖写入，邮箱满时发送失败，不需要创建队列就能传一个32位值
+ * 5. 与二进制信号量、计数信号量对比give/take延迟
+ *
+ * 需要FreeRTOS V10.4.0以上，并在FreeRTOSConfig.h中设置：
+ *   #define configTASK_NOTIFICATION_ARRAY_ENTRIES 4
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdio.h>
+#include "../cycle_counter.h"
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES < 4)
+    #error "本demo需要 configTASK_NOTIFICATION_ARRAY_ENTRIES >= 4"
+#endif
+
+
+// ==================== 多槽通知 ====================
+/*
+ * 槽0保留给"待处理槽位图"：往槽n发送后再在槽0置位bit n
+ * 等待任意槽时只阻塞在槽0上；等待单个槽时直接阻塞在该槽上
+ * 先写槽n再置位图，保证等待者被位图唤醒时槽n里一定已经有通知
+ */
+#define NOTIFY_INDEX_PENDING    0
+#define NOTIFY_SLOT_FIRST       1
+#define NOTIFY_SLOT_COUNT       configTASK_NOTIFICATION_ARRAY_ENTRIES
+#define NOTIFY_SLOT_MASK(slot)  (1UL<<(slot))
+
+
+//向某个槽发送通知，并在槽0登记
+static BaseType_t notify_slot(TaskHandle_t task, UBaseType_t slot, uint32_t value, eNotifyAction action){
+    configASSERT(slot>=NOTIFY_SLOT_FIRST&&slot<NOTIFY_SLOT_COUNT);
+
+    if(xTaskNotifyIndexed(task,slot,value,action)!=pdPASS){
+        return pdFAIL;      //只有eSetValueWithoutOverwrite会失败（邮箱满）
+    }
+    xTaskNotifyIndexed(task,NOTIFY_INDEX_PENDING,NOTIFY_SLOT_MASK(slot),eSetBits);
+    return pdPASS;
+}
+
+static BaseType_t notify_slot_from_isr(TaskHandle_t task, UBaseType_t slot, uint32_t value,
+                                       eNotifyAction action, BaseType_t *pxHigherPriorityTaskWoken){
+    configASSERT(slot>=NOTIFY_SLOT_FIRST&&slot<NOTIFY_SLOT_COUNT);
+
+    if(xTaskNotifyIndexedFromISR(task,slot,value,action,pxHigherPriorityTaskWoken)!=pdPASS){
+        return pdFAIL;
+    }
+    xTaskNotifyIndexedFromISR(task,NOTIFY_INDEX_PENDING,NOTIFY_SLOT_MASK(slot),eSetBits,pxHigherPriorityTaskWoken);
+    return pdPASS;
+}
+
+/*
+ * 取槽之前先清掉槽0中对应的位，取完如果槽里还有剩余再把位补上
+ * 顺序不能反：如果先取后清，发送方恰好在两步之间发送，它置的位会被清掉，wait-any就丢了这次唤醒
+ * 先清后取最多留下一个过期的位，wait-any醒来后非阻塞取值为空即可
+ */
+static inline void notify_slot_clear_pending(UBaseType_t slot){
+    ulTaskNotifyValueClearIndexed(NULL,NOTIFY_INDEX_PENDING,NOTIFY_SLOT_MASK(slot));
+}
+
+static inline void notify_slot_mark_pending(UBaseType_t slot){
+    xTaskNotifyIndexed(xTaskGetCurrentTaskHandle(),NOTIFY_INDEX_PENDING,NOTIFY_SLOT_MASK(slot),eSetBits);
+}
+
+
+/**
+ * 计数模式发送（相当于xSemaphoreGive）
+ */
+BaseType_t NotifySlot_Give(TaskHandle_t task, UBaseType_t slot){
+    return notify_slot(task,slot,0,eIncrement);
+}
+
+BaseType_t NotifySlot_GiveFromISR(TaskHandle_t task, UBaseType_t slot, BaseType_t *pxHigherPriorityTaskWoken){
+    return notify_slot_from_isr(task,slot,0,eIncrement,pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 计数模式接收（相当于xSemaphoreTake）
+ * 参数：clear - pdTRUE清零（二进制信号量语义），pdFALSE减一（计数信号量语义）
+ * 返回：接收前的计数值，超时返回0
+ */
+uint32_t NotifySlot_Take(UBaseType_t slot, BaseType_t clear, TickType_t timeout){
+    uint32_t count;
+
+    notify_slot_clear_pending(slot);
+    count=ulTaskNotifyTakeIndexed(slot,clear,timeout);
+
+    //计数模式只减了一，还有剩余就重新登记，wait-any下次还能看到
+    if(clear==pdFALSE&&count>1){
+        notify_slot_mark_pending(slot);
+    }
+    return count;
+}
+
+
+/**
+ * 事件位模式发送（相当于xEventGroupSetBits，但只有一个接收任务）
+ */
+BaseType_t NotifySlot_SetBits(TaskHandle_t task, UBaseType_t slot, uint32_t bits){
+    return notify_slot(task,slot,bits,eSetBits);
+}
+
+/**
+ * 事件位模式接收：返回并清除所有已置位的事件
+ */
+uint32_t NotifySlot_WaitBits(UBaseType_t slot, TickType_t timeout){
+    uint32_t bits=0;
+
+    notify_slot_clear_pending(slot);
+    if(xTaskNotifyWaitIndexed(slot,0,0xFFFFFFFF,&bits,timeout)!=pdTRUE){
+        return 0;
+    }
+    return bits;
+}
+
+
+/**
+ * 邮箱发送
+ * 功能：把一个32位值放进接收任务的邮箱槽
+ * 参数：overwrite - pdTRUE覆盖旧值（最新值语义）；pdFALSE邮箱满则失败（不丢数据语义）
+ * 返回：pdPASS成功，pdFAIL邮箱里还有没取走的值
+ */
+BaseType_t Mailbox_Post(TaskHandle_t task, UBaseType_t slot, uint32_t value, BaseType_t overwrite){
+    return notify_slot(task,slot,value,overwrite?eSetValueWithOverwrite:eSetValueWithoutOverwrite);
+}
+
+BaseType_t Mailbox_PostFromISR(TaskHandle_t task, UBaseType_t slot, uint32_t value, BaseType_t overwrite,
+                               BaseType_t *pxHigherPriorityTaskWoken){
+    return notify_slot_from_isr(task,slot,value,
+                                overwrite?eSetValueWithOverwrite:eSetValueWithoutOverwrite,
+                                pxHigherPriorityTaskWoken);
+}
+
+/**
+ * 邮箱接收
+ * 返回：pdTRUE取到值（邮箱变空，发送方可以再次投递）；超时返回pdFALSE
+ */
+BaseType_t Mailbox_Fetch(UBaseType_t slot, uint32_t *value, TickType_t timeout){
+    notify_slot_clear_pending(slot);
+    return xTaskNotifyWaitIndexed(slot,0,0,value,timeout);
+}
+
+
+/**
+ * 等待任意槽
+ * 功能：阻塞在槽0上，任意一个slot_mask中的槽收到通知就返回
+ * 参数：slot_mask - 关心的槽（NOTIFY_SLOT_MASK(n)的组合）
+ * 返回：有通知的槽位图，超时返回0
+ * 说明：返回后对每个置位的槽用timeout=0调用Take/WaitBits/Fetch取值；
+ *       位图偶尔会过期（该槽已被单槽等待取走），这时非阻塞接收会直接返回空
+ */
+uint32_t NotifySlot_WaitAny(uint32_t slot_mask, TickType_t timeout){
+    uint32_t pending=0;
+
+    //先看一下是否已经有待处理的槽，避免无谓的阻塞
+    xTaskNotifyWaitIndexed(NOTIFY_INDEX_PENDING,0,slot_mask,&pending,0);
+    pending&=slot_mask;
+    if(pending!=0){
+        return pending;
+    }
+
+    if(xTaskNotifyWaitIndexed(NOTIFY_INDEX_PENDING,0,slot_mask,&pending,timeout)!=pdTRUE){
+        return 0;
+    }
+    return pending&slot_mask;
+}
+
+
+// ==================== 组合使用示例 ====================
+/*
+ * demo9中 data_processor_task、counter_task、event_handler_task 是三个独立任务，
+ * 因为每个任务只有一个通知值。有了多个槽，一个任务就能同时承担三种角色
+ */
+#define SLOT_COUNTER    1   //计数信号量：待处理项目数
+#define SLOT_MAILBOX    2   //邮箱：最新的数据值
+#define SLOT_EVENTS     3   //事件位
+
+// 事件位定义（与demo9一致）
+#define EVENT_DATA_READY    (1 << 0)
+#define EVENT_ERROR_OCCUR   (1 << 1)
+#define EVENT_TIMEOUT       (1 << 2)
+#define EVENT_USER_INPUT    (1 << 3)
+
+TaskHandle_t combined_handler_handle;
+volatile uint32_t mailbox_rejected=0;   //邮箱满被拒绝的次数
+
+
+// 组合处理任务：一次等待三个槽
+void combined_handler_task(void *pvParameters){
+    const uint32_t slots=NOTIFY_SLOT_MASK(SLOT_COUNTER)|NOTIFY_SLOT_MASK(SLOT_MAILBOX)|NOTIFY_SLOT_MASK(SLOT_EVENTS);
+
+    for(;;){
+        uint32_t pending=NotifySlot_WaitAny(slots,pdMS_TO_TICKS(5000));
+
+        if(pending==0){
+            printf("[组合处理] 5秒内没有任何通知\n");
+            continue;
+        }
+
+        if(pending&NOTIFY_SLOT_MASK(SLOT_MAILBOX)){
+            uint32_t data;
+            if(Mailbox_Fetch(SLOT_MAILBOX,&data,0)==pdTRUE){
+                printf("[组合处理] 邮箱数据: %lu -> 处理后: %lu\n", data, data*2);
+            }
+        }
+
+        if(pending&NOTIFY_SLOT_MASK(SLOT_COUNTER)){
+            //计数信号量语义：一次处理一个项目，剩余的下次还会被看到
+            uint32_t count=NotifySlot_Take(SLOT_COUNTER,pdFALSE,0);
+            if(count>0){
+                printf("[组合处理] 处理一个项目，剩余: %lu\n", count-1);
+            }
+        }
+
+        if(pending&NOTIFY_SLOT_MASK(SLOT_EVENTS)){
+            uint32_t events=NotifySlot_WaitBits(SLOT_EVENTS,0);
+            if(events&EVENT_DATA_READY)  printf("[组合处理] - 数据就绪事件\n");
+            if(events&EVENT_ERROR_OCCUR) printf("[组合处理] - 错误事件\n");
+            if(events&EVENT_TIMEOUT)     printf("[组合处理] - 超时事件\n");
+            if(events&EVENT_USER_INPUT)  printf("[组合处理] - 用户输入事件\n");
+        }
+    }
+}
+
+// 数据发送任务：邮箱不覆盖模式，处理不过来就报告拒绝
+void data_sender_task(void *pvParameters){
+    uint32_t data_to_send=100;
+
+    for(;;){
+        if(Mailbox_Post(combined_handler_handle,SLOT_MAILBOX,data_to_send,pdFALSE)!=pdPASS){
+            mailbox_rejected++;
+            printf("[数据发送器] 邮箱还没取走，数据 %lu 被拒绝\n", data_to_send);
+        }
+        data_to_send+=10;
+        vTaskDelay(pdMS_TO_TICKS(700));
+    }
+}
+
+// 计数增加任务
+void counter_incrementer_task(void *pvParameters){
+    static uint32_t increment_round=0;
+
+    for(;;){
+        increment_round++;
+        for(uint32_t i=0;i<(increment_round%3)+1;i++){
+            NotifySlot_Give(combined_handler_handle,SLOT_COUNTER);
+        }
+        vTaskDelay(pdMS_TO_TICKS(2500));
+    }
+}
+
+// 事件生成任务
+void event_generator_task(void *pvParameters){
+    static const uint32_t events[]={
+        EVENT_DATA_READY,
+        EVENT_ERROR_OCCUR|EVENT_TIMEOUT,
+        EVENT_USER_INPUT,
+        EVENT_DATA_READY|EVENT_USER_INPUT,
+    };
+    uint32_t cycle=0;
+
+    for(;;){
+        NotifySlot_SetBits(combined_handler_handle,SLOT_EVENTS,events[cycle++%4]);
+        vTaskDelay(pdMS_TO_TICKS(3000));
+    }
+}
+
+// 模拟中断：用邮箱覆盖模式传递最新ADC值
+void simulate_adc_interrupt(uint32_t adc_value){
+    BaseType_t higher_priority_task_woken=pdFALSE;
+
+    Mailbox_PostFromISR(combined_handler_handle,SLOT_MAILBOX,adc_value,pdTRUE,&higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+void interrupt_simulator_task(void *pvParameters){
+    uint32_t adc=2048;
+
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(4000));
+        simulate_adc_interrupt(adc++);
+    }
+}
+
+
+// ==================== 性能对比 ====================
+#define BENCH_ITERATIONS    1000
+
+//同步机制种类
+typedef enum{
+    BENCH_BINARY_SEM,       //二进制信号量（demo6）
+    BENCH_COUNTING_SEM,     //计数信号量（demo6）
+    BENCH_NOTIFY_INDEXED,   //原生单槽通知：xTaskNotifyGiveIndexed
+    BENCH_NOTIFY_SLOT,      //多槽通知（带槽0登记，支持wait-any）
+    BENCH_MAILBOX,          //32位邮箱
+    BENCH_KIND_COUNT
+}BenchKind_t;
+
+static const char *bench_names[BENCH_KIND_COUNT]={
+    "二进制信号量","计数信号量","原生索引通知","多槽通知","32位邮箱"
+};
+
+#define BENCH_SLOT  1
+
+static SemaphoreHandle_t bench_binary;
+static SemaphoreHandle_t bench_counting;
+static SemaphoreHandle_t bench_pong_binary;
+static SemaphoreHandle_t bench_pong_counting;
+static TaskHandle_t bench_ping_handle;
+static TaskHandle_t bench_pong_handle;
+
+//发送一次
+static void bench_give(BenchKind_t kind, TaskHandle_t target, SemaphoreHandle_t binary, SemaphoreHandle_t counting){
+    switch(kind){
+        case BENCH_BINARY_SEM:      xSemaphoreGive(binary); break;
+        case BENCH_COUNTING_SEM:    xSemaphoreGive(counting); break;
+        case BENCH_NOTIFY_INDEXED:  xTaskNotifyGiveIndexed(target,BENCH_SLOT); break;
+        case BENCH_NOTIFY_SLOT:     NotifySlot_Give(target,BENCH_SLOT); break;
+        case BENCH_MAILBOX:         Mailbox_Post(target,BENCH_SLOT,0x1234,pdTRUE); break;
+        default: break;
+    }
+}
+
+//接收一次
+static void bench_take(BenchKind_t kind, SemaphoreHandle_t binary, SemaphoreHandle_t counting, TickType_t timeout){
+    uint32_t value;
+
+    switch(kind){
+        case BENCH_BINARY_SEM:      xSemaphoreTake(binary,timeout); break;
+        case BENCH_COUNTING_SEM:    xSemaphoreTake(counting,timeout); break;
+        case BENCH_NOTIFY_INDEXED:  ulTaskNotifyTakeIndexed(BENCH_SLOT,pdTRUE,timeout); break;
+        case BENCH_NOTIFY_SLOT:     NotifySlot_Take(BENCH_SLOT,pdTRUE,timeout); break;
+        case BENCH_MAILBOX:         Mailbox_Fetch(BENCH_SLOT,&value,timeout); break;
+        default: break;
+    }
+}
+
+// 乒乓对端任务：收到一次就回一次；每种同步方式单独创建一次
+void bench_pong_task(void *pvParameters){
+    BenchKind_t kind=(BenchKind_t)(uintptr_t)pvParameters;
+
+    for(;;){
+        bench_take(kind,bench_binary,bench_counting,portMAX_DELAY);
+        bench_give(kind,bench_ping_handle,bench_pong_binary,bench_pong_counting);
+    }
+}
+
+/**
+ * 性能测试任务
+ * 1. 无竞争：同一任务先give再take，测API本身的开销
+ * 2. 乒乓：两个任务互相give/take，测跨任务的交接延迟（含一次任务切换）
+ */
+void bench_ping_task(void *pvParameters){
+    uint32_t start,local,roundtrip;
+
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    cycle_counter_init();
+
+    printf("\n[性能测试] give/take延迟（%d次平均，%s）\n", BENCH_ITERATIONS, CYCLE_UNIT);
+    printf("  方式            无竞争give+take   跨任务单程交接\n");
+
+    for(uint32_t k=0;k<BENCH_KIND_COUNT;k++){
+        //1. 同一任务内give+take：通知发给自己
+        start=cycle_counter_get();
+        for(uint32_t i=0;i<BENCH_ITERATIONS;i++){
+            bench_give((BenchKind_t)k,xTaskGetCurrentTaskHandle(),bench_pong_binary,bench_pong_counting);
+            bench_take((BenchKind_t)k,bench_pong_binary,bench_pong_counting,0);
+        }
+        local=(cycle_counter_get()-start)/BENCH_ITERATIONS;
+
+        //2. 乒乓：对端任务优先级更高，give之后立即切换过去
+        xTaskCreate(bench_pong_task,"BenchPong",256,(void*)(uintptr_t)k,5,&bench_pong_handle);
+        start=cycle_counter_get();
+        for(uint32_t i=0;i<BENCH_ITERATIONS;i++){
+            bench_give((BenchKind_t)k,bench_pong_handle,bench_binary,bench_counting);
+            bench_take((BenchKind_t)k,bench_pong_binary,bench_pong_counting,portMAX_DELAY);
+        }
+        roundtrip=(cycle_counter_get()-start)/BENCH_ITERATIONS;
+        vTaskDelete(bench_pong_handle);
+
+        printf("  %-14s %10lu %16lu\n", bench_names[k], local, roundtrip/2);
+    }
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 多槽任务通知与32位邮箱\n");
+    printf("每个任务有 %d 个通知槽\n\n", configTASK_NOTIFICATION_ARRAY_ENTRIES);
+
+    bench_binary=xSemaphoreCreateBinary();
+    bench_pong_binary=xSemaphoreCreateBinary();
+    bench_counting=xSemaphoreCreateCounting(3,0);       //与demo6的MAX_RESOURCES一致
+    bench_pong_counting=xSemaphoreCreateCounting(3,0);
+    if(bench_binary==NULL||bench_pong_binary==NULL||bench_counting==NULL||bench_pong_counting==NULL){
+        printf("信号量创建失败\n");
+        return -1;
+    }
+
+    xTaskCreate(combined_handler_task, "Combined", 512, NULL, 3, &combined_handler_handle);
+    xTaskCreate(data_sender_task, "DataSend", 256, NULL, 2, NULL);
+    xTaskCreate(counter_incrementer_task, "CountInc", 256, NULL, 1, NULL);
+    xTaskCreate(event_generator_task, "EventGen", 256, NULL, 2, NULL);
+    xTaskCreate(interrupt_simulator_task, "IntSim", 256, NULL, 1, NULL);
+
+    xTaskCreate(bench_ping_task, "BenchPing", 512, NULL, 4, &bench_ping_handle);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败!\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 通知数组：
+   - V10.4.0起每个任务有configTASK_NOTIFICATION_ARRAY_ENTRIES个通知槽
+   - xTaskNotifyIndexed()/xTaskNotifyWaitIndexed()/ulTaskNotifyTakeIndexed()按索引操作
+   - 原来的xTaskNotify()等API就是操作索引0
+   - 每个槽都有独立的值和"待处理"状态，互不影响
+
+2. 等待任意槽：
+   - 任务一次只能阻塞在一个槽上
+   - 约定槽0作为位图，发送方写完目标槽后再置位图，等待方只等槽0
+   - 单槽等待的代价是每次发送多一次内核调用，需要wait-any时才用
+
+3. 邮箱模式：
+   - eSetValueWithoutOverwrite：邮箱里有值时发送失败，接收方取走后才能再投递
+   - eSetValueWithOverwrite：总是保留最新值，适合ADC采样等"只要最新"的数据
+   - 只能传32位，需要传更大的数据时可以传指针（配合固定块内存池）
+
+4. 与信号量比较：
+   - 信号量是独立的内核对象，give/take要操作队列结构
+   - 通知直接修改目标任务TCB里的值，没有额外对象
+   - 限制：只能由一个任务接收，接收方必须事先知道
+
+5. 注意事项：
+   - 槽的分配要在工程中统一规划，避免两个模块使用同一个槽
+   - 有些FreeRTOS库（如流缓冲区）内部使用槽0，本demo的槽0约定需要避开这类用法
+*/
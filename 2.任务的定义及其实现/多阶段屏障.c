@@ -0,0 +1,314 @@
+/*
+ * Demo: N方多阶段屏障（rendezvous）
+ * 学习要点：
+ * 1. 屏障：N个参与者都到达之后才一起继续，相当于xEventGroupSync()
+ * 2. 多阶段：同一个屏障可以反复使用，每次全部到达后阶段号+1
+ * 3. 最后一个到达者直接唤醒其他所有参与者，不需要事件位，也不需要额外的任务
+ * 4. 计时：记录每个参与者每个阶段的到达时刻和等待时间，找出每个阶段的"拖后腿者"
+ * 5. 启动时间分析：从调度器启动到进入运行状态的总时间 = 各阶段最慢参与者之和
+ * 6. 屏障也可用于周期性的同步（多个传感器同时采样），每个周期自动复位
+ *
+ * 对应场景：demo8的system_init_task、hardware_init_task、config_task、network_task
+ *          通过ALL_SYSTEMS_READY事件位协调启动，main_app_task等待15秒
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include "../cycle_counter.h"
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES < 2)
+    #error "本demo需要至少2个任务通知槽"
+#endif
+
+
+// ==================== 多阶段屏障 ====================
+#define BARRIER_MAX_PARTIES     8       //参与者上限
+#define BARRIER_MAX_PHASES      8       //保留计时记录的阶段数（之后的阶段只统计不记录明细）
+#define BARRIER_NOTIFY_INDEX    (configTASK_NOTIFICATION_ARRAY_ENTRIES-1)   //放行通知用的槽
+
+//每个阶段的计时记录
+typedef struct{
+    TickType_t arrive_tick[BARRIER_MAX_PARTIES];    //各参与者到达时刻
+    TickType_t release_tick;                        //最后一个到达、全体放行的时刻
+    uint32_t release_cycle;                         //放行时的周期计数（测唤醒延迟）
+    uint32_t wake_latency[BARRIER_MAX_PARTIES];     //放行到各参与者恢复运行的延迟
+    uint8_t last_arriver;                           //拖后腿者
+}BarrierPhase_t;
+
+typedef struct{
+    const char *name;
+    uint32_t parties;                               //参与者数量
+    const char *party_names[BARRIER_MAX_PARTIES];
+    TaskHandle_t waiting[BARRIER_MAX_PARTIES];      //本阶段已到达、正在等待的任务
+    uint32_t arrived_mask;                          //本阶段已到达的参与者
+    volatile uint32_t phase;                        //当前阶段号，全体到达后+1
+    TickType_t start_tick;                          //时间线起点
+
+    BarrierPhase_t records[BARRIER_MAX_PHASES];
+    uint32_t timeouts;
+}Barrier_t;
+
+
+/**
+ * 初始化屏障
+ * 参数：name - 屏障名；parties - 参与者数量；party_names - 参与者名字（用于报告，可为NULL）
+ */
+void Barrier_Init(Barrier_t *barrier, const char *name, uint32_t parties, const char *const *party_names){
+    configASSERT(parties>0&&parties<=BARRIER_MAX_PARTIES);
+
+    memset(barrier,0,sizeof(Barrier_t));
+    barrier->name=name;
+    barrier->parties=parties;
+    for(uint32_t i=0;i<parties;i++){
+        barrier->party_names[i]=party_names?party_names[i]:"?";
+    }
+    barrier->start_tick=xTaskGetTickCount();
+}
+
+
+/**
+ * 到达屏障并等待其他参与者
+ * 功能：最后一个到达者记录放行时刻、阶段号+1并逐个通知其他参与者；
+ *      其他参与者阻塞到被通知为止
+ * 参数：party - 参与者编号（0~parties-1）；timeout - 最长等待时间
+ * 返回：刚刚完成的阶段号；超时返回-1（同时撤销本次到达）
+ */
+int32_t Barrier_Arrive(Barrier_t *barrier, uint32_t party, TickType_t timeout){
+    uint32_t my_phase;
+    BarrierPhase_t *rec;
+    TickType_t start_tick=xTaskGetTickCount();
+
+    configASSERT(party<barrier->parties);
+
+    taskENTER_CRITICAL();
+    {
+        my_phase=barrier->phase;
+        rec=(my_phase<BARRIER_MAX_PHASES)?&barrier->records[my_phase]:NULL;
+
+        configASSERT((barrier->arrived_mask&(1UL<<party))==0);
+        barrier->arrived_mask|=1UL<<party;
+        if(rec){
+            rec->arrive_tick[party]=start_tick;
+        }
+
+        if(barrier->arrived_mask==(1UL<<barrier->parties)-1){
+            //最后一个到达：复位并放行所有人
+            if(rec){
+                rec->release_tick=start_tick;
+                rec->release_cycle=cycle_counter_get();
+                rec->last_arriver=(uint8_t)party;
+            }
+            barrier->arrived_mask=0;
+            barrier->phase=my_phase+1;
+            for(uint32_t i=0;i<barrier->parties;i++){
+                if(barrier->waiting[i]!=NULL){
+                    xTaskNotifyGiveIndexed(barrier->waiting[i],BARRIER_NOTIFY_INDEX);
+                    barrier->waiting[i]=NULL;
+                }
+            }
+            taskEXIT_CRITICAL();
+            return (int32_t)my_phase;
+        }
+
+        barrier->waiting[party]=xTaskGetCurrentTaskHandle();
+    }
+    taskEXIT_CRITICAL();
+
+    for(;;){
+        TickType_t elapsed=xTaskGetTickCount()-start_tick;
+        TickType_t remaining=(timeout==portMAX_DELAY)?portMAX_DELAY:
+                             (elapsed>=timeout?0:timeout-elapsed);
+
+        ulTaskNotifyTakeIndexed(BARRIER_NOTIFY_INDEX,pdTRUE,remaining);
+        if(barrier->phase!=my_phase){
+            if(rec){
+                rec->wake_latency[party]=cycle_counter_get()-rec->release_cycle;
+            }
+            return (int32_t)my_phase;
+        }
+        if(remaining==0){
+            break;
+        }
+    }
+
+    //超时：撤销到达。与放行撞在一起时以放行为准
+    taskENTER_CRITICAL();
+    {
+        if(barrier->phase!=my_phase){
+            taskEXIT_CRITICAL();
+            ulTaskNotifyValueClearIndexed(NULL,BARRIER_NOTIFY_INDEX,0xFFFFFFFF);
+            return (int32_t)my_phase;
+        }
+        barrier->arrived_mask&=~(1UL<<party);
+        barrier->waiting[party]=NULL;
+        barrier->timeouts++;
+    }
+    taskEXIT_CRITICAL();
+
+    return -1;
+}
+
+
+/**
+ * 打印屏障的时间线报告
+ * 每个阶段：放行时刻、阶段耗时、拖后腿者，以及每个参与者的到达时刻和等待时间
+ */
+void Barrier_Report(Barrier_t *barrier){
+    uint32_t phases=barrier->phase<BARRIER_MAX_PHASES?barrier->phase:BARRIER_MAX_PHASES;
+    TickType_t prev_release=barrier->start_tick;
+
+    printf("\n========== 屏障报告: %s（%lu方，已完成%lu个阶段，超时%lu次）==========\n",
+           barrier->name, barrier->parties, barrier->phase, barrier->timeouts);
+
+    for(uint32_t p=0;p<phases;p++){
+        BarrierPhase_t *rec=&barrier->records[p];
+
+        printf("阶段%lu: 放行于%lums，阶段耗时%lums，最慢: %s\n", p,
+               (uint32_t)((rec->release_tick-barrier->start_tick)*portTICK_PERIOD_MS),
+               (uint32_t)((rec->release_tick-prev_release)*portTICK_PERIOD_MS),
+               barrier->party_names[rec->last_arriver]);
+
+        for(uint32_t i=0;i<barrier->parties;i++){
+            printf("  %-12s 到达%6lums  等待%6lums  唤醒延迟%6lu%s\n", barrier->party_names[i],
+                   (uint32_t)((rec->arrive_tick[i]-barrier->start_tick)*portTICK_PERIOD_MS),
+                   (uint32_t)((rec->release_tick-rec->arrive_tick[i])*portTICK_PERIOD_MS),
+                   rec->wake_latency[i], CYCLE_UNIT);
+        }
+        prev_release=rec->release_tick;
+    }
+    printf("总耗时: %lums\n", (uint32_t)((prev_release-barrier->start_tick)*portTICK_PERIOD_MS));
+}
+
+
+// ==================== demo8的多阶段启动 ====================
+/*
+ * 阶段0 基础初始化：内核/内存、GPIO/串口、读Flash配置、网络PHY上电，全部并行
+ * 阶段1 依赖初始化：总线、配置验证、WiFi连接（需要阶段0的硬件）
+ * 阶段2 进入运行：所有子系统就绪
+ * 原demo8中网络任务要等HARDWARE_READY后才开始，主应用最后再等ALL_SYSTEMS_READY；
+ * 这里把每个子系统的工作按依赖切成阶段，同一阶段内全部并行
+ */
+typedef enum{
+    PARTY_SYSTEM=0,
+    PARTY_HARDWARE,
+    PARTY_CONFIG,
+    PARTY_NETWORK,
+    PARTY_MAIN_APP,
+    BOOT_PARTIES
+}BootParty_t;
+
+#define BOOT_PHASES     3
+
+static const char *const boot_party_names[BOOT_PARTIES]={
+    "系统初始化","硬件初始化","配置管理","网络管理","主应用"
+};
+
+//每个参与者在每个阶段的工作量（ms）
+static const uint16_t boot_work_ms[BOOT_PARTIES][BOOT_PHASES]={
+    {1500, 800, 0},     //系统：内核+内存，收尾
+    {1000, 700, 0},     //硬件：GPIO+串口，SPI/I2C总线
+    {1200, 300, 0},     //配置：读Flash，验证
+    { 300,2000, 0},     //网络：PHY上电，WiFi连接
+    { 200,   0, 0},     //主应用：加载应用资源
+};
+
+static Barrier_t boot_barrier;
+
+void boot_participant_task(void *pvParameters){
+    uint32_t party=(uint32_t)(uintptr_t)pvParameters;
+
+    for(uint32_t phase=0;phase<BOOT_PHASES;phase++){
+        if(boot_work_ms[party][phase]>0){
+            vTaskDelay(pdMS_TO_TICKS(boot_work_ms[party][phase]));
+        }
+
+        if(Barrier_Arrive(&boot_barrier,party,pdMS_TO_TICKS(15000))<0){
+            printf("[%s] 阶段%lu等待超时！\n", boot_party_names[party], phase);
+            vTaskDelete(NULL);
+        }
+    }
+
+    if(party==PARTY_MAIN_APP){
+        printf("[主应用] 所有子系统准备就绪，主应用开始运行！\n");
+        Barrier_Report(&boot_barrier);
+    }
+    vTaskDelete(NULL);
+}
+
+
+// ==================== 周期性同步：多传感器同时采样 ====================
+#define SENSOR_PARTIES      4
+
+static const char *const sensor_party_names[SENSOR_PARTIES]={"温度","湿度","压力","光照"};
+static Barrier_t sample_barrier;
+
+void sensor_sample_task(void *pvParameters){
+    uint32_t party=(uint32_t)(uintptr_t)pvParameters;
+
+    for(;;){
+        //模拟各传感器不同的转换时间
+        vTaskDelay(pdMS_TO_TICKS(50+party*30));
+
+        int32_t phase=Barrier_Arrive(&sample_barrier,party,pdMS_TO_TICKS(1000));
+        if(phase<0){
+            printf("[传感器%s] 采样同步超时\n", sensor_party_names[party]);
+            continue;
+        }
+
+        //每个周期只让一个参与者打印
+        if(party==0&&phase==BARRIER_MAX_PHASES-1){
+            Barrier_Report(&sample_barrier);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 多阶段屏障\n");
+
+    cycle_counter_init();
+    Barrier_Init(&boot_barrier,"启动",BOOT_PARTIES,boot_party_names);
+    Barrier_Init(&sample_barrier,"同步采样",SENSOR_PARTIES,sensor_party_names);
+
+    for(uint32_t i=0;i<BOOT_PARTIES;i++){
+        xTaskCreate(boot_participant_task, boot_party_names[i], 256, (void*)(uintptr_t)i, 3, NULL);
+    }
+    for(uint32_t i=0;i<SENSOR_PARTIES;i++){
+        xTaskCreate(sensor_sample_task, "Sample", 256, (void*)(uintptr_t)i, 2, NULL);
+    }
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 屏障与事件组同步的区别：
+   - xEventGroupSync()需要为每个参与者分配一个事件位，复用前要自己清位
+   - 屏障按参与者编号记录到达，全体到达后自动复位，阶段号递增即可复用
+
+2. 放行方式：
+   - 最后一个到达者在临界段内递增阶段号，并逐个通知正在等待的参与者
+   - 等待者被唤醒后比较阶段号，不会被过期的通知误唤醒
+
+3. 超时处理：
+   - 超时的参与者撤销自己的到达标记，屏障保持一致
+   - 如果超时时恰好被放行，以放行为准
+
+4. 启动时间分析：
+   - 每个阶段的耗时由最慢的参与者决定，报告里的"最慢"就是需要优化的对象
+   - 各参与者的等待时间越长，说明它的工作可以放到更早的阶段
+   - 总启动时间 = 各阶段最慢参与者耗时之和
+
+5. 注意事项：
+   - 一个参与者在同一阶段只能到达一次
+   - 屏障不能在中断中使用
+*/
@@ -0,0 +1,405 @@
+/*
+ * Demo: 无锁快速路径的计数信号量
+ * 学习要点：
+ * 1. xSemaphoreTake/Give每次都要进入内核临界段（关中断），即使有可用资源
+ * 2. 快速计数信号量：用一个原子整数表示资源数，没竞争时一次原子操作就完成
+ * 3. 计数为负数表示有任务在等待，只有这时才落到内核信号量上阻塞/唤醒
+ * 4. 超时处理：等待者超时后要把自己"撤销"，和释放方之间有竞态需要仔细处理
+ * 5. 与xSemaphoreTake/Give、任务通知对比每次take/give的开销
+ *
+ * 对应场景：demo6的counting_semaphore（MAX_RESOURCES=3个资源）
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdio.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 原子操作 ====================
+/*
+ * Cortex-M3/M4/M7和主机平台：用LDREX/STREX（GCC的__atomic内建函数）
+ * Cortex-M0(ARMv6-M)没有独占访问指令，退化为屏蔽中断的短临界段（只有几条指令）
+ */
+#if defined(__ARM_ARCH_6M__)
+static int32_t sem_atomic_fetch_add(volatile int32_t *ptr, int32_t delta){
+    UBaseType_t saved=portSET_INTERRUPT_MASK_FROM_ISR();
+    int32_t old=*ptr;
+    *ptr=old+delta;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+    return old;
+}
+
+static BaseType_t sem_cas(volatile int32_t *ptr, int32_t expected, int32_t desired){
+    BaseType_t ok=pdFALSE;
+    UBaseType_t saved=portSET_INTERRUPT_MASK_FROM_ISR();
+    if(*ptr==expected){
+        *ptr=desired;
+        ok=pdTRUE;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved);
+    return ok;
+}
+#else
+static int32_t sem_atomic_fetch_add(volatile int32_t *ptr, int32_t delta){
+    return __atomic_fetch_add(ptr,delta,__ATOMIC_ACQ_REL);
+}
+
+static BaseType_t sem_cas(volatile int32_t *ptr, int32_t expected, int32_t desired){
+    return __atomic_compare_exchange_n(ptr,&expected,desired,pdFALSE,
+                                       __ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)?pdTRUE:pdFALSE;
+}
+#endif
+
+
+// ==================== 快速计数信号量 ====================
+/*
+ * count > 0：可用资源数
+ * count = 0：没有可用资源，也没有等待者
+ * count < 0：-count个任务在等待（或正在进入等待）
+ *
+ * take：count减1，减之前>0就直接成功（快速路径）；否则到wait_sem上阻塞
+ * give：count加1，加之前<0说明有等待者，给wait_sem一个"唤醒令牌"
+ * wait_sem是内核计数信号量，只在有竞争时才会被用到
+ */
+#define FASTSEM_MAX_WAITERS     32      //同时等待的任务上限（wait_sem的最大计数）
+
+typedef struct{
+    volatile int32_t count;
+    int32_t max_count;
+    SemaphoreHandle_t wait_sem;
+
+    //统计信息（只在慢速路径上更新）
+    volatile int32_t slow_takes;        //需要阻塞的take
+    volatile int32_t slow_gives;        //需要唤醒等待者的give
+    volatile int32_t timeouts;
+}FastSem_t;
+
+
+/**
+ * 创建快速计数信号量
+ * 参数：max_count - 最大计数；initial_count - 初始计数
+ * 返回：pdPASS成功，pdFAIL内核信号量创建失败
+ */
+BaseType_t FastSem_Init(FastSem_t *sem, int32_t max_count, int32_t initial_count){
+    configASSERT(initial_count>=0&&initial_count<=max_count);
+
+    sem->count=initial_count;
+    sem->max_count=max_count;
+    sem->slow_takes=0;
+    sem->slow_gives=0;
+    sem->timeouts=0;
+    sem->wait_sem=xSemaphoreCreateCounting(FASTSEM_MAX_WAITERS,0);
+
+    return (sem->wait_sem!=NULL)?pdPASS:pdFAIL;
+}
+
+
+/**
+ * 不阻塞地尝试获取：只有count>0时才减，绝不把count减成负数
+ */
+BaseType_t FastSem_TryTake(FastSem_t *sem){
+    int32_t old=sem->count;
+
+    while(old>0){
+        if(sem_cas(&sem->count,old,old-1)==pdTRUE){
+            return pdPASS;
+        }
+        old=sem->count;
+    }
+    return pdFAIL;
+}
+
+
+/**
+ * 获取资源
+ * 功能：快速路径一次原子减；没有资源时阻塞在内核信号量上
+ * 参数：timeout - 最长等待时间，0表示不等待
+ * 返回：pdPASS成功，pdFAIL超时
+ */
+BaseType_t FastSem_Take(FastSem_t *sem, TickType_t timeout){
+    if(timeout==0){
+        return FastSem_TryTake(sem);
+    }
+
+    //快速路径：减之前还有资源
+    if(sem_atomic_fetch_add(&sem->count,-1)>0){
+        return pdPASS;
+    }
+
+    //慢速路径：已经把自己登记为等待者（count<0），等一个唤醒令牌
+    sem_atomic_fetch_add(&sem->slow_takes,1);
+    if(xSemaphoreTake(sem->wait_sem,timeout)==pdTRUE){
+        return pdPASS;
+    }
+
+    //超时：撤销登记。如果count仍<0，说明还没有释放方为我们发令牌，+1撤销即可
+    for(;;){
+        int32_t old=sem->count;
+
+        if(old<0){
+            if(sem_cas(&sem->count,old,old+1)==pdTRUE){
+                sem_atomic_fetch_add(&sem->timeouts,1);
+                return pdFAIL;
+            }
+        }else{
+            //释放方已经把我们算进去并且会（或已经）发出令牌，把令牌收走，视为成功
+            xSemaphoreTake(sem->wait_sem,portMAX_DELAY);
+            return pdPASS;
+        }
+    }
+}
+
+
+/**
+ * 释放资源
+ * 功能：快速路径一次CAS加1；发现有等待者时给内核信号量一个令牌
+ * 返回：pdPASS成功，pdFAIL已达最大计数
+ */
+BaseType_t FastSem_Give(FastSem_t *sem){
+    int32_t old=sem->count;
+
+    for(;;){
+        if(old>=sem->max_count){
+            return pdFAIL;
+        }
+        if(sem_cas(&sem->count,old,old+1)==pdTRUE){
+            break;
+        }
+        old=sem->count;
+    }
+
+    if(old<0){
+        sem_atomic_fetch_add(&sem->slow_gives,1);
+        xSemaphoreGive(sem->wait_sem);
+    }
+    return pdPASS;
+}
+
+
+/**
+ * 在中断中释放资源
+ */
+BaseType_t FastSem_GiveFromISR(FastSem_t *sem, BaseType_t *pxHigherPriorityTaskWoken){
+    int32_t old=sem->count;
+
+    for(;;){
+        if(old>=sem->max_count){
+            return pdFAIL;
+        }
+        if(sem_cas(&sem->count,old,old+1)==pdTRUE){
+            break;
+        }
+        old=sem->count;
+    }
+
+    if(old<0){
+        sem_atomic_fetch_add(&sem->slow_gives,1);
+        xSemaphoreGiveFromISR(sem->wait_sem,pxHigherPriorityTaskWoken);
+    }
+    return pdPASS;
+}
+
+
+//当前可用资源数（负数时返回0）
+static inline int32_t FastSem_GetCount(FastSem_t *sem){
+    int32_t count=sem->count;
+    return count>0?count:0;
+}
+
+
+// ==================== demo6的计数信号量示例 ====================
+#define MAX_RESOURCES 3
+
+static FastSem_t resource_sem;
+static volatile int32_t resource_pool_count=0;
+
+void worker_task(void *pvParameters){
+    int worker_id=(int)(uintptr_t)pvParameters;
+
+    for(;;){
+        if(FastSem_Take(&resource_sem,pdMS_TO_TICKS(5000))==pdPASS){
+            int32_t in_use=sem_atomic_fetch_add(&resource_pool_count,1)+1;
+            printf("[工作者%d] 获取资源，当前资源数%ld\n", worker_id, in_use);
+
+            //使用资源（模拟工作）
+            vTaskDelay(pdMS_TO_TICKS(3000));
+
+            sem_atomic_fetch_add(&resource_pool_count,-1);
+            FastSem_Give(&resource_sem);
+            printf("[工作者%d] 释放资源\n", worker_id);
+        }else{
+            printf("[工作者%d] 尝试获取资源失败\n", worker_id);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_ITERATIONS        100000  //无竞争时的take/give次数
+#define BENCH_CONTEND_WORKERS   6       //有竞争测试：6个任务抢3个资源
+#define BENCH_CONTEND_MS        1000
+
+static SemaphoreHandle_t bench_kernel_sem;
+static FastSem_t bench_fast_sem;
+static volatile BaseType_t bench_contend_running;
+static volatile BaseType_t bench_contend_fast;
+static volatile uint32_t bench_contend_ops;
+
+/**
+ * 有竞争时的工作任务：拿到资源、做一点事、释放
+ */
+void bench_contend_task(void *pvParameters){
+    for(;;){
+        if(!bench_contend_running){
+            vTaskDelay(1);
+            continue;
+        }
+
+        if(bench_contend_fast){
+            FastSem_Take(&bench_fast_sem,portMAX_DELAY);
+            for(volatile int i=0;i<50;i++);
+            FastSem_Give(&bench_fast_sem);
+        }else{
+            xSemaphoreTake(bench_kernel_sem,portMAX_DELAY);
+            for(volatile int i=0;i<50;i++);
+            xSemaphoreGive(bench_kernel_sem);
+        }
+        taskENTER_CRITICAL();
+        bench_contend_ops++;
+        taskEXIT_CRITICAL();
+
+        //偶尔让出CPU，让同优先级的任务真正形成竞争
+        if((bench_contend_ops&63)==0){
+            taskYIELD();
+        }
+    }
+}
+
+/**
+ * 基准测试任务
+ * 1. 无竞争：同一个任务连续take/give，测每对操作的平均开销
+ * 2. 有竞争：6个任务抢3个资源，测吞吐量和落到慢速路径的比例
+ */
+void bench_task(void *pvParameters){
+    uint32_t start,cost_fast,cost_kernel,cost_notify;
+
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    cycle_counter_init();
+
+    printf("\n[性能测试] 无竞争take+give，每种%d次（%s/对）\n", BENCH_ITERATIONS, CYCLE_UNIT);
+
+    //快速计数信号量
+    start=cycle_counter_get();
+    for(uint32_t i=0;i<BENCH_ITERATIONS;i++){
+        FastSem_Take(&bench_fast_sem,portMAX_DELAY);
+        FastSem_Give(&bench_fast_sem);
+    }
+    cost_fast=(cycle_counter_get()-start)/BENCH_ITERATIONS;
+
+    //内核计数信号量
+    start=cycle_counter_get();
+    for(uint32_t i=0;i<BENCH_ITERATIONS;i++){
+        xSemaphoreTake(bench_kernel_sem,portMAX_DELAY);
+        xSemaphoreGive(bench_kernel_sem);
+    }
+    cost_kernel=(cycle_counter_get()-start)/BENCH_ITERATIONS;
+
+    //任务通知当计数信号量用（只能由自己take）
+    start=cycle_counter_get();
+    for(uint32_t i=0;i<BENCH_ITERATIONS;i++){
+        xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+        ulTaskNotifyTake(pdFALSE,0);
+    }
+    cost_notify=(cycle_counter_get()-start)/BENCH_ITERATIONS;
+
+    printf("  快速计数信号量:   %lu\n", cost_fast);
+    printf("  xSemaphoreTake/Give: %lu\n", cost_kernel);
+    printf("  任务通知:         %lu\n", cost_notify);
+
+    printf("\n[性能测试] 有竞争：%d个任务抢%d个资源，各%dms\n",
+           BENCH_CONTEND_WORKERS, MAX_RESOURCES, BENCH_CONTEND_MS);
+
+    for(BaseType_t fast=pdTRUE;fast>=pdFALSE;fast--){
+        bench_contend_fast=fast;
+        bench_contend_ops=0;
+        bench_fast_sem.slow_takes=0;
+
+        bench_contend_running=pdTRUE;
+        vTaskDelay(pdMS_TO_TICKS(BENCH_CONTEND_MS));
+        bench_contend_running=pdFALSE;
+        vTaskDelay(pdMS_TO_TICKS(50));
+
+        if(fast){
+            printf("  快速计数信号量: %lu次/秒，慢速路径%ld次（%lu%%）\n",
+                   bench_contend_ops*1000/BENCH_CONTEND_MS, bench_fast_sem.slow_takes,
+                   (uint32_t)bench_fast_sem.slow_takes*100/(bench_contend_ops?bench_contend_ops:1));
+        }else{
+            printf("  内核计数信号量: %lu次/秒\n", bench_contend_ops*1000/BENCH_CONTEND_MS);
+        }
+    }
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 无锁快速计数信号量\n");
+
+    if(FastSem_Init(&resource_sem,MAX_RESOURCES,MAX_RESOURCES)!=pdPASS||
+       FastSem_Init(&bench_fast_sem,MAX_RESOURCES,MAX_RESOURCES)!=pdPASS){
+        printf("快速计数信号量创建失败\n");
+        return -1;
+    }
+
+    bench_kernel_sem=xSemaphoreCreateCounting(MAX_RESOURCES,MAX_RESOURCES);
+    if(bench_kernel_sem==NULL){
+        printf("计数信号量创建失败\n");
+        return -1;
+    }
+
+    xTaskCreate(worker_task, "Worker1", 256, (void*)1, 2, NULL);
+    xTaskCreate(worker_task, "Worker2", 256, (void*)2, 2, NULL);
+    xTaskCreate(worker_task, "Worker3", 256, (void*)3, 2, NULL);
+    xTaskCreate(worker_task, "Worker4", 256, (void*)4, 2, NULL);
+
+    for(int i=0;i<BENCH_CONTEND_WORKERS;i++){
+        xTaskCreate(bench_contend_task, "Contend", 256, NULL, 1, NULL);
+    }
+    xTaskCreate(bench_task, "Bench", 512, NULL, 3, NULL);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 快速路径的原理：
+   - 大多数时候都有可用资源，这时只需要一次原子减（LDREX/STREX），不关中断
+   - 只有资源用完时才进入内核：xSemaphoreTake在wait_sem上阻塞
+   - 释放时看原子加之前的值：<0说明有人在等，才需要xSemaphoreGive唤醒
+
+2. 计数为负数的含义：
+   - count=-2表示资源用完且有2个任务在等待（或正要开始等待）
+   - 先减计数再阻塞，释放方发的令牌会留在wait_sem里，不会丢失唤醒
+
+3. 超时撤销的竞态：
+   - 超时后count<0：还没人给我们发令牌，CAS加1撤销即可
+   - 超时后count>=0：释放方已经把我们算作等待者并发了令牌，必须把令牌收走，
+     否则下一个等待者会被错误唤醒。这种情况视为获取成功
+
+4. 与任务通知的比较：
+   - 任务通知也很快，但只能由目标任务自己take，不能多个任务竞争同一组资源
+   - 快速计数信号量保持了"多对多"的语义，开销接近任务通知
+
+5. 注意事项：
+   - 不支持优先级继承，不要用它代替互斥锁
+   - 中断里只能Give（FastSem_GiveFromISR），不能Take
+*/
@@ -0,0 +1,736 @@
+/*
+ * Demo: 无栈协程（在一个执行器任务上运行成千上万个顺序流程）
+ * 学习要点：
+ * 1. demo10.c的timer_control_task、demo4.c的Controller_Task都是"做一步-vTaskDelay-再做一步"的状态机，
+ *    每个都占一个完整的任务和几百字的栈，只为了在vTaskDelay里保存一个步骤号
+ * 2. 无栈协程：用switch和__LINE__记录恢复点（protothread的做法），函数返回时只保存一个行号，
+ *    下次调用直接跳回上次等待的位置，代码仍然按顺序写：CO_DELAY(co, ticks)、CO_QUEUE_RECEIVE(co, q, &item)
+ * 3. 所有协程在一个执行器任务上轮流运行，共用执行器的栈；每个协程只要一个控制块加自己的上下文
+ * 4. 延时列表只由执行器访问，不需要临界段；就绪列表和协程队列会被其他任务/中断访问，用临界段保护
+ * 5. 性能测试：每个活动的内存、从队列发送到协程恢复的延迟、每次恢复的开销，和普通任务对比
+ *
+ * 对应场景：demo10.c的timer_control_task，demo4.c的Controller_Task和Work1~3_Task
+ *
+ * 编写协程的限制：
+ * - 局部变量在等待之后不保留，要跨等待保存的状态放在context里
+ * - 一行只能写一个等待宏（恢复点用__LINE__区分）
+ * - 等待宏不能放在协程内部自己的switch语句里
+ * - 不能调用会阻塞的FreeRTOS API，要等待时用CO_DELAY/CO_QUEUE_RECEIVE
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdio.h>
+#include <string.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 协程与执行器 ====================
+typedef struct Coroutine Coroutine_t;
+typedef struct CoExecutor CoExecutor_t;
+
+typedef enum{
+    CO_WAITING=0,       //在某个等待点挂起，之后会被恢复
+    CO_DONE             //运行到CO_END，结束
+}CoStatus_t;
+
+typedef enum{
+    CO_STATE_READY,
+    CO_STATE_RUNNING,
+    CO_STATE_DELAYED,
+    CO_STATE_WAIT_QUEUE,
+    CO_STATE_DONE
+}CoState_t;
+
+typedef CoStatus_t (*CoFunction_t)(Coroutine_t *co);
+
+struct Coroutine{
+    CoFunction_t fn;
+    void *context;              //跨等待点保存的状态
+    CoExecutor_t *executor;
+    Coroutine_t *next;          //就绪列表/延时列表/队列等待列表共用，同一时刻只在一个列表里
+    TickType_t wake_tick;
+    uint16_t lc;                //恢复点（行号），0表示从头开始
+    uint8_t state;
+    const char *name;
+};
+
+struct CoExecutor{
+    TaskHandle_t task;
+    const char *name;
+    Coroutine_t *ready_head;    //其他任务/中断也会访问，临界段保护
+    Coroutine_t *ready_tail;
+    Coroutine_t *delay_head;    //只有执行器访问，按到期时间排序
+    Coroutine_t *delay_tail;
+
+    //统计信息
+    uint32_t live;              //未结束的协程数
+    uint32_t resumes;           //协程被恢复的次数
+    uint32_t wakeups;           //执行器被唤醒的次数
+};
+
+/*
+ * 协程函数的写法：
+ *   CoStatus_t blink(Coroutine_t *co){
+ *       CO_BEGIN(co);
+ *       for(;;){
+ *           led_toggle();
+ *           CO_DELAY(co, pdMS_TO_TICKS(500));
+ *       }
+ *       CO_END(co);
+ *   }
+ */
+#define CO_BEGIN(co)        switch((co)->lc){ case 0:
+#define CO_END(co)          } (co)->lc=0; return CO_DONE
+
+//让出执行器，排到就绪列表末尾
+#define CO_YIELD(co) \
+    do{ (co)->lc=__LINE__; co_make_ready(co); return CO_WAITING; case __LINE__:; }while(0)
+
+//延时ticks个节拍
+#define CO_DELAY(co, ticks) \
+    do{ (co)->lc=__LINE__; co_sleep((co),(ticks)); return CO_WAITING; case __LINE__:; }while(0)
+
+//从协程队列接收一项，队列空时挂起，有数据发送进来时恢复
+#define CO_QUEUE_RECEIVE(co, q, item) \
+    do{ (co)->lc=__LINE__; case __LINE__: \
+        if(!co_queue_receive_or_wait((co),(q),(item))) return CO_WAITING; }while(0)
+
+//挂到就绪列表，调用者在临界段内；返回是否需要唤醒执行器
+static BaseType_t co_make_ready_locked(Coroutine_t *co){
+    CoExecutor_t *ex=co->executor;
+    BaseType_t was_empty=(ex->ready_head==NULL);
+
+    co->state=CO_STATE_READY;
+    co->next=NULL;
+    if(ex->ready_tail){
+        ex->ready_tail->next=co;
+    }else{
+        ex->ready_head=co;
+    }
+    ex->ready_tail=co;
+    return was_empty;
+}
+
+static void co_make_ready(Coroutine_t *co){
+    BaseType_t kick;
+
+    taskENTER_CRITICAL();
+    {
+        kick=co_make_ready_locked(co);
+    }
+    taskEXIT_CRITICAL();
+
+    if(kick&&xTaskGetCurrentTaskHandle()!=co->executor->task){
+        xTaskNotifyGive(co->executor->task);
+    }
+}
+
+//放入延时列表（只在执行器里调用）；多数协程用相同的周期，先看能不能直接接在末尾
+static void co_sleep(Coroutine_t *co, TickType_t ticks){
+    CoExecutor_t *ex=co->executor;
+    Coroutine_t **link;
+
+    if(ticks==0){
+        co_make_ready(co);
+        return;
+    }
+    co->wake_tick=xTaskGetTickCount()+ticks;
+    co->state=CO_STATE_DELAYED;
+
+    if(ex->delay_tail==NULL||(int32_t)(co->wake_tick-ex->delay_tail->wake_tick)>=0){
+        co->next=NULL;
+        if(ex->delay_tail){
+            ex->delay_tail->next=co;
+        }else{
+            ex->delay_head=co;
+        }
+        ex->delay_tail=co;
+        return;
+    }
+    link=&ex->delay_head;
+    while((int32_t)((*link)->wake_tick-co->wake_tick)<=0){
+        link=&(*link)->next;
+    }
+    co->next=*link;
+    *link=co;
+}
+
+/**
+ * 启动协程
+ * 参数：co 控制块（调用者提供存储）；fn 协程函数；context 协程的状态
+ */
+void Co_Start(CoExecutor_t *ex, Coroutine_t *co, const char *name, CoFunction_t fn, void *context){
+    memset(co,0,sizeof(Coroutine_t));
+    co->executor=ex;
+    co->name=name;
+    co->fn=fn;
+    co->context=context;
+
+    taskENTER_CRITICAL();
+    {
+        ex->live++;
+    }
+    taskEXIT_CRITICAL();
+    co_make_ready(co);
+}
+
+//执行器：到期的延时协程和被唤醒的协程挂到就绪列表，然后把就绪列表整批取下依次恢复
+static void co_executor(void *pvParameters){
+    CoExecutor_t *ex=(CoExecutor_t*)pvParameters;
+
+    for(;;){
+        TickType_t wait=portMAX_DELAY;
+        TickType_t now;
+        Coroutine_t *expired=NULL,*expired_tail=NULL,*batch;
+        BaseType_t idle;
+
+        taskENTER_CRITICAL();
+        {
+            idle=(ex->ready_head==NULL);
+        }
+        taskEXIT_CRITICAL();
+
+        if(idle){
+            if(ex->delay_head!=NULL){
+                int32_t remaining=(int32_t)(ex->delay_head->wake_tick-xTaskGetTickCount());
+                wait=(remaining>0)?(TickType_t)remaining:0;
+            }
+            if(wait){
+                ulTaskNotifyTake(pdTRUE,wait);
+                ex->wakeups++;
+            }
+        }
+
+        //延时列表是有序的，到期的是开头一段，整段摘下
+        now=xTaskGetTickCount();
+        while(ex->delay_head&&(int32_t)(ex->delay_head->wake_tick-now)<=0){
+            Coroutine_t *co=ex->delay_head;
+            ex->delay_head=co->next;
+            co->state=CO_STATE_READY;
+            co->next=NULL;
+            if(expired_tail){
+                expired_tail->next=co;
+            }else{
+                expired=co;
+            }
+            expired_tail=co;
+        }
+        if(ex->delay_head==NULL){
+            ex->delay_tail=NULL;
+        }
+
+        taskENTER_CRITICAL();
+        {
+            if(expired){
+                if(ex->ready_tail){
+                    ex->ready_tail->next=expired;
+                }else{
+                    ex->ready_head=expired;
+                }
+                ex->ready_tail=expired_tail;
+            }
+            batch=ex->ready_head;
+            ex->ready_head=NULL;
+            ex->ready_tail=NULL;
+        }
+        taskEXIT_CRITICAL();
+
+        //恢复期间新就绪的协程进入新的就绪列表，下一轮处理
+        while(batch){
+            Coroutine_t *co=batch;
+            batch=co->next;
+            co->state=CO_STATE_RUNNING;
+            ex->resumes++;
+            if(co->fn(co)==CO_DONE){
+                co->state=CO_STATE_DONE;
+                taskENTER_CRITICAL();
+                {
+                    ex->live--;
+                }
+                taskEXIT_CRITICAL();
+            }
+        }
+    }
+}
+
+BaseType_t CoExecutor_Create(CoExecutor_t *ex, const char *name, UBaseType_t priority, uint16_t stack_words){
+    memset(ex,0,sizeof(CoExecutor_t));
+    ex->name=name;
+    return xTaskCreate(co_executor,name,stack_words,ex,priority,&ex->task);
+}
+
+
+// ==================== 协程队列 ====================
+// 定长环形缓冲 + 等待接收的协程链表；发送方是任务、中断或其他协程，不阻塞
+typedef struct{
+    uint8_t *storage;
+    uint16_t item_size;
+    uint16_t length;
+    uint16_t head;
+    uint16_t count;
+    Coroutine_t *waiters;
+}CoQueue_t;
+
+void CoQueue_Init(CoQueue_t *q, void *storage, uint16_t item_size, uint16_t length){
+    memset(q,0,sizeof(CoQueue_t));
+    q->storage=(uint8_t*)storage;
+    q->item_size=item_size;
+    q->length=length;
+}
+
+//取一项；队列空时在同一个临界段内登记为等待者，避免登记前发送的数据被漏掉
+static BaseType_t co_queue_receive_or_wait(Coroutine_t *co, CoQueue_t *q, void *item){
+    BaseType_t got=pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if(q->count){
+            memcpy(item,q->storage+(uint32_t)q->head*q->item_size,q->item_size);
+            q->head=(uint16_t)((q->head+1)%q->length);
+            q->count--;
+            got=pdTRUE;
+        }else{
+            co->state=CO_STATE_WAIT_QUEUE;
+            co->next=q->waiters;
+            q->waiters=co;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return got;
+}
+
+//放入一项并唤醒一个等待者，调用者在临界段内；返回需要通知的执行器
+static CoExecutor_t *co_queue_send_locked(CoQueue_t *q, const void *item, BaseType_t *sent){
+    CoExecutor_t *kick=NULL;
+
+    *sent=pdFALSE;
+    if(q->count<q->length){
+        uint16_t tail=(uint16_t)((q->head+q->count)%q->length);
+        memcpy(q->storage+(uint32_t)tail*q->item_size,item,q->item_size);
+        q->count++;
+        *sent=pdTRUE;
+        if(q->waiters){
+            Coroutine_t *co=q->waiters;
+            q->waiters=co->next;
+            if(co_make_ready_locked(co)){
+                kick=co->executor;
+            }
+        }
+    }
+    return kick;
+}
+
+/**
+ * 发送（任务或协程中调用）
+ * 返回：pdTRUE成功，pdFALSE队列满
+ */
+BaseType_t CoQueue_Send(CoQueue_t *q, const void *item){
+    CoExecutor_t *kick;
+    BaseType_t sent;
+
+    taskENTER_CRITICAL();
+    {
+        kick=co_queue_send_locked(q,item,&sent);
+    }
+    taskEXIT_CRITICAL();
+
+    if(kick&&xTaskGetCurrentTaskHandle()!=kick->task){
+        xTaskNotifyGive(kick->task);
+    }
+    return sent;
+}
+
+BaseType_t CoQueue_SendFromISR(CoQueue_t *q, const void *item, BaseType_t *pxHigherPriorityTaskWoken){
+    UBaseType_t saved=taskENTER_CRITICAL_FROM_ISR();
+    BaseType_t sent;
+    CoExecutor_t *kick=co_queue_send_locked(q,item,&sent);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    if(kick){
+        vTaskNotifyGiveFromISR(kick->task,pxHigherPriorityTaskWoken);
+    }
+    return sent;
+}
+
+
+// ==================== demo10.c / demo4.c改成协程 ====================
+#define EXECUTOR_PRIORITY       (tskIDLE_PRIORITY + 2)
+#define EXECUTOR_STACK_WORDS    512
+
+static CoExecutor_t executor;
+
+volatile uint32_t led_enabled=0;
+volatile uint32_t periodic_enabled=0;
+volatile uint32_t timeout_armed=0;
+
+//timer_control_task：原来靠control_step和switch在每次醒来时决定做哪一步，现在按顺序写
+typedef struct{
+    uint32_t cycle;
+}TimerControlContext_t;
+
+static TimerControlContext_t timer_control_ctx;
+static Coroutine_t timer_control_co;
+
+static CoStatus_t timer_control_co_run(Coroutine_t *co){
+    TimerControlContext_t *ctx=(TimerControlContext_t*)co->context;
+
+    CO_BEGIN(co);
+    for(;;){
+        ctx->cycle++;
+        printf("\n[定时器控制] ===== 第%lu轮 =====\n", ctx->cycle);
+        printf("[定时器控制] 启动LED闪烁\n");
+        led_enabled=1;
+        CO_DELAY(co, pdMS_TO_TICKS(3000));
+
+        printf("[定时器控制] 启动周期性数据采集\n");
+        periodic_enabled=1;
+        CO_DELAY(co, pdMS_TO_TICKS(6000));
+
+        printf("[定时器控制] 启动超时监控\n");
+        timeout_armed=1;
+        CO_DELAY(co, pdMS_TO_TICKS(9000));
+
+        printf("[定时器控制] 停止LED\n");
+        led_enabled=0;
+        CO_DELAY(co, pdMS_TO_TICKS(6000));
+
+        printf("[定时器控制] 重新启动LED\n");
+        led_enabled=1;
+        CO_DELAY(co, pdMS_TO_TICKS(15000));
+
+        printf("[定时器控制] 停止超时监控和采集，重新开始\n");
+        timeout_armed=0;
+        periodic_enabled=0;
+        CO_DELAY(co, pdMS_TO_TICKS(3000));
+    }
+    CO_END(co);
+}
+
+//Controller_Task / Work1~3_Task：暂停和恢复只是一个标志，不需要vTaskSuspend
+typedef struct{
+    TickType_t period;
+    uint32_t run_count;
+    uint8_t suspended;
+}WorkerContext_t;
+
+typedef struct{
+    uint32_t cycle;
+    uint32_t mode;
+}ControllerContext_t;
+
+static WorkerContext_t worker_ctx[3]={
+    { pdMS_TO_TICKS(300), 0, 0 },
+    { pdMS_TO_TICKS(500), 0, 0 },
+    { pdMS_TO_TICKS(700), 0, 0 }
+};
+static ControllerContext_t controller_ctx;
+static Coroutine_t worker_co[3],controller_co;
+
+static CoStatus_t worker_co_run(Coroutine_t *co){
+    WorkerContext_t *ctx=(WorkerContext_t*)co->context;
+
+    CO_BEGIN(co);
+    for(;;){
+        if(!ctx->suspended){
+            ctx->run_count++;
+        }
+        CO_DELAY(co, ctx->period);
+    }
+    CO_END(co);
+}
+
+static CoStatus_t controller_co_run(Coroutine_t *co){
+    ControllerContext_t *ctx=(ControllerContext_t*)co->context;
+
+    CO_BEGIN(co);
+    for(;;){
+        ctx->cycle++;
+        if(ctx->cycle%10==0){
+            ctx->mode=(ctx->mode+1)%3;
+            for(uint8_t i=0;i<3;i++){
+                switch(ctx->mode){
+                    case 0:     //全部运行
+                        worker_ctx[i].suspended=0;
+                        break;
+                    case 1:     //暂停Worker2
+                        worker_ctx[i].suspended=(i==1);
+                        break;
+                    default:    //轮流只运行一个
+                        worker_ctx[i].suspended=(i!=(ctx->cycle/10)%3);
+                        break;
+                }
+            }
+            printf("[控制器] 模式%lu 工作计数 %lu/%lu/%lu\n", ctx->mode,
+                   worker_ctx[0].run_count, worker_ctx[1].run_count, worker_ctx[2].run_count);
+        }
+        CO_DELAY(co, pdMS_TO_TICKS(1000));
+    }
+    CO_END(co);
+}
+
+//data_sender_task仍是普通任务，把数据发给协程；协程用CO_QUEUE_RECEIVE顺序地等待
+typedef struct{
+    uint32_t seq;
+    TickType_t sent_tick;
+}Packet_t;
+
+typedef struct{
+    Packet_t packet;            //接收缓冲要跨等待点，放在上下文里
+    uint32_t received;
+}ReceiverContext_t;
+
+static Packet_t packet_storage[8];
+static CoQueue_t packet_queue;
+static ReceiverContext_t receiver_ctx;
+static Coroutine_t receiver_co;
+
+static CoStatus_t receiver_co_run(Coroutine_t *co){
+    ReceiverContext_t *ctx=(ReceiverContext_t*)co->context;
+
+    CO_BEGIN(co);
+    for(;;){
+        CO_QUEUE_RECEIVE(co, &packet_queue, &ctx->packet);
+        ctx->received++;
+        if(ctx->packet.seq%10==0){
+            printf("[接收协程] 第%lu包 延迟%lu tick\n", ctx->packet.seq,
+                   (uint32_t)(xTaskGetTickCount()-ctx->packet.sent_tick));
+        }
+        //处理需要时间时也不占住执行器
+        CO_DELAY(co, pdMS_TO_TICKS(50));
+    }
+    CO_END(co);
+}
+
+void data_sender_task(void *pvParameters){
+    Packet_t packet={ 0, 0 };
+
+    for(;;){
+        packet.seq++;
+        packet.sent_tick=xTaskGetTickCount();
+        if(CoQueue_Send(&packet_queue,&packet)!=pdTRUE){
+            printf("[发送任务] 队列满，丢弃第%lu包\n", packet.seq);
+        }
+        vTaskDelay(pdMS_TO_TICKS(400));
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_COROUTINES    1000    //同时存在的协程数
+#define BENCH_TASKS         4       //任务的内存按这么多个的平均值算
+#define BENCH_ROUNDS        20      //每个协程让出的次数
+#define BENCH_LATENCY_ROUNDS    1000
+
+static CoExecutor_t bench_executor;
+static TaskHandle_t bench_handle,bench_probe_task,bench_ping_task,bench_pong_task;
+static volatile uint32_t bench_done;
+static volatile uint32_t bench_stamp;
+static volatile uint32_t bench_exchanges;
+static QueueHandle_t bench_queue;
+static CoQueue_t bench_co_queue;
+static uint32_t bench_co_queue_storage[4];
+static uint32_t bench_probe_item;
+static Coroutine_t bench_probe_co;
+
+static void bench_idle_task(void *pvParameters){
+    for(;;){
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+    }
+}
+
+//每个协程让出BENCH_ROUNDS次后结束，最后一个结束的通知测试任务
+static CoStatus_t bench_yield_co(Coroutine_t *co){
+    uint32_t *rounds=(uint32_t*)co->context;
+
+    CO_BEGIN(co);
+    while(++*rounds<BENCH_ROUNDS){
+        CO_YIELD(co);
+    }
+    if(++bench_done==BENCH_COROUTINES){
+        xTaskNotifyGive(bench_handle);
+    }
+    CO_END(co);
+}
+
+static CoStatus_t bench_probe_co_run(Coroutine_t *co){
+    CO_BEGIN(co);
+    for(;;){
+        CO_QUEUE_RECEIVE(co, &bench_co_queue, &bench_probe_item);
+        bench_stamp=cycle_counter_get();
+    }
+    CO_END(co);
+}
+
+static void bench_probe_task_run(void *pvParameters){
+    uint32_t item;
+
+    for(;;){
+        xQueueReceive(bench_queue,&item,portMAX_DELAY);
+        bench_stamp=cycle_counter_get();
+    }
+}
+
+static void bench_ping_task_run(void *pvParameters){
+    for(;;){
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+        if(++bench_exchanges>=BENCH_COROUTINES*BENCH_ROUNDS){
+            xTaskNotifyGive(bench_handle);
+        }else{
+            xTaskNotifyGive(bench_pong_task);
+        }
+    }
+}
+
+static void bench_pong_task_run(void *pvParameters){
+    for(;;){
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+        if(++bench_exchanges>=BENCH_COROUTINES*BENCH_ROUNDS){
+            xTaskNotifyGive(bench_handle);
+        }else{
+            xTaskNotifyGive(bench_ping_task);
+        }
+    }
+}
+
+void bench_task(void *pvParameters){
+    TaskHandle_t tasks[BENCH_TASKS];
+    size_t before,task_bytes,co_bytes,executor_bytes;
+    uint32_t task_latency=0,co_latency=0,start,co_cycles,task_cycles,item=0;
+    Coroutine_t *cos;
+    uint32_t *rounds;
+
+    bench_handle=xTaskGetCurrentTaskHandle();
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    cycle_counter_init();
+
+    //内存：最小栈的任务，对比协程控制块 + 一个uint32_t上下文
+    before=xPortGetFreeHeapSize();
+    for(uint32_t i=0;i<BENCH_TASKS;i++){
+        xTaskCreate(bench_idle_task,"BenchT",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+1,&tasks[i]);
+    }
+    task_bytes=(before-xPortGetFreeHeapSize())/BENCH_TASKS;
+    for(uint32_t i=0;i<BENCH_TASKS;i++){
+        vTaskDelete(tasks[i]);
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));     //让空闲任务回收被删除任务的内存
+
+    //协程的内存算上执行器任务自己的TCB和栈：所有协程共用这一份
+    before=xPortGetFreeHeapSize();
+    if(CoExecutor_Create(&bench_executor,"BenchCo",tskIDLE_PRIORITY+3,configMINIMAL_STACK_SIZE)!=pdPASS){
+        printf("[性能测试] 创建执行器失败\n");
+        vTaskDelete(NULL);
+    }
+    executor_bytes=before-xPortGetFreeHeapSize();
+    cos=(Coroutine_t*)pvPortMalloc(BENCH_COROUTINES*sizeof(Coroutine_t));
+    rounds=(uint32_t*)pvPortMalloc(BENCH_COROUTINES*sizeof(uint32_t));
+    if(cos==NULL||rounds==NULL){
+        printf("[性能测试] 堆不够%d个协程\n", BENCH_COROUTINES);
+        vTaskDelete(NULL);
+    }
+    co_bytes=before-xPortGetFreeHeapSize();
+
+    //恢复开销：BENCH_COROUTINES个协程轮流让出，对比两个任务互相通知
+    //执行器优先级更高，挂起调度器把所有协程都启动好再放开，否则执行器会在启动过程中抢先把前面的协程跑完，
+    //测到的是"启动一个、跑完一个"，不是BENCH_COROUTINES个协程交替让出
+    memset(rounds,0,BENCH_COROUTINES*sizeof(uint32_t));
+    bench_done=0;
+    vTaskSuspendAll();
+    for(uint32_t i=0;i<BENCH_COROUTINES;i++){
+        Co_Start(&bench_executor,&cos[i],"BenchCo",bench_yield_co,&rounds[i]);
+    }
+    start=cycle_counter_get();
+    xTaskResumeAll();
+    ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+    co_cycles=cycle_counter_get()-start;
+
+    xTaskCreate(bench_ping_task_run,"Ping",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+3,&bench_ping_task);
+    xTaskCreate(bench_pong_task_run,"Pong",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+3,&bench_pong_task);
+    bench_exchanges=0;
+    start=cycle_counter_get();
+    xTaskNotifyGive(bench_ping_task);
+    ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+    task_cycles=cycle_counter_get()-start;
+
+    //恢复延迟：发送方优先级低于接收方，发送后立即被抢占
+    bench_queue=xQueueCreate(4,sizeof(uint32_t));
+    xTaskCreate(bench_probe_task_run,"Probe",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+3,&bench_probe_task);
+    CoQueue_Init(&bench_co_queue,bench_co_queue_storage,sizeof(uint32_t),4);
+    Co_Start(&bench_executor,&bench_probe_co,"Probe",bench_probe_co_run,NULL);
+    vTaskDelay(pdMS_TO_TICKS(10));      //接收方先进入等待
+    for(uint32_t i=0;i<BENCH_LATENCY_ROUNDS;i++){
+        item++;
+        start=cycle_counter_get();
+        xQueueSend(bench_queue,&item,0);
+        task_latency+=bench_stamp-start;
+
+        start=cycle_counter_get();
+        CoQueue_Send(&bench_co_queue,&item);
+        co_latency+=bench_stamp-start;
+    }
+
+    printf("\n[性能测试] 任务与无栈协程对比\n");
+    printf("  每个活动的内存：任务(栈%d字) %lu字节，协程%lu字节（控制块%lu + 上下文%lu + 均摊的执行器）\n",
+           configMINIMAL_STACK_SIZE, (uint32_t)task_bytes, (uint32_t)(co_bytes/BENCH_COROUTINES),
+           (uint32_t)sizeof(Coroutine_t), (uint32_t)sizeof(uint32_t));
+    printf("  %d个协程共%lu字节（含执行器任务%lu字节），同样数量的任务约%lu字节\n", BENCH_COROUTINES,
+           (uint32_t)co_bytes, (uint32_t)executor_bytes, (uint32_t)(task_bytes*BENCH_COROUTINES));
+    printf("  每次恢复：协程%lu %s（%d个协程轮流让出），任务%lu %s（通知切换）\n",
+           co_cycles/(BENCH_COROUTINES*BENCH_ROUNDS), CYCLE_UNIT,
+           BENCH_COROUTINES, task_cycles/(BENCH_COROUTINES*BENCH_ROUNDS), CYCLE_UNIT);
+    printf("  发送到恢复的延迟：协程%lu %s，任务%lu %s\n",
+           co_latency/BENCH_LATENCY_ROUNDS, CYCLE_UNIT, task_latency/BENCH_LATENCY_ROUNDS, CYCLE_UNIT);
+    printf("  基准执行器：恢复%lu次，唤醒%lu次\n", bench_executor.resumes, bench_executor.wakeups);
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    if(CoExecutor_Create(&executor,"CoExec",EXECUTOR_PRIORITY,EXECUTOR_STACK_WORDS)!=pdPASS){
+        printf("执行器创建失败\n");
+        return -1;
+    }
+    CoQueue_Init(&packet_queue,packet_storage,sizeof(Packet_t),8);
+
+    Co_Start(&executor,&timer_control_co,"TimerCtrl",timer_control_co_run,&timer_control_ctx);
+    Co_Start(&executor,&controller_co,"Controller",controller_co_run,&controller_ctx);
+    for(uint8_t i=0;i<3;i++){
+        Co_Start(&executor,&worker_co[i],"Worker",worker_co_run,&worker_ctx[i]);
+    }
+    Co_Start(&executor,&receiver_co,"Receiver",receiver_co_run,&receiver_ctx);
+
+    xTaskCreate(data_sender_task, "Sender", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL);
+    xTaskCreate(bench_task, "Bench", 512, NULL, tskIDLE_PRIORITY+2, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 无栈协程的原理：
+   - CO_BEGIN展开成switch，每个等待宏记下__LINE__后返回，再次调用时case __LINE__跳回等待点
+   - 协程"暂停"时什么都不在栈上，只留下一个行号和context里的状态
+
+2. 内存：
+   - 任务 = TCB + 独立的栈；协程 = 几十字节的控制块 + 自己的上下文
+   - 所有协程共用执行器的栈，栈只按最深的一次恢复来算
+
+3. 执行器：
+   - 延时列表只由执行器访问，按到期时间排序，相同周期时直接接到末尾
+   - 就绪列表整批取下再逐个恢复，一轮只进两次临界段
+   - 被其他任务或中断唤醒时才发通知，协程之间让出/延时不需要上下文切换
+
+4. 和C++20协程对比：
+   - C++20的co_await由编译器生成协程帧，局部变量可以跨等待保留，但需要C++20编译器和帧的分配策略
+   - 这里用C宏，代价是局部变量不能跨等待，要放进context
+
+5. 什么时候仍然用任务：
+   - 需要调用阻塞API的代码（第三方驱动、协议栈）
+   - 计算量大、会长时间占住执行器的工作
+   - 需要比其他协程更高优先级的响应（可以再开一个更高优先级的执行器）
+*/
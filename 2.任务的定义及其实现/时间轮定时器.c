@@ -0,0 +1,861 @@
+/*
+ * Demo: 哈希时间轮软件定时器服务
+ * 学习要点：
+ * 1. 原生定时器服务把活动定时器按到期时间排在有序链表里，
+ *    每条xTimerStart/xTimerReset/xTimerChangePeriod命令在守护任务里都是O(n)的插入
+ * 2. 哈希时间轮：256个槽，定时器按"到期tick & 255"挂到对应槽上，插入/删除都是O(1)
+ * 3. 到期时间超过一圈的定时器也挂在同一个槽里，轮到这个槽时比较到期时间，没到就留着
+ * 4. 批量到期：一个tick到期的定时器先全部摘下来，再依次执行回调
+ * 5. 占用位图：守护任务根据位图找到下一个非空槽，没有定时器到期时不用每个tick都醒来
+ * 6. 命令直接执行：任务在临界段内直接修改时间轮，不经过命令队列，守护任务只负责执行回调
+ * 7. 容差合并：每个定时器可以设置允许推迟的时间，窗口内的到期合并成一次唤醒、一批回调
+ * 8. 性能测试：10000个活动定时器下，与原生定时器对比重置吞吐量、上下文切换次数和守护任务CPU占用；
+ *    混合周期的定时器有/无容差时的唤醒次数
+ *
+ * 对应场景：demo10的5个定时器、看门狗.c的检查定时器、3.临界段中的xUartSimulatorTimer，
+ *          以及每个连接/请求一个超时定时器的服务器场景
+ *
+ * 性能测试需要在FreeRTOSConfig.h中把configTOTAL_HEAP_SIZE调到1MB左右（一万个原生定时器）
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include <stdio.h>
+#include <string.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 时间轮定时器 ====================
+#define WHEEL_SLOTS             256                     //槽数，必须是2的幂
+#define WHEEL_MASK              (WHEEL_SLOTS-1)
+#define WHEEL_BITMAP_WORDS      (WHEEL_SLOTS/32)
+#define WHEEL_BATCH_MAX         64                      //一次收集的到期定时器上限，超出的分多批处理
+#define WHEEL_SLACK_MAX         (WHEEL_SLOTS-1)         //容差不能超过一圈，否则会在上一圈的同一槽被提前收走
+#define WHEEL_DAEMON_STACK      512
+#define WHEEL_DAEMON_PRIORITY   configTIMER_TASK_PRIORITY
+
+struct WheelTimer;
+typedef void (*WheelTimerCallback_t)(struct WheelTimer *timer);
+
+typedef struct WheelTimer{
+    struct WheelTimer *next;            //槽链表
+    struct WheelTimer **pprev;          //指向前一个节点的next（或槽头），O(1)摘除
+    TickType_t deadline;                //名义到期时刻，周期性定时器按它推算下一次，不累积合并带来的偏移
+    TickType_t expiry;                  //合并后实际到期的时刻，deadline<=expiry<=deadline+slack
+    TickType_t period;
+    TickType_t slack;                   //允许推迟的tick数，0表示准时到期
+    uint8_t auto_reload;                //pdTRUE周期性，pdFALSE一次性
+    volatile uint8_t active;
+    const char *name;
+    void *id;
+    WheelTimerCallback_t callback;
+}WheelTimer_t;
+
+typedef enum{
+    WHEEL_OP_START=0,
+    WHEEL_OP_STOP,
+    WHEEL_OP_RESET,
+    WHEEL_OP_CHANGE_PERIOD
+}WheelOp_t;
+
+/*
+ * 时间轮的所有字段（槽、位图、游标、唤醒时刻）都在临界段内修改：
+ * 任务和中断直接在调用者上下文里增删定时器，每次只是几次指针操作；
+ * 守护任务只负责推进游标和执行回调
+ */
+typedef struct{
+    WheelTimer_t *slots[WHEEL_SLOTS];
+    uint32_t bitmap[WHEEL_BITMAP_WORDS];    //非空槽位图
+    TickType_t cursor;                      //已经处理到的tick
+    TickType_t wake_tick;                   //守护任务计划醒来的时刻
+    uint8_t wake_forever;                   //守护任务在无限期等待（没有活动定时器）
+    TaskHandle_t daemon;
+
+    //统计信息
+    uint32_t active_count;
+    uint32_t commands;                      //直接执行的命令数
+    uint32_t daemon_kicks;                  //新到期时刻早于守护任务计划醒来时刻，需要提前唤醒的次数
+    uint32_t lock_cycles_max;               //命令在临界段内的最长时间
+    uint32_t expiries;
+    uint32_t coalesced;                     //因容差被推迟、与其它到期合并的次数
+    uint32_t wakeups_saved;                 //合并节省的唤醒：同一批里名义到期时刻不同的定时器本来各要醒一次
+    uint32_t batches;                       //有定时器到期的处理批次
+    uint32_t max_batch;
+    uint32_t wakeups;                       //守护任务醒来的次数
+    uint64_t busy_cycles;                   //守护任务推进时间轮和执行回调的总时间
+}TimerWheel_t;
+
+static TimerWheel_t timer_wheel;
+
+
+static inline void wheel_bitmap_set(TimerWheel_t *wheel, uint32_t slot){
+    wheel->bitmap[slot>>5]|=1UL<<(slot&31);
+}
+
+static inline void wheel_bitmap_clear(TimerWheel_t *wheel, uint32_t slot){
+    wheel->bitmap[slot>>5]&=~(1UL<<(slot&31));
+}
+
+static inline BaseType_t wheel_bitmap_test(TimerWheel_t *wheel, uint32_t slot){
+    return (wheel->bitmap[slot>>5]>>(slot&31))&1UL;
+}
+
+/**
+ * 挂到到期时刻对应的槽上，O(1)，调用者持有临界段
+ * 到期时刻不晚于游标（已经过期）的，挂到下一个要处理的槽，尽快到期
+ * 返回：定时器实际会被处理的tick
+ */
+static TickType_t wheel_insert(TimerWheel_t *wheel, WheelTimer_t *timer){
+    TickType_t due=timer->expiry;
+    uint32_t slot;
+
+    if((int32_t)(due-wheel->cursor)<=0){
+        due=wheel->cursor+1;
+    }
+    slot=due&WHEEL_MASK;
+
+    timer->next=wheel->slots[slot];
+    timer->pprev=&wheel->slots[slot];
+    if(timer->next!=NULL){
+        timer->next->pprev=&timer->next;
+    }
+    wheel->slots[slot]=timer;
+    wheel_bitmap_set(wheel,slot);
+
+    if(!timer->active){
+        timer->active=pdTRUE;
+        wheel->active_count++;
+    }
+    return due;
+}
+
+//从槽上摘下，O(1)，调用者持有临界段
+static void wheel_remove(TimerWheel_t *wheel, WheelTimer_t *timer){
+    if(!timer->active){
+        return;
+    }
+
+    *timer->pprev=timer->next;
+    if(timer->next!=NULL){
+        timer->next->pprev=timer->pprev;
+    }
+    //pprev指向槽头且槽变空时清位图
+    if(timer->pprev>=&wheel->slots[0]&&timer->pprev<=&wheel->slots[WHEEL_MASK]&&*timer->pprev==NULL){
+        wheel_bitmap_clear(wheel,(uint32_t)(timer->pprev-&wheel->slots[0]));
+    }
+
+    timer->next=NULL;
+    timer->pprev=NULL;
+    timer->active=pdFALSE;
+    wheel->active_count--;
+}
+
+/**
+ * 根据容差计算实际到期时刻，调用者持有临界段
+ * 1. [deadline, deadline+slack]内已经有非空槽：守护任务反正要在那里醒，挂过去一起处理
+ * 2. 否则对齐到窗口内最大的2的幂边界，容差相近的定时器自然落到同一个tick上
+ */
+static void wheel_coalesce(TimerWheel_t *wheel, WheelTimer_t *timer){
+    TickType_t deadline=timer->deadline;
+    TickType_t slack=timer->slack;
+    TickType_t granule;
+
+    timer->expiry=deadline;
+    if(slack==0||(int32_t)(deadline-wheel->cursor)<=0){
+        return;
+    }
+
+    for(TickType_t i=0;i<=slack;i++){
+        if(wheel_bitmap_test(wheel,(deadline+i)&WHEEL_MASK)){
+            timer->expiry=deadline+i;
+            if(i!=0){
+                wheel->coalesced++;
+            }
+            return;
+        }
+    }
+
+    granule=1;
+    while(granule*2<=slack+1){
+        granule*=2;
+    }
+    timer->expiry=(deadline+granule-1)&~(granule-1);
+    if(timer->expiry!=deadline){
+        wheel->coalesced++;
+    }
+}
+
+/**
+ * 执行一条命令，调用者持有临界段
+ * 参数：now 命令发出的时刻，到期时间从这里算起（与原生定时器一致）
+ * 返回：pdTRUE表示新的到期时刻早于守护任务计划醒来的时刻，需要唤醒守护任务重新计算
+ */
+static BaseType_t wheel_apply_locked(TimerWheel_t *wheel, WheelTimer_t *timer, uint8_t op,
+                                     TickType_t value, TickType_t now){
+    TickType_t due;
+
+    wheel_remove(wheel,timer);
+    if(op==WHEEL_OP_STOP){
+        return pdFALSE;
+    }
+    //与原生定时器一致：改周期的同时启动定时器
+    if(op==WHEEL_OP_CHANGE_PERIOD){
+        timer->period=value;
+    }
+    timer->deadline=now+timer->period;
+    wheel_coalesce(wheel,timer);
+    due=wheel_insert(wheel,timer);
+
+    if(wheel->wake_forever||(int32_t)(due-wheel->wake_tick)<0){
+        //提前唤醒一次就够了，后续更晚的命令不用再通知
+        wheel->wake_tick=due;
+        wheel->wake_forever=pdFALSE;
+        wheel->daemon_kicks++;
+        return pdTRUE;
+    }
+    return pdFALSE;
+}
+
+/**
+ * 任务上下文的命令：临界段内直接修改时间轮，不经过命令队列
+ * 只有新到期时刻比守护任务计划的更早时才通知守护任务，其余情况不会发生任务切换
+ */
+static void wheel_command(WheelTimer_t *timer, uint8_t op, TickType_t value){
+    TimerWheel_t *wheel=&timer_wheel;
+    BaseType_t kick;
+    uint32_t start;
+
+    start=cycle_counter_get();
+    taskENTER_CRITICAL();
+    kick=wheel_apply_locked(wheel,timer,op,value,xTaskGetTickCount());
+    wheel->commands++;
+    taskEXIT_CRITICAL();
+    start=cycle_counter_get()-start;
+    if(start>wheel->lock_cycles_max){
+        wheel->lock_cycles_max=start;
+    }
+
+    //回调里发的命令不用通知自己，守护任务执行完这一批回调后会重新计算等待时间
+    if(kick&&xTaskGetCurrentTaskHandle()!=wheel->daemon){
+        xTaskNotifyGive(wheel->daemon);
+    }
+}
+
+/**
+ * 在一个临界段内收集一个槽里已到期的定时器，没到期的（后面几圈的）留着
+ * 周期性定时器立即按周期重新挂入；错过多个周期时跳过，不补调用
+ * 重新挂入时也按容差合并，游标此时还停在当前槽，窗口从下一个tick开始
+ * 返回：收集到的数量，等于WHEEL_BATCH_MAX时槽里可能还有
+ */
+static uint32_t wheel_collect_slot(TimerWheel_t *wheel, uint32_t slot, TickType_t now, WheelTimer_t **batch){
+    WheelTimer_t *timer=wheel->slots[slot];
+    TickType_t deadlines[WHEEL_BATCH_MAX];
+    uint32_t count=0,distinct=0;
+
+    while(timer!=NULL&&count<WHEEL_BATCH_MAX){
+        WheelTimer_t *next=timer->next;
+
+        if((int32_t)(timer->expiry-now)<=0){
+            TickType_t deadline=timer->deadline;
+            uint32_t j=0;
+
+            //统计这一批里不同的名义到期时刻，没有容差时每个都要单独唤醒一次
+            while(j<count&&deadlines[j]!=deadline){
+                j++;
+            }
+            distinct+=(j==count);
+            deadlines[count]=deadline;
+
+            wheel_remove(wheel,timer);
+            if(timer->auto_reload){
+                //按名义到期时刻推算，可能挂回当前槽的链表头，已经走过，不会被重复收集
+                do{
+                    deadline+=timer->period;
+                }while((int32_t)(deadline-now)<=0);
+                timer->deadline=deadline;
+                wheel_coalesce(wheel,timer);
+                wheel_insert(wheel,timer);
+            }
+            batch[count++]=timer;
+        }
+        timer=next;
+    }
+    if(distinct>1){
+        wheel->wakeups_saved+=distinct-1;
+    }
+    return count;
+}
+
+/**
+ * 推进时间轮到now
+ * 功能：临界段内把游标推进到下一个非空槽并收集到期定时器，退出临界段后批量执行回调
+ *      游标逐槽推进，与命令的插入互斥，新插入的定时器不会落进已经走过的槽
+ *      落后超过一圈时只需要扫一圈，因为每个槽都会比较到期时间
+ */
+static void wheel_advance(TimerWheel_t *wheel, TickType_t now){
+    WheelTimer_t *batch[WHEEL_BATCH_MAX];
+
+    taskENTER_CRITICAL();
+    if(now-wheel->cursor>WHEEL_SLOTS){
+        wheel->cursor=now-WHEEL_SLOTS;
+    }
+    taskEXIT_CRITICAL();
+
+    for(;;){
+        uint32_t count=0;
+
+        taskENTER_CRITICAL();
+        if(wheel->cursor==now){
+            taskEXIT_CRITICAL();
+            break;
+        }
+        //空槽直接跳过，最多一圈
+        do{
+            wheel->cursor++;
+        }while(wheel->cursor!=now&&!wheel_bitmap_test(wheel,wheel->cursor&WHEEL_MASK));
+
+        if(wheel_bitmap_test(wheel,wheel->cursor&WHEEL_MASK)){
+            count=wheel_collect_slot(wheel,wheel->cursor&WHEEL_MASK,now,batch);
+            if(count==WHEEL_BATCH_MAX){
+                wheel->cursor--;        //这个槽还没收完，下一轮再来
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if(count>0){
+            wheel->expiries+=count;
+            wheel->batches++;
+            if(count>wheel->max_batch){
+                wheel->max_batch=count;
+            }
+            //全部摘下之后再执行回调，回调里重新启动/停止定时器不会破坏正在遍历的链表
+            for(uint32_t k=0;k<count;k++){
+                batch[k]->callback(batch[k]);
+            }
+        }
+    }
+}
+
+/**
+ * 下一个非空槽距游标的tick数，没有活动定时器返回portMAX_DELAY，调用者持有临界段
+ * 用位图按32位一组查找，最多WHEEL_BITMAP_WORDS+1次
+ */
+static TickType_t wheel_next_delay(TimerWheel_t *wheel){
+    uint32_t start=(wheel->cursor+1)&WHEEL_MASK;
+
+    if(wheel->active_count==0){
+        return portMAX_DELAY;
+    }
+
+    for(uint32_t scanned=0;scanned<=WHEEL_SLOTS;){
+        uint32_t slot=(start+scanned)&WHEEL_MASK;
+        uint32_t bits=wheel->bitmap[slot>>5]>>(slot&31);
+
+        if(bits!=0){
+            return (TickType_t)(scanned+__builtin_ctz(bits)+1);
+        }
+        scanned+=32-(slot&31);
+    }
+    return WHEEL_SLOTS;
+}
+
+
+/**
+ * 时间轮守护任务
+ * 1. 推进时间轮，批量执行到期回调
+ * 2. 记下计划醒来的时刻，阻塞在任务通知上，超时时间就是到下一个非空槽的距离
+ * 3. 命令发现新定时器比计划醒来的时刻更早到期时才通知，否则守护任务一直睡到槽到期
+ */
+static void wheel_daemon_task(void *pvParameters){
+    TimerWheel_t *wheel=(TimerWheel_t*)pvParameters;
+
+    for(;;){
+        TickType_t delay,now;
+        uint32_t start;
+
+        start=cycle_counter_get();
+        wheel_advance(wheel,xTaskGetTickCount());
+        wheel->busy_cycles+=cycle_counter_get()-start;
+
+        taskENTER_CRITICAL();
+        delay=wheel_next_delay(wheel);
+        if(delay==portMAX_DELAY){
+            wheel->wake_forever=pdTRUE;
+        }else{
+            wheel->wake_forever=pdFALSE;
+            wheel->wake_tick=wheel->cursor+delay;
+            //执行回调花掉的时间从等待时间里扣除
+            now=xTaskGetTickCount();
+            delay=((int32_t)(wheel->wake_tick-now)>0)?(wheel->wake_tick-now):0;
+        }
+        taskEXIT_CRITICAL();
+
+        //计划醒来的时刻已经登记，期间到来的通知会让这里立即返回，不会丢失
+        ulTaskNotifyTake(pdTRUE,delay);
+        wheel->wakeups++;
+    }
+}
+
+
+/**
+ * 初始化时间轮并创建守护任务
+ * 返回：pdPASS成功
+ */
+BaseType_t TimerWheel_Init(void){
+    memset(&timer_wheel,0,sizeof(timer_wheel));
+    timer_wheel.cursor=xTaskGetTickCount();
+    timer_wheel.wake_forever=pdTRUE;
+
+    return xTaskCreate(wheel_daemon_task,"TmrWheel",WHEEL_DAEMON_STACK,&timer_wheel,
+                       WHEEL_DAEMON_PRIORITY,&timer_wheel.daemon);
+}
+
+/**
+ * 初始化定时器（相当于xTimerCreate，存储由调用者提供）
+ */
+void WheelTimer_Init(WheelTimer_t *timer, const char *name, TickType_t period,
+                     BaseType_t auto_reload, void *id, WheelTimerCallback_t callback){
+    configASSERT(period>0);     //周期为0时自动重载会在临界段里死循环，与xTimerCreate一样不允许
+    memset(timer,0,sizeof(WheelTimer_t));
+    timer->name=name;
+    timer->period=period;
+    timer->auto_reload=(uint8_t)(auto_reload?pdTRUE:pdFALSE);
+    timer->id=id;
+    timer->callback=callback;
+}
+
+/*
+ * 以下命令在调用者上下文里立即生效，不会阻塞，也没有"命令队列满"的失败，
+ * 所以不再需要原生API的xTicksToWait参数
+ */
+void WheelTimer_Start(WheelTimer_t *timer){
+    wheel_command(timer,WHEEL_OP_START,0);
+}
+
+void WheelTimer_Stop(WheelTimer_t *timer){
+    wheel_command(timer,WHEEL_OP_STOP,0);
+}
+
+void WheelTimer_Reset(WheelTimer_t *timer){
+    wheel_command(timer,WHEEL_OP_RESET,0);
+}
+
+void WheelTimer_ChangePeriod(WheelTimer_t *timer, TickType_t new_period){
+    configASSERT(new_period>0);
+    wheel_command(timer,WHEEL_OP_CHANGE_PERIOD,new_period);
+}
+
+/**
+ * 设置容差：允许定时器最多推迟slack个tick，与附近的到期合并成一次唤醒
+ * 下一次启动/重置/周期到期时生效；需要准时的（如超时检测）保持0
+ */
+void WheelTimer_SetSlack(WheelTimer_t *timer, TickType_t slack){
+    taskENTER_CRITICAL();
+    timer->slack=(slack>WHEEL_SLACK_MAX)?WHEEL_SLACK_MAX:slack;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * 在中断中重置定时器（如串口接收超时）
+ */
+void WheelTimer_ResetFromISR(WheelTimer_t *timer, BaseType_t *pxHigherPriorityTaskWoken){
+    TimerWheel_t *wheel=&timer_wheel;
+    UBaseType_t saved;
+    BaseType_t kick;
+
+    saved=taskENTER_CRITICAL_FROM_ISR();
+    kick=wheel_apply_locked(wheel,timer,WHEEL_OP_RESET,0,xTaskGetTickCountFromISR());
+    wheel->commands++;
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    if(kick){
+        vTaskNotifyGiveFromISR(wheel->daemon,pxHigherPriorityTaskWoken);
+    }
+}
+
+static inline BaseType_t WheelTimer_IsActive(WheelTimer_t *timer){
+    return timer->active;
+}
+
+
+// ==================== demo10的定时器 ====================
+#define LED_TIMER_ID        1  // LED定时器标识
+#define ONESHOT_TIMER_ID    2  // 一次性定时器标识
+#define TIMEOUT_TIMER_ID    3  // 超时定时器标识
+#define PERIODIC_TIMER_ID   4  // 周期性定时器标识
+#define DYNAMIC_TIMER_ID    5  // 动态定时器标识
+#define WATCHDOG_TIMER_ID   6  // 看门狗检查定时器标识
+
+static WheelTimer_t led_timer;
+static WheelTimer_t oneshot_timer;
+static WheelTimer_t timeout_timer;
+static WheelTimer_t periodic_timer;
+static WheelTimer_t dynamic_timer;
+static WheelTimer_t watchdog_timer;
+
+volatile uint32_t led_state=0;
+volatile uint32_t periodic_counter=0;
+volatile uint32_t timeout_flag=0;
+volatile uint32_t watchdog_checks=0;
+
+void led_timer_callback(WheelTimer_t *timer){
+    led_state=!led_state;
+}
+
+void oneshot_timer_callback(WheelTimer_t *timer){
+    printf("[一次性定时器] 5秒延时任务完成\n");
+}
+
+void timeout_timer_callback(WheelTimer_t *timer){
+    timeout_flag=1;
+    printf("[超时定时器] 数据发送超时！\n");
+}
+
+void periodic_data_callback(WheelTimer_t *timer){
+    periodic_counter++;
+    if(periodic_counter%10==0){
+        printf("[数据采集]生成第%lu份数据报告\n", periodic_counter/10);
+    }
+}
+
+void dynamic_timer_callback(WheelTimer_t *timer){
+    static uint32_t dynamic_counter=0;
+    static const uint16_t periods_ms[3]={1000,2000,3000};
+
+    dynamic_counter++;
+    if(dynamic_counter%5==0){
+        //在回调里直接改周期，立即生效
+        WheelTimer_ChangePeriod(timer,pdMS_TO_TICKS(periods_ms[(dynamic_counter/5)%3]));
+    }
+}
+
+//看门狗.c中的检查定时器：只要求大约每秒检查一次
+void watchdog_check_callback(WheelTimer_t *timer){
+    watchdog_checks++;
+}
+
+/**
+ * 数据发送任务：每个数据包重置一次超时定时器
+ * 重置在本任务里直接完成，超时定时器比守护任务计划醒来的时刻晚，不会唤醒守护任务
+ */
+void data_sender_task(void *pvParameters){
+    uint32_t send_counter=0;
+
+    WheelTimer_Start(&timeout_timer);
+
+    for(;;){
+        send_counter++;
+        WheelTimer_Reset(&timeout_timer);
+        timeout_flag=0;
+
+        //模拟不同的数据发送时间（2-9秒）
+        vTaskDelay(pdMS_TO_TICKS(2000+(send_counter%8)*1000));
+
+        if(!timeout_flag){
+            WheelTimer_Stop(&timeout_timer);
+        }
+        vTaskDelay(pdMS_TO_TICKS(3000));
+        WheelTimer_Start(&timeout_timer);
+    }
+}
+
+void timer_monitor_task(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(10000));
+
+        printf("\n=== 时间轮状态 ===\n");
+        printf("活动定时器: %lu，LED: %s，采集次数: %lu\n",
+               timer_wheel.active_count, led_state?"ON":"OFF", periodic_counter);
+        printf("命令: %lu条（提前唤醒守护任务%lu次），到期: %lu次/%lu批，守护任务醒来: %lu次\n",
+               timer_wheel.commands, timer_wheel.daemon_kicks,
+               timer_wheel.expiries, timer_wheel.batches, timer_wheel.wakeups);
+        printf("容差合并: %lu次，节省唤醒: %lu次，看门狗检查: %lu次\n",
+               timer_wheel.coalesced, timer_wheel.wakeups_saved, watchdog_checks);
+    }
+}
+
+
+// ==================== 性能测试 ====================
+/*
+ * 上下文切换次数需要在FreeRTOSConfig.h中挂上跟踪宏：
+ *   extern volatile uint32_t context_switch_count;
+ *   #define traceTASK_SWITCHED_IN()  context_switch_count++
+ * 没有挂时切换次数一栏为0
+ */
+#define BENCH_TIMERS            10000   //活动定时器数量
+#define BENCH_COMMANDS          10000   //测量的重置命令数
+#define BENCH_BURST             1000    //高优先级突发重置的命令数
+#define BENCH_LOAD_MS           2000    //CPU占用测量窗口
+#define BENCH_MIXED_TIMERS      200     //合并测试的混合周期定时器数量
+#define BENCH_MIXED_MS          5000    //合并测试的测量窗口
+
+volatile uint32_t context_switch_count=0;
+
+static WheelTimer_t bench_wheel_timers[BENCH_TIMERS];
+static TimerHandle_t bench_native_timers[BENCH_TIMERS];
+static volatile uint32_t bench_expired;
+static volatile uint32_t bench_idle_loops;
+static TaskHandle_t bench_task_handle;
+
+static void bench_wheel_callback(WheelTimer_t *timer){
+    bench_expired++;
+}
+
+static void bench_native_callback(TimerHandle_t timer){
+    bench_expired++;
+}
+
+static void bench_native_sync(void *param, uint32_t value){
+    xTaskNotifyGive(bench_task_handle);
+}
+
+//等待原生定时器服务处理完之前发出的所有命令
+static void bench_native_drain(void){
+    xTimerPendFunctionCall(bench_native_sync,NULL,0,portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+}
+
+static uint32_t bench_rand(void){
+    static uint32_t state=0x12345678;
+    state^=state<<13;
+    state^=state>>17;
+    state^=state<<5;
+    return state;
+}
+
+/**
+ * 最低优先级的空转任务：单位时间内的空转次数反映了剩余CPU
+ * CPU占用 = 1 - 负载下空转次数/空载时空转次数
+ */
+void bench_idle_counter_task(void *pvParameters){
+    for(;;){
+        bench_idle_loops++;
+    }
+}
+
+static uint32_t bench_measure_idle(void){
+    uint32_t start=bench_idle_loops;
+    vTaskDelay(pdMS_TO_TICKS(BENCH_LOAD_MS));
+    return bench_idle_loops-start;
+}
+
+/**
+ * 混合周期的定时器（50ms~1s的几档周期加上随机偏移）运行BENCH_MIXED_MS，
+ * 统计期间守护任务醒来次数、上下文切换次数和到期次数
+ * 参数：slack_div 容差=周期/slack_div，0表示不设容差
+ */
+static void bench_mixed_run(uint32_t slack_div){
+    static const uint16_t periods_ms[6]={50,100,200,250,500,1000};
+    uint32_t wakeups,switches,expired,saved;
+
+    for(uint32_t i=0;i<BENCH_MIXED_TIMERS;i++){
+        TickType_t period=pdMS_TO_TICKS(periods_ms[i%6]+bench_rand()%20);
+        WheelTimer_Init(&bench_wheel_timers[i],"Mixed",period,pdTRUE,NULL,bench_wheel_callback);
+        WheelTimer_SetSlack(&bench_wheel_timers[i],slack_div?period/slack_div:0);
+    }
+    for(uint32_t i=0;i<BENCH_MIXED_TIMERS;i++){
+        WheelTimer_Start(&bench_wheel_timers[i]);
+        if(i%20==19){
+            vTaskDelay(1);          //错开启动相位
+        }
+    }
+
+    wakeups=timer_wheel.wakeups;
+    switches=context_switch_count;
+    saved=timer_wheel.wakeups_saved;
+    bench_expired=0;
+    vTaskDelay(pdMS_TO_TICKS(BENCH_MIXED_MS));
+    expired=bench_expired;
+    wakeups=timer_wheel.wakeups-wakeups;
+    switches=context_switch_count-switches;
+    saved=timer_wheel.wakeups_saved-saved;
+
+    for(uint32_t i=0;i<BENCH_MIXED_TIMERS;i++){
+        WheelTimer_Stop(&bench_wheel_timers[i]);
+    }
+
+    if(slack_div){
+        printf("  容差=周期/%-4lu%8lu  %10lu  %8lu  %8lu\n", slack_div, wakeups, switches, expired, saved);
+    }else{
+        printf("  无容差       %8lu  %10lu  %8lu  %8lu\n", wakeups, switches, expired, saved);
+    }
+}
+
+/**
+ * 基准测试任务（优先级低于守护任务）
+ * 1. 重置吞吐量：10000个活动定时器时，连续BENCH_COMMANDS次重置直到全部生效的平均耗时和上下文切换次数
+ * 2. 突发：临时提到守护任务之上，xTicksToWait=0连发BENCH_BURST次重置，统计失败次数
+ * 3. CPU占用：10000个周期200~2000ms的定时器持续到期时，守护任务占用的CPU
+ */
+void bench_task(void *pvParameters){
+    uint32_t start,switches;
+    uint32_t wheel_cmd,native_cmd,wheel_switches,native_switches;
+    uint32_t native_failed=0;
+    uint32_t idle_base,idle_wheel,idle_native;
+    uint32_t wheel_expired,native_expired;
+    UBaseType_t base_priority=uxTaskPriorityGet(NULL);
+
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    cycle_counter_init();
+
+    printf("\n[性能测试] %d个活动定时器（%s）\n", BENCH_TIMERS, CYCLE_UNIT);
+    idle_base=bench_measure_idle();
+
+    //---------- 时间轮 ----------
+    for(uint32_t i=0;i<BENCH_TIMERS;i++){
+        WheelTimer_Init(&bench_wheel_timers[i],"Bench",pdMS_TO_TICKS(200+bench_rand()%1800),
+                        pdTRUE,NULL,bench_wheel_callback);
+        WheelTimer_Start(&bench_wheel_timers[i]);
+    }
+
+    bench_expired=0;
+    idle_wheel=bench_measure_idle();
+    wheel_expired=bench_expired;
+
+    //命令返回时已经生效，不需要等守护任务
+    switches=context_switch_count;
+    start=cycle_counter_get();
+    for(uint32_t i=0;i<BENCH_COMMANDS;i++){
+        WheelTimer_Reset(&bench_wheel_timers[bench_rand()%BENCH_TIMERS]);
+    }
+    wheel_cmd=(cycle_counter_get()-start)/BENCH_COMMANDS;
+    wheel_switches=context_switch_count-switches;
+
+    for(uint32_t i=0;i<BENCH_TIMERS;i++){
+        WheelTimer_Stop(&bench_wheel_timers[i]);
+    }
+
+    //---------- 原生定时器 ----------
+    for(uint32_t i=0;i<BENCH_TIMERS;i++){
+        bench_native_timers[i]=xTimerCreate("Bench",pdMS_TO_TICKS(200+bench_rand()%1800),
+                                            pdTRUE,NULL,bench_native_callback);
+        if(bench_native_timers[i]==NULL){
+            printf("原生定时器创建失败（%lu个），请增大configTOTAL_HEAP_SIZE\n", i);
+            vTaskDelete(NULL);
+        }
+        xTimerStart(bench_native_timers[i],portMAX_DELAY);
+    }
+    bench_native_drain();
+
+    bench_expired=0;
+    idle_native=bench_measure_idle();
+    native_expired=bench_expired;
+
+    //守护任务优先级更高，每条命令入队后立即切换过去处理
+    switches=context_switch_count;
+    start=cycle_counter_get();
+    for(uint32_t i=0;i<BENCH_COMMANDS;i++){
+        xTimerReset(bench_native_timers[bench_rand()%BENCH_TIMERS],portMAX_DELAY);
+    }
+    bench_native_drain();
+    native_cmd=(cycle_counter_get()-start)/BENCH_COMMANDS;
+    native_switches=context_switch_count-switches;
+
+    //高于守护任务时命令只能排队，队列满了就失败
+    vTaskPrioritySet(NULL,configTIMER_TASK_PRIORITY+1);
+    for(uint32_t i=0;i<BENCH_BURST;i++){
+        if(xTimerReset(bench_native_timers[bench_rand()%BENCH_TIMERS],0)!=pdPASS){
+            native_failed++;
+        }
+    }
+    vTaskPrioritySet(NULL,base_priority);
+    bench_native_drain();
+
+    for(uint32_t i=0;i<BENCH_TIMERS;i++){
+        xTimerDelete(bench_native_timers[i],portMAX_DELAY);
+    }
+
+    printf("  后端        重置耗时  上下文切换  突发失败  %dms内到期  守护任务CPU\n", BENCH_LOAD_MS);
+    printf("  时间轮直接  %8lu  %10lu  %8lu  %10lu  %9lu%%\n", wheel_cmd, wheel_switches, 0UL,
+           wheel_expired, 100-idle_wheel*100/(idle_base?idle_base:1));
+    printf("  原生命令队列%8lu  %10lu  %8lu  %10lu  %9lu%%\n", native_cmd, native_switches, native_failed,
+           native_expired, 100-idle_native*100/(idle_base?idle_base:1));
+    printf("  时间轮命令最长临界段%lu，提前唤醒守护任务%lu次，最大批次%lu\n",
+           timer_wheel.lock_cycles_max, timer_wheel.daemon_kicks, timer_wheel.max_batch);
+
+    printf("\n[合并测试] %d个混合周期定时器，%dms内\n", BENCH_MIXED_TIMERS, BENCH_MIXED_MS);
+    printf("  设置          唤醒次数  上下文切换  到期次数  节省唤醒\n");
+    bench_mixed_run(0);
+    bench_mixed_run(20);
+    bench_mixed_run(10);
+    bench_mixed_run(4);
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 哈希时间轮定时器\n");
+
+    if(TimerWheel_Init()!=pdPASS){
+        printf("时间轮初始化失败\n");
+        return -1;
+    }
+
+    WheelTimer_Init(&led_timer,"LEDTimer",pdMS_TO_TICKS(500),pdTRUE,(void*)LED_TIMER_ID,led_timer_callback);
+    WheelTimer_Init(&oneshot_timer,"OneshotTimer",pdMS_TO_TICKS(5000),pdFALSE,(void*)ONESHOT_TIMER_ID,oneshot_timer_callback);
+    WheelTimer_Init(&timeout_timer,"TimeoutTimer",pdMS_TO_TICKS(7000),pdFALSE,(void*)TIMEOUT_TIMER_ID,timeout_timer_callback);
+    WheelTimer_Init(&periodic_timer,"PeriodicTimer",pdMS_TO_TICKS(2000),pdTRUE,(void*)PERIODIC_TIMER_ID,periodic_data_callback);
+    WheelTimer_Init(&dynamic_timer,"DynamicTimer",pdMS_TO_TICKS(1000),pdTRUE,(void*)DYNAMIC_TIMER_ID,dynamic_timer_callback);
+    WheelTimer_Init(&watchdog_timer,"WatchdogTimer",pdMS_TO_TICKS(1000),pdTRUE,(void*)WATCHDOG_TIMER_ID,watchdog_check_callback);
+
+    //LED闪烁、数据采集和看门狗检查不要求准时，超时检测保持准时
+    WheelTimer_SetSlack(&led_timer,pdMS_TO_TICKS(50));
+    WheelTimer_SetSlack(&periodic_timer,pdMS_TO_TICKS(200));
+    WheelTimer_SetSlack(&dynamic_timer,pdMS_TO_TICKS(100));
+    WheelTimer_SetSlack(&watchdog_timer,pdMS_TO_TICKS(100));
+
+    //调度器启动前直接挂到时间轮上，守护任务第一次运行时计算等待时间
+    WheelTimer_Start(&led_timer);
+    WheelTimer_Start(&oneshot_timer);
+    WheelTimer_Start(&periodic_timer);
+    WheelTimer_Start(&dynamic_timer);
+    WheelTimer_Start(&watchdog_timer);
+
+    xTaskCreate(data_sender_task, "DataSender", 256, NULL, 2, NULL);
+    xTaskCreate(timer_monitor_task, "TimerMon", 512, NULL, 1, NULL);
+
+    xTaskCreate(bench_idle_counter_task, "IdleCnt", 128, NULL, tskIDLE_PRIORITY, NULL);
+    xTaskCreate(bench_task, "Bench", 512, NULL, 2, &bench_task_handle);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 有序链表的问题：
+   - 插入时要找到位置，n个活动定时器平均比较n/2次
+   - 每个连接/请求一个超时定时器时，每次重置都在守护任务里遍历上千个节点
+
+2. 哈希时间轮：
+   - 到期tick的低8位决定槽号，插入就是挂到槽链表头
+   - 双向链表（pprev）让停止/重置也是O(1)
+   - 超过一圈的定时器与本圈的混在同一个槽里，处理槽时比较到期时间区分
+
+3. 命令直接执行：
+   - 插入/摘除只是几次指针操作，放在临界段里比发命令、切换到守护任务再切回来便宜得多
+   - 守护任务登记计划醒来的时刻，只有更早的到期才需要通知它，其余命令不引起任务切换
+   - 没有命令队列，也就没有"队列满、xTicksToWait=0时命令丢失"的问题
+   - 游标在临界段内逐槽推进，命令不会把定时器挂进已经走过的槽
+
+4. 批量到期：
+   - 临界段内把一个槽里到期的定时器全部摘下来，退出临界段后再逐个执行回调
+   - 临界段长度由WHEEL_BATCH_MAX限制，回调本身不在临界段里
+
+5. 容差合并：
+   - 窗口内已有非空槽就挂过去，守护任务本来就要在那里醒
+   - 否则对齐到2的幂边界，容差相近的定时器落到同一tick
+   - 周期性定时器按名义到期时刻推算下一次，合并带来的推迟不会累积成漂移
+   - 容差不能超过一圈（WHEEL_SLACK_MAX），超时检测这类定时器保持0
+
+6. 与原生定时器保持一致的语义：
+   - 到期时间从命令发出的时刻算起
+   - 改周期同时启动定时器；周期性定时器错过的周期不补调用
+   - 已经摘下等待回调的定时器被停止时，这一次回调仍会执行（原生定时器同样如此）
+*/
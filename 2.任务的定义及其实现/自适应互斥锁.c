@@ -0,0 +1,610 @@
+/*
+ * Demo: 先自旋后阻塞的自适应互斥锁（带传递式优先级继承）
+ * 学习要点：
+ * 1. 临界区很短时，阻塞+唤醒的开销比临界区本身还大
+ * 2. 多核（SMP）上，持有者正在另一个核上运行时，先自旋一小会儿往往就能拿到锁
+ * 3. 自旋预算是自适应的：根据最近的持锁时间（指数滑动平均）动态调整
+ * 4. 持有者没在运行（或单核）时自旋没有意义，直接阻塞
+ * 5. 传递式优先级继承：H等M持有的锁，M又在等L持有的锁，L也要被提升到H的优先级
+ * 6. 解锁时直接把锁交给优先级最高的等待者（handoff），避免被其他任务插队
+ * 7. 2~16个竞争者下与xSemaphoreCreateMutex()对比交接延迟和吞吐量
+ *
+ * 需要在FreeRTOSConfig.h中设置：
+ *   #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 1   （至少1个）
+ *   #define configTASK_NOTIFICATION_ARRAY_ENTRIES   2   （至少2个）
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdio.h>
+#include <string.h>
+#include "../cycle_counter.h"
+
+#if (configNUM_THREAD_LOCAL_STORAGE_POINTERS < 1) || (configTASK_NOTIFICATION_ARRAY_ENTRIES < 2)
+    #error "本demo需要线程本地存储指针和至少2个任务通知槽"
+#endif
+
+
+// ==================== 自适应互斥锁 ====================
+#define MUTEX_TLS_INDEX         0       //线程本地存储：任务的锁信息
+#define MUTEX_NOTIFY_INDEX      (configTASK_NOTIFICATION_ARRAY_ENTRIES-1)  //交接通知用的槽
+#define MUTEX_MAX_CHAIN         8       //优先级继承最多沿链传递的层数
+#define MUTEX_SPIN_MIN          200     //自旋预算下限（周期）
+#define MUTEX_SPIN_MAX          20000   //自旋预算上限（周期），大约是一次阻塞+唤醒的开销
+#define MUTEX_EWMA_SHIFT        3       //持锁时间滑动平均系数：1/8
+
+struct AdaptiveMutex;
+
+//等待节点：放在等待任务自己的栈上，不需要动态分配
+typedef struct MutexWaiter{
+    TaskHandle_t task;
+    UBaseType_t priority;           //等待者当前的有效优先级（可能被继承提升）
+    struct MutexWaiter *next;       //按优先级从高到低排序
+}MutexWaiter_t;
+
+//每个任务的锁信息（通过线程本地存储指针挂在TCB上）
+typedef struct{
+    UBaseType_t base_priority;          //未继承时的优先级
+    struct AdaptiveMutex *blocked_on;   //正在等待的锁（用于沿链传递继承）
+    MutexWaiter_t *waiter;              //正在等待时的等待节点
+    struct AdaptiveMutex *held;         //持有的锁链表（解锁时重新计算继承优先级）
+}MutexTaskInfo_t;
+
+typedef struct AdaptiveMutex{
+    volatile TaskHandle_t owner;        //持有者，NULL表示空闲
+    struct AdaptiveMutex *next_held;    //持有者的"已持有锁"链表
+    MutexWaiter_t *waiters;             //等待者链表（按优先级排序）
+    uint32_t acquire_cycle;             //本次加锁的时刻
+    uint32_t hold_ewma;                 //持锁时间的指数滑动平均
+    volatile uint32_t release_cycle;    //最近一次解锁的时刻（测交接延迟）
+
+    //统计信息
+    uint32_t fast_acquires;             //直接拿到
+    uint32_t spin_acquires;             //自旋后拿到
+    uint32_t block_acquires;            //阻塞后拿到（含交接）
+    uint32_t spin_failures;             //自旋超出预算后转入阻塞
+    uint32_t timeouts;                  //等待超时
+}AdaptiveMutex_t;
+
+
+/**
+ * 获取任务的锁信息，第一次使用时分配
+ */
+static MutexTaskInfo_t *mutex_task_info(TaskHandle_t task){
+    MutexTaskInfo_t *info=pvTaskGetThreadLocalStoragePointer(task,MUTEX_TLS_INDEX);
+
+    if(info==NULL){
+        info=pvPortMalloc(sizeof(MutexTaskInfo_t));
+        configASSERT(info!=NULL);
+        memset(info,0,sizeof(MutexTaskInfo_t));
+        info->base_priority=uxTaskPriorityGet(task);
+        vTaskSetThreadLocalStoragePointer(task,MUTEX_TLS_INDEX,info);
+    }
+    return info;
+}
+
+
+void AdaptiveMutex_Init(AdaptiveMutex_t *mutex){
+    memset(mutex,0,sizeof(AdaptiveMutex_t));
+    mutex->hold_ewma=MUTEX_SPIN_MIN;
+}
+
+
+//把等待节点按优先级插入（同优先级先来先得），调用者负责临界段
+static void waiter_insert(AdaptiveMutex_t *mutex, MutexWaiter_t *waiter){
+    MutexWaiter_t **pp=&mutex->waiters;
+
+    while(*pp!=NULL&&(*pp)->priority>=waiter->priority){
+        pp=&(*pp)->next;
+    }
+    waiter->next=*pp;
+    *pp=waiter;
+}
+
+static void waiter_remove(AdaptiveMutex_t *mutex, MutexWaiter_t *waiter){
+    MutexWaiter_t **pp=&mutex->waiters;
+
+    while(*pp!=NULL&&*pp!=waiter){
+        pp=&(*pp)->next;
+    }
+    if(*pp!=NULL){
+        *pp=waiter->next;
+    }
+}
+
+
+//记录"任务持有了这把锁"，调用者负责临界段
+static void mutex_take_ownership(AdaptiveMutex_t *mutex, TaskHandle_t task, MutexTaskInfo_t *info){
+    mutex->owner=task;
+    mutex->next_held=info->held;
+    info->held=mutex;
+    mutex->acquire_cycle=cycle_counter_get();
+}
+
+
+/**
+ * 重新计算任务的有效优先级 = max(基础优先级, 所持有的每把锁上最高的等待者优先级)
+ * 调用者负责临界段
+ */
+static void mutex_update_priority(TaskHandle_t task){
+    MutexTaskInfo_t *info=mutex_task_info(task);
+    UBaseType_t priority=info->base_priority;
+
+    for(AdaptiveMutex_t *m=info->held;m!=NULL;m=m->next_held){
+        if(m->waiters!=NULL&&m->waiters->priority>priority){
+            priority=m->waiters->priority;
+        }
+    }
+
+    if(uxTaskPriorityGet(task)!=priority){
+        vTaskPrioritySet(task,priority);
+    }
+}
+
+
+/**
+ * 传递式优先级继承
+ * 从mutex的持有者开始沿"持有者正在等待的锁"向下传递，
+ * 链上每个持有者都提升到priority，直到遇到已经不低于priority的任务或链结束
+ * 调用者负责临界段
+ */
+static void mutex_propagate_priority(AdaptiveMutex_t *mutex, UBaseType_t priority){
+    for(uint32_t depth=0;mutex!=NULL&&depth<MUTEX_MAX_CHAIN;depth++){
+        TaskHandle_t owner=mutex->owner;
+        MutexTaskInfo_t *info;
+
+        if(owner==NULL||uxTaskPriorityGet(owner)>=priority){
+            break;
+        }
+
+        vTaskPrioritySet(owner,priority);
+
+        //持有者自己也在等锁：更新它在那把锁等待队列里的位置，再继续往下传
+        info=mutex_task_info(owner);
+        mutex=info->blocked_on;
+        if(mutex!=NULL){
+            waiter_remove(mutex,info->waiter);
+            info->waiter->priority=priority;
+            waiter_insert(mutex,info->waiter);
+        }
+    }
+}
+
+
+//自旋有没有意义：只有多核且持有者正在另一个核上运行时才值得自旋
+static inline BaseType_t mutex_should_spin(AdaptiveMutex_t *mutex){
+#if (configNUMBER_OF_CORES > 1)
+    TaskHandle_t owner=mutex->owner;
+    return (owner!=NULL&&eTaskGetState(owner)==eRunning)?pdTRUE:pdFALSE;
+#else
+    (void)mutex;
+    return pdFALSE;     //单核：自旋期间持有者根本不会运行
+#endif
+}
+
+//自旋预算：最近平均持锁时间的2倍，限制在[MIN, MAX]之间
+static inline uint32_t mutex_spin_budget(AdaptiveMutex_t *mutex){
+    uint32_t budget=mutex->hold_ewma*2;
+
+    if(budget<MUTEX_SPIN_MIN) budget=MUTEX_SPIN_MIN;
+    if(budget>MUTEX_SPIN_MAX) budget=MUTEX_SPIN_MAX;
+    return budget;
+}
+
+//在临界段内尝试加锁
+static BaseType_t mutex_try_acquire(AdaptiveMutex_t *mutex, TaskHandle_t self, MutexTaskInfo_t *info){
+    BaseType_t acquired=pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if(mutex->owner==NULL){
+            mutex_take_ownership(mutex,self,info);
+            acquired=pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return acquired;
+}
+
+
+/**
+ * 加锁
+ * 功能：1.锁空闲直接拿；2.持有者在运行则按预算自旋；3.否则排队阻塞并做优先级继承
+ * 参数：timeout - 最长等待时间
+ * 返回：pdPASS成功，pdFAIL超时
+ */
+BaseType_t AdaptiveMutex_Lock(AdaptiveMutex_t *mutex, TickType_t timeout){
+    TaskHandle_t self=xTaskGetCurrentTaskHandle();
+    MutexTaskInfo_t *info=mutex_task_info(self);
+    MutexWaiter_t waiter;
+    TickType_t start_tick;
+
+    configASSERT(mutex->owner!=self);   //不支持递归加锁
+
+    //1. 快速路径
+    if(mutex_try_acquire(mutex,self,info)==pdTRUE){
+        mutex->fast_acquires++;
+        return pdPASS;
+    }
+
+    //2. 自旋阶段：只读轮询，不关中断
+    if(timeout!=0&&mutex_should_spin(mutex)==pdTRUE){
+        uint32_t budget=mutex_spin_budget(mutex);
+        uint32_t spin_start=cycle_counter_get();
+
+        while(cycle_counter_get()-spin_start<budget){
+            if(mutex->owner==NULL&&mutex_try_acquire(mutex,self,info)==pdTRUE){
+                mutex->spin_acquires++;
+                return pdPASS;
+            }
+            if(mutex_should_spin(mutex)==pdFALSE){
+                break;      //持有者被切出去了，继续自旋没有意义
+            }
+        }
+        mutex->spin_failures++;
+    }
+
+    if(timeout==0){
+        return pdFAIL;
+    }
+
+    //3. 阻塞阶段：排队、继承、等待交接通知
+    start_tick=xTaskGetTickCount();
+    waiter.task=self;
+    waiter.priority=uxTaskPriorityGet(self);
+
+    taskENTER_CRITICAL();
+    {
+        if(mutex->owner==NULL){
+            //在进入临界段前刚好被释放
+            mutex_take_ownership(mutex,self,info);
+            taskEXIT_CRITICAL();
+            mutex->fast_acquires++;
+            return pdPASS;
+        }
+        waiter_insert(mutex,&waiter);
+        info->blocked_on=mutex;
+        info->waiter=&waiter;
+        mutex_propagate_priority(mutex,waiter.priority);
+    }
+    taskEXIT_CRITICAL();
+
+    for(;;){
+        TickType_t elapsed=xTaskGetTickCount()-start_tick;
+        TickType_t remaining=(timeout==portMAX_DELAY)?portMAX_DELAY:
+                             (elapsed>=timeout?0:timeout-elapsed);
+
+        ulTaskNotifyTakeIndexed(MUTEX_NOTIFY_INDEX,pdTRUE,remaining);
+
+        //解锁方在临界段里把owner设为我们，再发通知
+        if(mutex->owner==self){
+            mutex->block_acquires++;
+            return pdPASS;
+        }
+
+        if(remaining==0||(timeout!=portMAX_DELAY&&xTaskGetTickCount()-start_tick>=timeout)){
+            break;
+        }
+        //过期的通知，继续等
+    }
+
+    //超时：退出等待队列，持有者不再需要为我们保持高优先级
+    taskENTER_CRITICAL();
+    {
+        if(mutex->owner==self){
+            //超时判断和交接撞在一起，交接优先
+            taskEXIT_CRITICAL();
+            ulTaskNotifyValueClearIndexed(NULL,MUTEX_NOTIFY_INDEX,0xFFFFFFFF);
+            mutex->block_acquires++;
+            return pdPASS;
+        }
+        waiter_remove(mutex,&waiter);
+        info->blocked_on=NULL;
+        info->waiter=NULL;
+        //只恢复直接持有者；链上更深的任务在它们各自解锁时恢复（保守但安全）
+        mutex_update_priority(mutex->owner);
+        mutex->timeouts++;
+    }
+    taskEXIT_CRITICAL();
+
+    return pdFAIL;
+}
+
+
+/**
+ * 解锁
+ * 功能：有等待者就直接交给优先级最高的那个；然后恢复自己的优先级
+ */
+void AdaptiveMutex_Unlock(AdaptiveMutex_t *mutex){
+    TaskHandle_t self=xTaskGetCurrentTaskHandle();
+    MutexTaskInfo_t *info=mutex_task_info(self);
+    uint32_t now=cycle_counter_get();
+    uint32_t hold=now-mutex->acquire_cycle;
+    TaskHandle_t next_owner=NULL;
+
+    configASSERT(mutex->owner==self);
+
+    taskENTER_CRITICAL();
+    {
+        //从自己的已持有链表中摘掉
+        AdaptiveMutex_t **pp=&info->held;
+        while(*pp!=mutex){
+            pp=&(*pp)->next_held;
+        }
+        *pp=mutex->next_held;
+
+        //更新持锁时间滑动平均：ewma += (hold - ewma) / 8
+        mutex->hold_ewma=mutex->hold_ewma+(uint32_t)(((int32_t)(hold-mutex->hold_ewma))>>MUTEX_EWMA_SHIFT);
+        mutex->release_cycle=now;
+
+        if(mutex->waiters!=NULL){
+            //交接：直接设置新持有者，其他任务无法插队
+            MutexWaiter_t *waiter=mutex->waiters;
+            MutexTaskInfo_t *next_info=mutex_task_info(waiter->task);
+
+            mutex->waiters=waiter->next;
+            next_info->blocked_on=NULL;
+            next_info->waiter=NULL;
+            mutex_take_ownership(mutex,waiter->task,next_info);
+            next_owner=waiter->task;
+
+            //新持有者继承剩余等待者的优先级
+            if(mutex->waiters!=NULL){
+                mutex_propagate_priority(mutex,mutex->waiters->priority);
+            }
+            xTaskNotifyGiveIndexed(next_owner,MUTEX_NOTIFY_INDEX);
+        }else{
+            mutex->owner=NULL;
+        }
+
+        //恢复自己的优先级（可能仍被其他持有的锁提升）
+        mutex_update_priority(self);
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+// ==================== demo6的互斥锁示例 ====================
+static AdaptiveMutex_t buffer_mutex;
+char shared_buffer[100];
+
+void resource_user_task(void *pvParameters){
+    int user_id=(int)(uintptr_t)pvParameters;
+
+    for(;;){
+        if(AdaptiveMutex_Lock(&buffer_mutex,pdMS_TO_TICKS(10000))==pdPASS){
+            //短临界区：自旋最有效的场景
+            snprintf(shared_buffer,sizeof(shared_buffer),"用户%d写入的数据",user_id);
+            AdaptiveMutex_Unlock(&buffer_mutex);
+        }else{
+            printf("[用户%d] 获取互斥锁超时！\n", user_id);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+
+// ==================== 传递式优先级继承演示 ====================
+/*
+ * L（优先级1）持有lock_a
+ * M（优先级2）持有lock_b，然后等待lock_a        → L被提升到2
+ * H（优先级4）等待lock_b                         → M被提升到4，并沿链把L也提升到4
+ * 中间优先级的干扰任务（优先级3）无法再抢占L，H的阻塞时间有上界
+ */
+static AdaptiveMutex_t lock_a;
+static AdaptiveMutex_t lock_b;
+static TaskHandle_t low_handle,mid_handle,high_handle;
+
+static void busy_work(uint32_t loops){
+    for(volatile uint32_t i=0;i<loops;i++);
+}
+
+void chain_low_task(void *pvParameters){
+    for(;;){
+        AdaptiveMutex_Lock(&lock_a,portMAX_DELAY);
+        printf("[L] 持有lock_a，优先级%lu\n", uxTaskPriorityGet(NULL));
+        vTaskDelay(pdMS_TO_TICKS(100));         //让M和H依次进入等待
+        busy_work(100000);
+        printf("[L] 释放lock_a前优先级%lu（被H经M传递提升）\n", uxTaskPriorityGet(NULL));
+        AdaptiveMutex_Unlock(&lock_a);
+        printf("[L] 释放后恢复为%lu\n", uxTaskPriorityGet(NULL));
+
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
+void chain_mid_task(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(20));
+        AdaptiveMutex_Lock(&lock_b,portMAX_DELAY);
+        AdaptiveMutex_Lock(&lock_a,portMAX_DELAY);     //等L
+        printf("[M] 拿到lock_a和lock_b，优先级%lu\n", uxTaskPriorityGet(NULL));
+        AdaptiveMutex_Unlock(&lock_a);
+        AdaptiveMutex_Unlock(&lock_b);
+
+        vTaskDelay(pdMS_TO_TICKS(5000-20));
+    }
+}
+
+void chain_high_task(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(50));
+        TickType_t start=xTaskGetTickCount();
+        AdaptiveMutex_Lock(&lock_b,portMAX_DELAY);     //等M，M又在等L
+        printf("[H] 拿到lock_b，等待了%lu ticks\n", xTaskGetTickCount()-start);
+        AdaptiveMutex_Unlock(&lock_b);
+
+        vTaskDelay(pdMS_TO_TICKS(5000-50));
+    }
+}
+
+// 中等优先级的干扰任务：没有优先级继承时，它会抢占L，导致H被无限期推迟
+void interference_task(void *pvParameters){
+    for(;;){
+        busy_work(20000);
+        vTaskDelay(1);
+    }
+}
+
+
+// ==================== 性能对比 ====================
+#define BENCH_MAX_CONTENDERS    16
+#define BENCH_DURATION_MS       1000    //每种配置运行时间
+#define BENCH_CS_LOOPS          50      //临界区长度（空循环次数）
+
+static AdaptiveMutex_t bench_adaptive;
+static SemaphoreHandle_t bench_kernel_mutex;
+static volatile uint32_t bench_kernel_release;  //内核互斥锁最近一次释放时刻
+static volatile BaseType_t bench_use_adaptive;
+static volatile BaseType_t bench_running;
+static volatile uint32_t bench_acquires;
+static volatile uint64_t bench_handoff_total;
+static volatile uint32_t bench_handoff_count;
+static volatile uint32_t bench_shared_counter;
+
+/**
+ * 竞争者任务
+ * 交接延迟：第一次尝试没拿到锁时，从上一次释放到本次拿到的时间
+ */
+void bench_contender_task(void *pvParameters){
+    for(;;){
+        if(!bench_running){
+            vTaskDelay(1);
+            continue;
+        }
+
+        if(bench_use_adaptive){
+            BaseType_t contended=(bench_adaptive.owner!=NULL);
+            AdaptiveMutex_Lock(&bench_adaptive,portMAX_DELAY);
+            if(contended){
+                bench_handoff_total+=cycle_counter_get()-bench_adaptive.release_cycle;
+                bench_handoff_count++;
+            }
+            bench_shared_counter++;
+            busy_work(BENCH_CS_LOOPS);
+            bench_acquires++;
+            AdaptiveMutex_Unlock(&bench_adaptive);
+        }else{
+            BaseType_t contended=(xSemaphoreTake(bench_kernel_mutex,0)!=pdTRUE);
+            if(contended){
+                xSemaphoreTake(bench_kernel_mutex,portMAX_DELAY);
+                bench_handoff_total+=cycle_counter_get()-bench_kernel_release;
+                bench_handoff_count++;
+            }
+            bench_shared_counter++;
+            busy_work(BENCH_CS_LOOPS);
+            bench_acquires++;
+            bench_kernel_release=cycle_counter_get();
+            xSemaphoreGive(bench_kernel_mutex);
+        }
+
+        busy_work(BENCH_CS_LOOPS);  //锁外的工作
+    }
+}
+
+/**
+ * 基准控制任务
+ * 逐步增加竞争者数量（2/4/8/16），每种数量分别测自适应锁和内核互斥锁
+ */
+void bench_controller_task(void *pvParameters){
+    static const uint32_t contender_counts[]={2,4,8,16};
+    uint32_t created=0;
+
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    cycle_counter_init();
+
+    printf("\n[性能测试] 自适应锁 vs 内核互斥锁（每种配置%dms，%s）\n", BENCH_DURATION_MS, CYCLE_UNIT);
+    printf("  竞争者  锁类型      吞吐量(次/秒)  平均交接延迟  自旋成功/失败\n");
+
+    for(uint32_t c=0;c<sizeof(contender_counts)/sizeof(contender_counts[0]);c++){
+        //补齐竞争者任务（同一优先级，靠时间片和多核产生竞争）
+        while(created<contender_counts[c]){
+            xTaskCreate(bench_contender_task,"Contender",256,NULL,2,NULL);
+            created++;
+        }
+
+        for(BaseType_t adaptive=pdTRUE;adaptive>=pdFALSE;adaptive--){
+            bench_use_adaptive=adaptive;
+            bench_acquires=0;
+            bench_handoff_total=0;
+            bench_handoff_count=0;
+            AdaptiveMutex_Init(&bench_adaptive);
+
+            bench_running=pdTRUE;
+            vTaskDelay(pdMS_TO_TICKS(BENCH_DURATION_MS));
+            bench_running=pdFALSE;
+            vTaskDelay(pdMS_TO_TICKS(50));  //等所有竞争者退出临界区
+
+            printf("  %4lu    %s  %12lu  %12lu  %lu/%lu\n",
+                   contender_counts[c], adaptive?"自适应锁  ":"内核互斥锁",
+                   bench_acquires*1000/BENCH_DURATION_MS,
+                   (uint32_t)(bench_handoff_total/(bench_handoff_count?bench_handoff_count:1)),
+                   adaptive?bench_adaptive.spin_acquires:0,
+                   adaptive?bench_adaptive.spin_failures:0);
+        }
+    }
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 自适应互斥锁\n");
+
+    AdaptiveMutex_Init(&buffer_mutex);
+    AdaptiveMutex_Init(&lock_a);
+    AdaptiveMutex_Init(&lock_b);
+
+    bench_kernel_mutex=xSemaphoreCreateMutex();
+    if(bench_kernel_mutex==NULL){
+        printf("互斥信号量创建失败\n");
+        return -1;
+    }
+
+    xTaskCreate(resource_user_task, "ResUser1", 256, (void*)1, 1, NULL);
+    xTaskCreate(resource_user_task, "ResUser2", 256, (void*)2, 1, NULL);
+
+    xTaskCreate(chain_low_task, "ChainL", 256, NULL, 1, &low_handle);
+    xTaskCreate(chain_mid_task, "ChainM", 256, NULL, 2, &mid_handle);
+    xTaskCreate(chain_high_task, "ChainH", 256, NULL, 4, &high_handle);
+    xTaskCreate(interference_task, "Interfere", 256, NULL, 3, NULL);
+
+    xTaskCreate(bench_controller_task, "BenchCtrl", 512, NULL, 5, NULL);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 为什么要先自旋：
+   - 阻塞需要：入队、切换任务、被唤醒、再切换回来，至少两次上下文切换
+   - 临界区只有几百个周期时，持有者很快就会释放，自旋等待更便宜
+   - 但只有持有者"正在另一个核上运行"时自旋才有意义，单核上直接阻塞
+
+2. 自适应预算：
+   - 每次解锁时用本次持锁时间更新滑动平均 ewma += (hold - ewma)/8
+   - 自旋预算 = 2 x 平均持锁时间，并限制在阻塞开销以内
+   - 持锁时间变长后自旋会自动变短，不会白白浪费CPU
+
+3. 传递式优先级继承：
+   - 每个任务记录自己正在等哪把锁（blocked_on）
+   - 阻塞时沿"锁→持有者→持有者在等的锁→..."一路提升，最多MUTEX_MAX_CHAIN层
+   - 解锁时优先级 = max(基础优先级, 仍持有的锁上最高等待者优先级)
+
+4. 直接交接（handoff）：
+   - 解锁时直接把owner设成最高优先级等待者再通知它
+   - 避免"刚释放就被另一个正在运行的任务抢走"，保证等待者不会饿死
+
+5. 注意事项：
+   - 基础优先级在任务第一次用锁时记录，之后如需改变优先级要同步更新
+   - 不支持递归加锁，不能在中断中使用
+   - 持锁期间不要调用会阻塞的API，否则自旋的竞争者只会白白浪费CPU
+*/
@@ -0,0 +1,644 @@
+/*
+ * Demo: 读写锁（写者优先、读者数量有上限、写者优先级继承）
+ * 学习要点：
+ * 1. 读多写少的共享数据，用互斥锁会让读者之间也互相排队
+ * 2. 读写锁：多个读者可以同时持有，写者独占
+ * 3. 写者优先：只要有写者在等，新来的读者就要排队，写者不会被源源不断的读者饿死
+ * 4. 读者数量有上限：持有者都登记在固定大小的表里，才能对它们做优先级继承
+ * 5. 优先级继承：高优先级任务等锁时，提升所有当前持有者（写者或全部读者）
+ * 6. 释放时直接把锁交给等待者（写者交给一个写者，或一次放行一批读者）
+ * 7. 性能测试：读者数量增加时，读写锁和互斥锁的读吞吐量对比
+ *
+ * 对应场景：demo6的shared_buffer、3.临界段/demo1.c的账户余额查询、
+ *          5.支持多优先级/demo4.c的task_status_array
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdio.h>
+#include <string.h>
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES < 2)
+    #error "本demo需要至少2个任务通知槽"
+#endif
+
+
+// ==================== 读写锁 ====================
+#define RWLOCK_MAX_READERS      8       //同时持有读锁的任务上限
+#define RWLOCK_NOTIFY_INDEX     (configTASK_NOTIFICATION_ARRAY_ENTRIES-1)   //授予通知用的槽
+
+//等待节点：放在等待任务自己的栈上
+typedef struct RwWaiter{
+    TaskHandle_t task;
+    UBaseType_t priority;
+    volatile BaseType_t granted;    //释放方在临界段里置位，表示锁已经交给了这个任务
+    struct RwWaiter *next;
+}RwWaiter_t;
+
+//持有者登记表：记录每个持有者的基础优先级，释放时恢复
+typedef struct{
+    TaskHandle_t task;
+    UBaseType_t base_priority;
+}RwHolder_t;
+
+typedef struct{
+    RwHolder_t readers[RWLOCK_MAX_READERS];
+    uint32_t reader_count;          //当前持有读锁的任务数
+    uint32_t max_readers;           //读者上限（<=RWLOCK_MAX_READERS）
+    RwHolder_t writer;              //写者，task为NULL表示没有写者
+    RwWaiter_t *reader_waiters;     //等待的读者（FIFO）
+    RwWaiter_t *writer_waiters;     //等待的写者（按优先级排序）
+
+    //统计信息
+    uint32_t read_acquires;
+    uint32_t write_acquires;
+    uint32_t read_contended;        //读者需要阻塞的次数
+    uint32_t write_contended;       //写者需要阻塞的次数
+    uint32_t priority_boosts;       //持有者被提升的次数
+    uint32_t max_reader_count;      //同时持有读锁的最大任务数
+}RwLock_t;
+
+
+void RwLock_Init(RwLock_t *lock, uint32_t max_readers){
+    memset(lock,0,sizeof(RwLock_t));
+    if(max_readers==0||max_readers>RWLOCK_MAX_READERS){
+        max_readers=RWLOCK_MAX_READERS;
+    }
+    lock->max_readers=max_readers;
+}
+
+
+//以下内部函数都由调用者负责临界段
+
+//把持有者提升到priority（只升不降）
+static void rwlock_boost(RwLock_t *lock, TaskHandle_t task, UBaseType_t priority){
+    if(task!=NULL&&uxTaskPriorityGet(task)<priority){
+        vTaskPrioritySet(task,priority);
+        lock->priority_boosts++;
+    }
+}
+
+//优先级继承：等待者的优先级传给当前所有持有者
+static void rwlock_boost_holders(RwLock_t *lock, UBaseType_t priority){
+    rwlock_boost(lock,lock->writer.task,priority);
+    for(uint32_t i=0;i<lock->reader_count;i++){
+        rwlock_boost(lock,lock->readers[i].task,priority);
+    }
+}
+
+//剩余等待者中的最高优先级，0表示没有等待者
+static UBaseType_t rwlock_top_waiter_priority(RwLock_t *lock){
+    UBaseType_t priority=0;
+
+    if(lock->writer_waiters!=NULL){
+        priority=lock->writer_waiters->priority;
+    }
+    for(RwWaiter_t *w=lock->reader_waiters;w!=NULL;w=w->next){
+        if(w->priority>priority){
+            priority=w->priority;
+        }
+    }
+    return priority;
+}
+
+static void rwlock_add_reader(RwLock_t *lock, TaskHandle_t task, UBaseType_t base_priority){
+    lock->readers[lock->reader_count].task=task;
+    lock->readers[lock->reader_count].base_priority=base_priority;
+    lock->reader_count++;
+    lock->read_acquires++;
+    if(lock->reader_count>lock->max_reader_count){
+        lock->max_reader_count=lock->reader_count;
+    }
+}
+
+static void rwlock_set_writer(RwLock_t *lock, TaskHandle_t task, UBaseType_t base_priority){
+    lock->writer.task=task;
+    lock->writer.base_priority=base_priority;
+    lock->write_acquires++;
+}
+
+static void waiter_append(RwWaiter_t **list, RwWaiter_t *waiter){
+    while(*list!=NULL){
+        list=&(*list)->next;
+    }
+    waiter->next=NULL;
+    *list=waiter;
+}
+
+static void waiter_insert_by_priority(RwWaiter_t **list, RwWaiter_t *waiter){
+    while(*list!=NULL&&(*list)->priority>=waiter->priority){
+        list=&(*list)->next;
+    }
+    waiter->next=*list;
+    *list=waiter;
+}
+
+static void waiter_remove(RwWaiter_t **list, RwWaiter_t *waiter){
+    while(*list!=NULL&&*list!=waiter){
+        list=&(*list)->next;
+    }
+    if(*list!=NULL){
+        *list=waiter->next;
+    }
+}
+
+/**
+ * 锁被释放后把它交给等待者
+ * 写者优先：没有读者持有时先交给最高优先级的写者；
+ *          没有写者在等时，按FIFO放行读者直到上限
+ */
+static void rwlock_grant_waiters(RwLock_t *lock){
+    UBaseType_t top;
+
+    if(lock->writer.task!=NULL){
+        return;
+    }
+
+    if(lock->writer_waiters!=NULL){
+        if(lock->reader_count==0){
+            RwWaiter_t *w=lock->writer_waiters;
+            lock->writer_waiters=w->next;
+            rwlock_set_writer(lock,w->task,w->priority);
+            w->granted=pdTRUE;
+            xTaskNotifyGiveIndexed(w->task,RWLOCK_NOTIFY_INDEX);
+        }
+    }else{
+        while(lock->reader_waiters!=NULL&&lock->reader_count<lock->max_readers){
+            RwWaiter_t *w=lock->reader_waiters;
+            lock->reader_waiters=w->next;
+            rwlock_add_reader(lock,w->task,w->priority);
+            w->granted=pdTRUE;
+            xTaskNotifyGiveIndexed(w->task,RWLOCK_NOTIFY_INDEX);
+        }
+    }
+
+    //新持有者继承仍在等待的任务的优先级
+    top=rwlock_top_waiter_priority(lock);
+    if(top>0){
+        rwlock_boost_holders(lock,top);
+    }
+}
+
+
+/**
+ * 等待授予通知
+ * 返回：pdPASS已经被授予锁，pdFAIL超时（已从等待队列移除）
+ */
+static BaseType_t rwlock_wait(RwLock_t *lock, RwWaiter_t **list, RwWaiter_t *waiter, TickType_t timeout){
+    TickType_t start_tick=xTaskGetTickCount();
+    BaseType_t result=pdFAIL;
+
+    for(;;){
+        TickType_t elapsed=xTaskGetTickCount()-start_tick;
+        TickType_t remaining=(timeout==portMAX_DELAY)?portMAX_DELAY:
+                             (elapsed>=timeout?0:timeout-elapsed);
+
+        ulTaskNotifyTakeIndexed(RWLOCK_NOTIFY_INDEX,pdTRUE,remaining);
+        if(waiter->granted){
+            return pdPASS;
+        }
+        if(remaining==0){
+            break;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    {
+        if(waiter->granted){
+            //超时和授予撞在一起，授予优先；清掉随后到达的通知
+            result=pdPASS;
+        }else{
+            waiter_remove(list,waiter);
+            //读者超时离开后，排在后面的读者可能可以进入了
+            rwlock_grant_waiters(lock);
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if(result==pdPASS){
+        ulTaskNotifyValueClearIndexed(NULL,RWLOCK_NOTIFY_INDEX,0xFFFFFFFF);
+    }
+    return result;
+}
+
+
+/**
+ * 获取读锁
+ * 功能：没有写者持有、没有写者在等、读者未满时直接进入，否则排队
+ * 参数：timeout - 最长等待时间
+ * 返回：pdPASS成功，pdFAIL超时
+ */
+BaseType_t RwLock_ReadLock(RwLock_t *lock, TickType_t timeout){
+    RwWaiter_t waiter;
+
+    waiter.task=xTaskGetCurrentTaskHandle();
+    waiter.priority=uxTaskPriorityGet(NULL);
+    waiter.granted=pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if(lock->writer.task==NULL&&lock->writer_waiters==NULL&&lock->reader_count<lock->max_readers){
+            rwlock_add_reader(lock,waiter.task,waiter.priority);
+            taskEXIT_CRITICAL();
+            return pdPASS;
+        }
+
+        if(timeout==0){
+            taskEXIT_CRITICAL();
+            return pdFAIL;
+        }
+
+        waiter_append(&lock->reader_waiters,&waiter);
+        lock->read_contended++;
+        rwlock_boost_holders(lock,waiter.priority);
+    }
+    taskEXIT_CRITICAL();
+
+    return rwlock_wait(lock,&lock->reader_waiters,&waiter,timeout);
+}
+
+
+/**
+ * 释放读锁
+ * 功能：从持有者表中移除自己，恢复被继承提升的优先级，最后一个读者负责交给写者
+ */
+void RwLock_ReadUnlock(RwLock_t *lock){
+    TaskHandle_t self=xTaskGetCurrentTaskHandle();
+
+    taskENTER_CRITICAL();
+    {
+        for(uint32_t i=0;i<lock->reader_count;i++){
+            if(lock->readers[i].task==self){
+                UBaseType_t base=lock->readers[i].base_priority;
+
+                lock->readers[i]=lock->readers[--lock->reader_count];
+                if(uxTaskPriorityGet(NULL)!=base){
+                    vTaskPrioritySet(NULL,base);
+                }
+                break;
+            }
+        }
+        rwlock_grant_waiters(lock);
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+/**
+ * 获取写锁
+ * 功能：没有任何持有者时直接获取，否则按优先级排队并提升当前持有者
+ * 参数：timeout - 最长等待时间
+ * 返回：pdPASS成功，pdFAIL超时
+ */
+BaseType_t RwLock_WriteLock(RwLock_t *lock, TickType_t timeout){
+    RwWaiter_t waiter;
+
+    waiter.task=xTaskGetCurrentTaskHandle();
+    waiter.priority=uxTaskPriorityGet(NULL);
+    waiter.granted=pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if(lock->writer.task==NULL&&lock->reader_count==0){
+            rwlock_set_writer(lock,waiter.task,waiter.priority);
+            taskEXIT_CRITICAL();
+            return pdPASS;
+        }
+
+        if(timeout==0){
+            taskEXIT_CRITICAL();
+            return pdFAIL;
+        }
+
+        //排进写者队列后，新来的读者都会被挡住（写者优先）
+        waiter_insert_by_priority(&lock->writer_waiters,&waiter);
+        lock->write_contended++;
+        rwlock_boost_holders(lock,waiter.priority);
+    }
+    taskEXIT_CRITICAL();
+
+    return rwlock_wait(lock,&lock->writer_waiters,&waiter,timeout);
+}
+
+
+/**
+ * 释放写锁
+ */
+void RwLock_WriteUnlock(RwLock_t *lock){
+    taskENTER_CRITICAL();
+    {
+        configASSERT(lock->writer.task==xTaskGetCurrentTaskHandle());
+        UBaseType_t base=lock->writer.base_priority;
+
+        lock->writer.task=NULL;
+        if(uxTaskPriorityGet(NULL)!=base){
+            vTaskPrioritySet(NULL,base);
+        }
+        rwlock_grant_waiters(lock);
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+// ==================== demo6的共享缓冲区 ====================
+static RwLock_t buffer_lock;
+char shared_buffer[100];
+
+void buffer_writer_task(void *pvParameters){
+    uint32_t seq=0;
+
+    for(;;){
+        if(RwLock_WriteLock(&buffer_lock,pdMS_TO_TICKS(10000))==pdPASS){
+            snprintf(shared_buffer,sizeof(shared_buffer),"写入序号%lu",seq++);
+            RwLock_WriteUnlock(&buffer_lock);
+        }else{
+            printf("[写者] 获取写锁超时！\n");
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+void buffer_reader_task(void *pvParameters){
+    int reader_id=(int)(uintptr_t)pvParameters;
+    char local[100];
+
+    for(;;){
+        if(RwLock_ReadLock(&buffer_lock,pdMS_TO_TICKS(10000))==pdPASS){
+            memcpy(local,shared_buffer,sizeof(local));
+            RwLock_ReadUnlock(&buffer_lock);
+            printf("[读者%d] 读取: %s\n", reader_id, local);
+        }else{
+            printf("[读者%d] 获取读锁超时！\n", reader_id);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(700+reader_id*100));
+    }
+}
+
+
+// ==================== 3.临界段/demo1.c的账户查询 ====================
+typedef struct {
+    uint32_t account_id;        //账户ID
+    volatile int32_t balance;   //账户余额
+    char owner_name[32];        //账户持有人姓名
+    uint32_t transaction_count; //该账户的交易次数
+} BankAccount_t;
+
+BankAccount_t g_accounts[4] = {
+    {1001, 10000, "张三", 0},
+    {1002, 5000,  "李四", 0},
+    {1003, 8000,  "王五", 0},
+    {1004, 15000, "赵六", 0}
+};
+
+static RwLock_t accounts_lock;
+
+static BankAccount_t* find_account(uint32_t account_id){
+    for(int i=0;i<4;i++){
+        if(g_accounts[i].account_id==account_id){
+            return &g_accounts[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * 余额查询：多个查询任务可以并行，不会互相阻塞
+ * 相比taskENTER_CRITICAL()，查询期间也不关中断
+ */
+int32_t get_account_balance_rw(uint32_t account_id){
+    BankAccount_t *account=find_account(account_id);
+    int32_t balance=-1;
+
+    if(account&&RwLock_ReadLock(&accounts_lock,portMAX_DELAY)==pdPASS){
+        balance=account->balance;
+        RwLock_ReadUnlock(&accounts_lock);
+    }
+    return balance;
+}
+
+/**
+ * 转账：写锁保证两个账户的修改对查询者是原子的
+ */
+int transfer_money_rw(uint32_t from_id, uint32_t to_id, int32_t amount){
+    BankAccount_t *from_account=find_account(from_id);
+    BankAccount_t *to_account=find_account(to_id);
+    int result=-1;
+
+    if(amount<=0||!from_account||!to_account||from_account==to_account){
+        return -1;
+    }
+
+    RwLock_WriteLock(&accounts_lock,portMAX_DELAY);
+    if(from_account->balance>=amount){
+        from_account->balance-=amount;
+        to_account->balance+=amount;
+        from_account->transaction_count++;
+        to_account->transaction_count++;
+        result=0;
+    }
+    RwLock_WriteUnlock(&accounts_lock);
+
+    return result;
+}
+
+void bank_transfer_task(void *pvParameters){
+    uint32_t round=0;
+
+    for(;;){
+        uint32_t from=1001+(round%4);
+        uint32_t to=1001+((round+1)%4);
+        transfer_money_rw(from,to,100+(round%5)*100);
+        round++;
+
+        vTaskDelay(pdMS_TO_TICKS(500));
+    }
+}
+
+void bank_query_task(void *pvParameters){
+    for(;;){
+        int32_t total=0;
+
+        //总额不变是转账原子性的检验
+        for(int i=0;i<4;i++){
+            total+=get_account_balance_rw(g_accounts[i].account_id);
+        }
+        printf("[查询] 账户总额: %ld（应为38000）读锁获取%lu次，最多%lu个读者同时持有\n",
+               total, accounts_lock.read_acquires, accounts_lock.max_reader_count);
+
+        vTaskDelay(pdMS_TO_TICKS(3000));
+    }
+}
+
+
+// ==================== 性能测试：读吞吐量随读者数量的变化 ====================
+#define BENCH_MAX_READERS       8
+#define BENCH_DURATION_MS       1000    //每种配置运行时间
+#define BENCH_READ_LOOPS        200     //读临界区长度（模拟遍历task_status_array）
+#define BENCH_WRITE_PERIOD_MS   10      //写者周期
+
+static RwLock_t bench_rwlock;
+static SemaphoreHandle_t bench_mutex;
+static volatile BaseType_t bench_use_rwlock;
+static volatile BaseType_t bench_running;
+static volatile uint32_t bench_active_readers;  //本轮参与的读者数量
+static volatile uint32_t bench_reads;
+static volatile uint32_t bench_writes;
+static volatile uint32_t bench_data[16];
+
+static void bench_read_section(void){
+    uint32_t sum=0;
+    for(uint32_t i=0;i<BENCH_READ_LOOPS;i++){
+        sum+=bench_data[i&15];
+    }
+    (void)sum;
+}
+
+void bench_reader_task(void *pvParameters){
+    uint32_t id=(uint32_t)(uintptr_t)pvParameters;
+
+    for(;;){
+        if(!bench_running||id>=bench_active_readers){
+            vTaskDelay(1);
+            continue;
+        }
+
+        if(bench_use_rwlock){
+            RwLock_ReadLock(&bench_rwlock,portMAX_DELAY);
+            bench_read_section();
+            RwLock_ReadUnlock(&bench_rwlock);
+        }else{
+            xSemaphoreTake(bench_mutex,portMAX_DELAY);
+            bench_read_section();
+            xSemaphoreGive(bench_mutex);
+        }
+        taskENTER_CRITICAL();
+        bench_reads++;
+        taskEXIT_CRITICAL();
+    }
+}
+
+void bench_writer_task(void *pvParameters){
+    for(;;){
+        if(bench_running){
+            if(bench_use_rwlock){
+                RwLock_WriteLock(&bench_rwlock,portMAX_DELAY);
+                bench_data[bench_writes&15]++;
+                RwLock_WriteUnlock(&bench_rwlock);
+            }else{
+                xSemaphoreTake(bench_mutex,portMAX_DELAY);
+                bench_data[bench_writes&15]++;
+                xSemaphoreGive(bench_mutex);
+            }
+            bench_writes++;
+        }
+        vTaskDelay(pdMS_TO_TICKS(BENCH_WRITE_PERIOD_MS));
+    }
+}
+
+/**
+ * 基准控制任务
+ * 读者数量1/2/4/8，每种数量分别测读写锁和互斥锁
+ * 单核上读者本来就无法真正并行，差距主要体现在SMP上
+ */
+void bench_controller_task(void *pvParameters){
+    static const uint32_t reader_counts[]={1,2,4,8};
+
+    vTaskDelay(pdMS_TO_TICKS(2000));
+
+    printf("\n[性能测试] 读吞吐量：读写锁 vs 互斥锁（写者每%dms写一次）\n", BENCH_WRITE_PERIOD_MS);
+    printf("  读者  读写锁(次/秒)  互斥锁(次/秒)  加速比  最多同时读者\n");
+
+    for(uint32_t c=0;c<sizeof(reader_counts)/sizeof(reader_counts[0]);c++){
+        uint32_t rate[2];
+        uint32_t max_concurrent=0;
+
+        for(BaseType_t use_rwlock=pdTRUE;use_rwlock>=pdFALSE;use_rwlock--){
+            bench_use_rwlock=use_rwlock;
+            bench_active_readers=reader_counts[c];
+            bench_reads=0;
+            bench_writes=0;
+            RwLock_Init(&bench_rwlock,BENCH_MAX_READERS);
+
+            bench_running=pdTRUE;
+            vTaskDelay(pdMS_TO_TICKS(BENCH_DURATION_MS));
+            bench_running=pdFALSE;
+            vTaskDelay(pdMS_TO_TICKS(50));  //等读者退出临界区
+
+            rate[use_rwlock?0:1]=bench_reads*1000/BENCH_DURATION_MS;
+            if(use_rwlock){
+                max_concurrent=bench_rwlock.max_reader_count;
+            }
+        }
+
+        printf("  %4lu  %13lu  %13lu  %5lu.%02lux  %lu\n",
+               reader_counts[c], rate[0], rate[1],
+               rate[0]/(rate[1]?rate[1]:1), (rate[0]*100/(rate[1]?rate[1]:1))%100,
+               max_concurrent);
+    }
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 读写锁\n");
+
+    RwLock_Init(&buffer_lock,4);
+    RwLock_Init(&accounts_lock,RWLOCK_MAX_READERS);
+    strcpy(shared_buffer,"初始数据");
+
+    bench_mutex=xSemaphoreCreateMutex();
+    if(bench_mutex==NULL){
+        printf("互斥信号量创建失败\n");
+        return -1;
+    }
+
+    xTaskCreate(buffer_writer_task, "BufWriter", 256, NULL, 2, NULL);
+    xTaskCreate(buffer_reader_task, "BufReader1", 256, (void*)1, 1, NULL);
+    xTaskCreate(buffer_reader_task, "BufReader2", 256, (void*)2, 1, NULL);
+    xTaskCreate(buffer_reader_task, "BufReader3", 256, (void*)3, 1, NULL);
+
+    xTaskCreate(bank_transfer_task, "BankXfer", 256, NULL, 2, NULL);
+    xTaskCreate(bank_query_task, "BankQuery", 256, NULL, 1, NULL);
+
+    for(uint32_t i=0;i<BENCH_MAX_READERS;i++){
+        xTaskCreate(bench_reader_task, "BenchRd", 256, (void*)(uintptr_t)i, 1, NULL);
+    }
+    xTaskCreate(bench_writer_task, "BenchWr", 256, NULL, 3, NULL);
+    xTaskCreate(bench_controller_task, "BenchCtrl", 512, NULL, 4, NULL);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 读写锁适用的场景：
+   - 读远多于写，读临界区不算太短（否则锁本身的开销占主导）
+   - demo6的shared_buffer、账户余额查询、任务状态表都属于这一类
+
+2. 写者优先：
+   - 有写者在等时，新读者必须排队
+   - 否则读者一个接一个地进来，读者数永远不为0，写者被饿死
+   - 代价是写者等待期间读吞吐量下降
+
+3. 读者数量上限：
+   - 持有者登记在固定大小的表里，释放时才能恢复它们的优先级
+   - 也限制了写者需要等待的读者数量
+
+4. 优先级继承：
+   - 高优先级任务（读者或写者）等锁时，所有当前持有者被提升到它的优先级
+   - 锁交接后，新的持有者继承仍在等待者中的最高优先级
+   - 这里只做一层继承；持有读写锁期间不要再去等其他锁
+
+5. 与临界段的比较：
+   - taskENTER_CRITICAL()读余额会关中断，读者之间也串行
+   - 读锁只在登记/注销时短暂进入临界段，读数据期间中断和其他读者照常运行
+*/
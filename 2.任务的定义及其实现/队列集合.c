@@ -0,0 +1,558 @@
+/*
+ * Demo: 带就绪位图的队列集合
+ * 学习要点：
+ * 1. 一个任务同时阻塞在多个队列上，任意一个队列来数据就被唤醒
+ * 2. 集合内部维护"就绪成员位图"，选择就绪队列只需要找最低置位，O(1)，和成员数无关
+ * 3. 两级位图：一级位图的每一位对应二级位图的一个32位字
+ * 4. 用任务通知唤醒等待者，不需要额外的信号量
+ * 5. 成员序号就是优先级：序号越小越先被选中（命令队列放在最前面）
+ * 6. 与轮询各队列的方式对比唤醒延迟和CPU消耗（4~64个队列）
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 队列集合 ====================
+#define QUEUE_SET_MAX_MEMBERS   64                          //最大成员数（最多可以到32*32=1024）
+#define QUEUE_SET_WORDS         ((QUEUE_SET_MAX_MEMBERS+31)/32)
+#define QUEUE_SET_NONE          (-1)                        //没有就绪成员
+
+//队列集合控制块
+typedef struct{
+    QueueHandle_t members[QUEUE_SET_MAX_MEMBERS];   //成员队列
+    uint32_t member_count;                          //成员数量
+    volatile uint32_t group_bitmap;                 //一级位图：bit i表示ready_bitmap[i]非0
+    volatile uint32_t ready_bitmap[QUEUE_SET_WORDS];//二级位图：bit表示该成员队列非空
+    TaskHandle_t waiting_task;                      //正在等待的任务（同一时刻只允许一个）
+
+    //统计信息
+    uint32_t select_count;      //选择次数
+    uint32_t block_count;       //进入阻塞的次数
+    uint32_t spurious_count;    //位图显示就绪但队列已空的次数
+    uint64_t blocked_cycles;    //在Select里阻塞等待的总时间，统计调用者CPU消耗时扣除
+}QueueSet_t;
+
+
+/**
+ * 初始化队列集合
+ */
+void QueueSet_Init(QueueSet_t *set){
+    memset(set,0,sizeof(QueueSet_t));
+}
+
+
+/**
+ * 添加成员队列
+ * 参数：set - 队列集合；queue - 成员队列（必须是空队列）
+ * 返回：成员序号（也是优先级，越小越优先），失败返回QUEUE_SET_NONE
+ * 说明：必须在开始收发之前添加
+ */
+int32_t QueueSet_Add(QueueSet_t *set, QueueHandle_t queue){
+    if(set->member_count>=QUEUE_SET_MAX_MEMBERS||uxQueueMessagesWaiting(queue)!=0){
+        return QUEUE_SET_NONE;
+    }
+    set->members[set->member_count]=queue;
+    return (int32_t)set->member_count++;
+}
+
+
+//标记/清除成员就绪，调用者负责临界段
+static inline void queue_set_mark_ready(QueueSet_t *set, uint32_t member){
+    set->ready_bitmap[member>>5]|=(1UL<<(member&31));
+    set->group_bitmap|=(1UL<<(member>>5));
+}
+
+static inline void queue_set_clear_ready(QueueSet_t *set, uint32_t member){
+    set->ready_bitmap[member>>5]&=~(1UL<<(member&31));
+    if(set->ready_bitmap[member>>5]==0){
+        set->group_bitmap&=~(1UL<<(member>>5));
+    }
+}
+
+//找序号最小的就绪成员：两次"找最低置位"，和成员数无关
+static inline int32_t queue_set_first_ready(QueueSet_t *set){
+    uint32_t word;
+
+    if(set->group_bitmap==0){
+        return QUEUE_SET_NONE;
+    }
+    word=(uint32_t)__builtin_ctz(set->group_bitmap);
+    return (int32_t)(word*32+(uint32_t)__builtin_ctz(set->ready_bitmap[word]));
+}
+
+
+/**
+ * 向集合中的某个成员队列发送数据
+ * 功能：先发送到队列，再标记就绪；如果有任务在等待就通知它
+ * 参数：member - QueueSet_Add()返回的成员序号
+ */
+BaseType_t QueueSet_Send(QueueSet_t *set, int32_t member, const void *item, TickType_t timeout){
+    TaskHandle_t waiter;
+
+    if(xQueueSend(set->members[member],item,timeout)!=pdPASS){
+        return pdFAIL;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        queue_set_mark_ready(set,(uint32_t)member);
+        waiter=set->waiting_task;
+        set->waiting_task=NULL;     //只通知一次，后面的发送不必再通知
+    }
+    taskEXIT_CRITICAL();
+
+    if(waiter!=NULL){
+        xTaskNotifyGive(waiter);
+    }
+    return pdPASS;
+}
+
+
+/**
+ * 中断版本的发送
+ */
+BaseType_t QueueSet_SendFromISR(QueueSet_t *set, int32_t member, const void *item,
+                                BaseType_t *pxHigherPriorityTaskWoken){
+    TaskHandle_t waiter;
+    UBaseType_t saved;
+
+    if(xQueueSendFromISR(set->members[member],item,pxHigherPriorityTaskWoken)!=pdPASS){
+        return pdFAIL;
+    }
+
+    saved=taskENTER_CRITICAL_FROM_ISR();
+    {
+        queue_set_mark_ready(set,(uint32_t)member);
+        waiter=set->waiting_task;
+        set->waiting_task=NULL;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    if(waiter!=NULL){
+        vTaskNotifyGiveFromISR(waiter,pxHigherPriorityTaskWoken);
+    }
+    return pdPASS;
+}
+
+
+/**
+ * 等待任意成员队列就绪
+ * 功能：位图非空直接返回序号最小的就绪成员；否则阻塞等待通知
+ * 参数：timeout - 最长等待时间
+ * 返回：就绪成员序号，超时返回QUEUE_SET_NONE
+ * 说明：返回后调用QueueSet_Receive()取数据
+ */
+int32_t QueueSet_Select(QueueSet_t *set, TickType_t timeout){
+    TickType_t start=xTaskGetTickCount();
+    int32_t member;
+
+    for(;;){
+        //计算剩余等待时间
+        TickType_t elapsed=xTaskGetTickCount()-start;
+        BaseType_t expired=(timeout!=portMAX_DELAY&&elapsed>=timeout)?pdTRUE:pdFALSE;
+
+        taskENTER_CRITICAL();
+        {
+            member=queue_set_first_ready(set);
+            if(member==QUEUE_SET_NONE&&!expired){
+                //先登记再阻塞；登记后到阻塞前的通知会留在通知值里，不会丢
+                set->waiting_task=xTaskGetCurrentTaskHandle();
+            }else{
+                //要返回了：和就绪检查在同一个临界段里注销，之后的发送不会再通知一个没在等的任务
+                set->waiting_task=NULL;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if(member!=QUEUE_SET_NONE){
+            set->select_count++;
+            return member;
+        }
+        if(expired){
+            break;
+        }
+
+        set->block_count++;
+        uint32_t block_start=cycle_counter_get();
+        ulTaskNotifyTake(pdTRUE,(timeout==portMAX_DELAY)?portMAX_DELAY:timeout-elapsed);
+        set->blocked_cycles+=cycle_counter_get()-block_start;
+        //被唤醒（或超时）后回到循环开头重新检查位图
+    }
+
+    return QUEUE_SET_NONE;
+}
+
+
+/**
+ * 从已选中的成员队列取数据（不阻塞）
+ * 功能：取出一个数据，队列空了就清除就绪位
+ * 返回：pdPASS成功；pdFAIL表示队列已空（位图过期，已自动修正）
+ */
+BaseType_t QueueSet_Receive(QueueSet_t *set, int32_t member, void *buffer){
+    QueueHandle_t queue=set->members[member];
+    BaseType_t result=xQueueReceive(queue,buffer,0);
+
+    //"检查为空"和"清除位"必须在同一个临界段内，
+    //否则发送方可能恰好在两步之间发送，导致有数据的队列被标记为不就绪
+    taskENTER_CRITICAL();
+    {
+        if(uxQueueMessagesWaiting(queue)==0){
+            queue_set_clear_ready(set,(uint32_t)member);
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if(result!=pdPASS){
+        set->spurious_count++;
+    }
+    return result;
+}
+
+
+// ==================== demo7的数据结构 ====================
+typedef struct{
+    uint32_t id;
+    float value;
+    char unit[10];
+    uint32_t timestamp;
+}sensor_data_t;
+
+typedef struct{
+    char text[50];
+    uint8_t priority;
+    uint32_t sender_id;
+}message_t;
+
+typedef struct{
+    uint8_t cmd_type;
+    uint32_t param1;
+    uint32_t param2;
+    char description[30];
+}command_t;
+
+QueueHandle_t data_queue;
+QueueHandle_t message_queue;
+QueueHandle_t sensor_queue;
+QueueHandle_t command_queue;
+
+static QueueSet_t demo_set;
+
+//成员序号（按优先级顺序添加：命令最紧急，数据最不紧急）
+static int32_t command_member;
+static int32_t message_member;
+static int32_t sensor_member;
+static int32_t data_member;
+
+
+// ==================== 队列集合示例 ====================
+// 数据发送任务
+void sender_task(void *pvParameters){
+    uint32_t send_data=0;
+
+    for(;;){
+        QueueSet_Send(&demo_set,data_member,&send_data,pdMS_TO_TICKS(1000));
+        send_data++;
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+// 传感器任务
+void sensor_task(void *pvParameters){
+    sensor_data_t sensor_data;
+    static uint32_t sensor_id=1;
+
+    for(;;){
+        sensor_data.id=sensor_id;
+        sensor_data.value=20.0f+(rand()%100)/10.0f;
+        strcpy(sensor_data.unit,"°C");
+        sensor_data.timestamp=xTaskGetTickCount();
+
+        QueueSet_Send(&demo_set,sensor_member,&sensor_data,pdMS_TO_TICKS(1000));
+
+        sensor_id=(sensor_id%3)+1;
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
+// 命令发送任务
+void command_sender_task(void *pvParameters){
+    command_t cmd={0};
+
+    for(;;){
+        cmd.cmd_type=(cmd.cmd_type%4)+1;
+        snprintf(cmd.description,sizeof(cmd.description),"命令%d",cmd.cmd_type);
+        QueueSet_Send(&demo_set,command_member,&cmd,pdMS_TO_TICKS(1000));
+
+        vTaskDelay(pdMS_TO_TICKS(4000));
+    }
+}
+
+// 模拟中断服务程序 - 从中断发送紧急消息
+void simulate_interrupt_send_message(void){
+    BaseType_t higher_priority_task_woken=pdFALSE;
+    message_t urgent_msg={
+        .priority=0,
+        .sender_id=0,
+    };
+
+    strcpy(urgent_msg.text,"紧急中断消息!");
+    QueueSet_SendFromISR(&demo_set,message_member,&urgent_msg,&higher_priority_task_woken);
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+// 中断模拟任务
+void interrupt_simulator_task(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(3000));
+        simulate_interrupt_send_message();
+    }
+}
+
+
+/**
+ * 统一接收任务
+ * 功能：一个任务阻塞在集合上，同时处理四个队列，
+ *       不再需要像demo7的display_task那样每隔2秒挨个轮询
+ */
+void set_receiver_task(void *pvParameters){
+    union{
+        uint32_t data;
+        sensor_data_t sensor;
+        message_t message;
+        command_t command;
+    }buffer;
+
+    for(;;){
+        int32_t member=QueueSet_Select(&demo_set,portMAX_DELAY);
+
+        if(QueueSet_Receive(&demo_set,member,&buffer)!=pdPASS){
+            continue;
+        }
+
+        if(member==command_member){
+            printf("[集合接收] 命令: %s\n", buffer.command.description);
+        }else if(member==message_member){
+            printf("[集合接收] 消息 - 优先级:%d, 发送者:%lu, 内容:%s\n",
+                   buffer.message.priority, buffer.message.sender_id, buffer.message.text);
+        }else if(member==sensor_member){
+            printf("[集合接收] 传感器%lu: %.1f%s\n",
+                   buffer.sensor.id, buffer.sensor.value, buffer.sensor.unit);
+        }else{
+            printf("[集合接收] 数据: %lu\n", buffer.data);
+        }
+    }
+}
+
+
+// ==================== 性能对比：队列集合 vs 轮询 ====================
+#define BENCH_MESSAGES      200     //每种配置发送的消息数
+#define BENCH_SEND_PERIOD   2       //发送间隔（tick）
+
+static QueueHandle_t bench_queues[QUEUE_SET_MAX_MEMBERS];
+static QueueSet_t bench_set;
+static volatile uint32_t bench_queue_count;
+static volatile BaseType_t bench_use_set;
+static TaskHandle_t bench_receiver_handle;
+static TaskHandle_t bench_controller_handle;
+
+//接收端统计
+typedef struct{
+    uint32_t received;
+    uint64_t latency_total;     //发送时间戳到收到的延迟总和
+    uint32_t latency_max;
+    uint64_t busy_cycles;       //接收任务处于运行态的总时间（CPU消耗）
+    uint32_t queue_calls;       //调用队列API的次数
+}BenchStats_t;
+
+static BenchStats_t bench_stats;
+
+static void bench_record(uint32_t sent_at){
+    uint32_t latency=cycle_counter_get()-sent_at;
+
+    bench_stats.received++;
+    bench_stats.latency_total+=latency;
+    if(latency>bench_stats.latency_max){
+        bench_stats.latency_max=latency;
+    }
+    if(bench_stats.received==BENCH_MESSAGES){
+        xTaskNotifyGive(bench_controller_handle);
+    }
+}
+
+/**
+ * 基准接收任务
+ * 集合模式：阻塞在QueueSet_Select()上，唤醒后直接拿到就绪队列
+ * 轮询模式：每个tick把所有队列挨个非阻塞检查一遍（demo7中display_task的做法）
+ */
+void bench_receiver_task(void *pvParameters){
+    uint32_t sent_at;
+    uint32_t busy_start;
+
+    for(;;){
+        if(bench_use_set){
+            //Select本身的开销也算进CPU消耗，只扣除其中阻塞等待的时间
+            uint64_t blocked_before=bench_set.blocked_cycles;
+            busy_start=cycle_counter_get();
+
+            int32_t member=QueueSet_Select(&bench_set,pdMS_TO_TICKS(100));
+            if(member!=QUEUE_SET_NONE){
+                bench_stats.queue_calls++;
+                if(QueueSet_Receive(&bench_set,member,&sent_at)==pdPASS){
+                    bench_record(sent_at);
+                }
+            }
+            //控制任务切换配置时会在这期间重新初始化集合，这一轮不计
+            if(bench_set.blocked_cycles>=blocked_before){
+                bench_stats.busy_cycles+=cycle_counter_get()-busy_start-(bench_set.blocked_cycles-blocked_before);
+            }
+        }else{
+            busy_start=cycle_counter_get();
+            for(uint32_t i=0;i<bench_queue_count;i++){
+                bench_stats.queue_calls++;
+                if(xQueueReceive(bench_queues[i],&sent_at,0)==pdPASS){
+                    bench_record(sent_at);
+                }
+            }
+            bench_stats.busy_cycles+=cycle_counter_get()-busy_start;
+            vTaskDelay(1);
+        }
+    }
+}
+
+/**
+ * 基准控制任务（同时作为发送方）
+ * 对每种队列数量分别跑集合模式和轮询模式，随机选择目标队列发送带时间戳的消息
+ */
+void bench_controller_task(void *pvParameters){
+    static const uint32_t queue_counts[]={4,8,16,32,64};
+    uint32_t seed=1;
+
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    cycle_counter_init();
+
+    //创建64个队列，每次测试使用前N个
+    for(uint32_t i=0;i<QUEUE_SET_MAX_MEMBERS;i++){
+        bench_queues[i]=xQueueCreate(4,sizeof(uint32_t));
+        configASSERT(bench_queues[i]!=NULL);
+    }
+
+    printf("\n[性能测试] 队列集合 vs 轮询（每种配置%d条消息）\n", BENCH_MESSAGES);
+    printf("  队列数  方式  平均延迟   最大延迟   接收端CPU  队列API调用/消息 (%s)\n", CYCLE_UNIT);
+
+    for(uint32_t c=0;c<sizeof(queue_counts)/sizeof(queue_counts[0]);c++){
+        for(BaseType_t use_set=pdTRUE;use_set>=pdFALSE;use_set--){
+            bench_queue_count=queue_counts[c];
+            bench_use_set=use_set;
+            memset(&bench_stats,0,sizeof(bench_stats));
+
+            QueueSet_Init(&bench_set);
+            for(uint32_t i=0;i<bench_queue_count;i++){
+                QueueSet_Add(&bench_set,bench_queues[i]);
+            }
+
+            vTaskResume(bench_receiver_handle);
+
+            for(uint32_t m=0;m<BENCH_MESSAGES;m++){
+                uint32_t target;
+                uint32_t now;
+
+                seed=seed*1103515245+12345;
+                target=(seed>>16)%bench_queue_count;
+                now=cycle_counter_get();
+
+                if(use_set){
+                    QueueSet_Send(&bench_set,(int32_t)target,&now,portMAX_DELAY);
+                }else{
+                    xQueueSend(bench_queues[target],&now,portMAX_DELAY);
+                }
+                vTaskDelay(BENCH_SEND_PERIOD);
+            }
+
+            //等接收端收完，然后挂起它，切换下一种配置
+            ulTaskNotifyTake(pdTRUE,pdMS_TO_TICKS(5000));
+            vTaskSuspend(bench_receiver_handle);
+
+            printf("  %4lu    %s  %8lu  %9lu  %10lu  %8lu\n",
+                   bench_queue_count, use_set?"集合":"轮询",
+                   (uint32_t)(bench_stats.latency_total/(bench_stats.received?bench_stats.received:1)),
+                   bench_stats.latency_max,
+                   (uint32_t)bench_stats.busy_cycles,
+                   bench_stats.queue_calls/(bench_stats.received?bench_stats.received:1));
+        }
+    }
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("FreeRTOS Demo: 带就绪位图的队列集合\n");
+
+    data_queue=xQueueCreate(5,sizeof(uint32_t));
+    message_queue=xQueueCreate(10,sizeof(message_t));
+    sensor_queue=xQueueCreate(8,sizeof(sensor_data_t));
+    command_queue=xQueueCreate(5,sizeof(command_t));
+    if(data_queue==NULL||message_queue==NULL||sensor_queue==NULL||command_queue==NULL){
+        printf("队列创建失败!\n");
+        return -1;
+    }
+
+    //按优先级顺序加入集合
+    QueueSet_Init(&demo_set);
+    command_member=QueueSet_Add(&demo_set,command_queue);
+    message_member=QueueSet_Add(&demo_set,message_queue);
+    sensor_member=QueueSet_Add(&demo_set,sensor_queue);
+    data_member=QueueSet_Add(&demo_set,data_queue);
+
+    xTaskCreate(set_receiver_task, "SetRecv", 512, NULL, 3, NULL);
+    xTaskCreate(sender_task, "Sender", 256, NULL, 2, NULL);
+    xTaskCreate(sensor_task, "Sensor", 256, NULL, 2, NULL);
+    xTaskCreate(command_sender_task, "CmdSender", 256, NULL, 1, NULL);
+    xTaskCreate(interrupt_simulator_task, "IntSim", 256, NULL, 1, NULL);
+
+    //基准测试：接收任务先挂起，由控制任务按配置恢复
+    xTaskCreate(bench_receiver_task, "BenchRecv", 256, NULL, 4, &bench_receiver_handle);
+    vTaskSuspend(bench_receiver_handle);
+    xTaskCreate(bench_controller_task, "BenchCtrl", 512, NULL, 1, &bench_controller_handle);
+
+    printf("所有任务创建完成，启动调度器...\n");
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败!\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 为什么需要队列集合：
+   - 一个任务只能阻塞在一个队列上
+   - 轮询多个队列要么延迟大（带超时等待），要么浪费CPU（频繁空转）
+   - 集合让任务同时等待多个队列，任意一个来数据就唤醒
+
+2. 就绪位图：
+   - 每个成员一位，队列非空时置1
+   - 两级位图：先找非0的字，再找字里的最低位，两次CTZ指令
+   - 选择成本O(1)，和成员数量无关；轮询的成本是O(N)
+
+3. 竞争条件处理：
+   - 发送方：先入队再置位，保证置位时数据一定已经在队列里
+   - 接收方：出队后在临界段内"检查为空+清位"
+   - 等待方：先在临界段内登记，再阻塞在通知上，登记后的通知不会丢
+   - 位图偶尔会过期（显示就绪但已空），Receive返回失败并自动修正
+
+4. 与FreeRTOS原生xQueueCreateSet()的区别：
+   - 原生队列集合内部用一个"句柄队列"记录就绪顺序，需要预先计算长度
+   - 本实现用位图，不占用额外队列空间，并且天然按成员优先级选择
+
+5. 注意事项：
+   - 成员队列只能通过QueueSet_Send()发送，否则集合不知道它已就绪
+   - 同一时刻只允许一个任务在集合上等待
+*/
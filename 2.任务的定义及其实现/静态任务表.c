@@ -0,0 +1,361 @@
+/*
+ * Demo: 编译期静态任务表（任务、栈、优先级只声明一次）
+ * 学习要点：
+ * 1. demo4.c为每个任务手写一份StackType_t栈数组和StaticTask_t，再逐个调用xTaskCreateStatic；
+ *    5.支持多优先级/demo3.c、demo4.c和7.时间片调度机制/demo1.c又各写了一遍vApplicationGetIdleTaskMemory
+ * 2. X宏任务表：APP_TASK_TABLE每行一个任务（名称、函数、栈大小、优先级、是否热点），
+ *    同一张表展开成任务编号、栈存储、TCB槽位、放在Flash里的常量描述表和编译期检查
+ * 3. TCB布局：空闲任务和标为热点的任务的TCB排在同一个数组的开头，连续存放，
+ *    调度器频繁访问的TCB落在相邻的缓存行里；冷任务和定时器任务排在后面
+ * 4. 所有栈放在一个结构体里，RAM占用在链接时就确定，不依赖堆
+ * 5. 启动时TaskTable_CreateAll一个循环创建全部任务，本demo的空闲/定时器任务内存也从同一块存储里取
+ *    （其他demo各自是独立的程序，仍然各写各的vApplicationGetIdleTaskMemory，这里只演示做法）
+ * 6. 性能测试：表中任务静态创建与xTaskCreate动态创建的启动耗时、RAM占用和热点TCB地址跨度
+ *
+ * 对应场景：demo4.c的Controller_Task和Work1~3_Task
+ *
+ * 需要在FreeRTOSConfig.h中设置：
+ *   #define configSUPPORT_STATIC_ALLOCATION         1
+ *   #define configSUPPORT_DYNAMIC_ALLOCATION        1   （可选，只有性能测试的动态对比用到）
+ *   #define INCLUDE_uxTaskGetStackHighWaterMark     1
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include "../cycle_counter.h"
+
+#if (configSUPPORT_STATIC_ALLOCATION != 1)
+    #error "本demo需要configSUPPORT_STATIC_ALLOCATION为1"
+#endif
+
+
+// ==================== 任务表 ====================
+// 每行：名称, 任务函数, 栈大小(字), 优先级, 热点(0/1)
+// 热点：切换频繁、TCB经常被调度器访问的任务，TCB排在前面连续存放
+#define APP_TASK_TABLE(X) \
+    X(Controller,   Controller_Task,    512,    4,  1) \
+    X(Work1,        Work1_Task,         256,    2,  1) \
+    X(Work2,        Work2_Task,         256,    2,  1) \
+    X(Work3,        Work3_Task,         256,    2,  1) \
+    X(Monitor,      Monitor_Task,       384,    1,  0)
+
+
+// ==================== 由任务表展开 ====================
+//条件展开：TASK_IF(1, x)展开成x，TASK_IF(0, x)展开成空；多一层是为了先展开TASK_NOT
+#define TASK_IF_0(...)
+#define TASK_IF_1(...)                  __VA_ARGS__
+#define TASK_IF_(cond, ...)             TASK_IF_##cond(__VA_ARGS__)
+#define TASK_IF(cond, ...)              TASK_IF_(cond, __VA_ARGS__)
+#define TASK_NOT_0                      1
+#define TASK_NOT_1                      0
+#define TASK_NOT_(cond)                 TASK_NOT_##cond
+#define TASK_NOT(cond)                  TASK_NOT_(cond)
+
+//任务函数声明
+#define TASK_PROTOTYPE(name, fn, stack, prio, hot)      static void fn(void *pvParameters);
+APP_TASK_TABLE(TASK_PROTOTYPE)
+
+//编译期检查：栈太小、优先级越界、热点标记写错都在编译时报出来
+#define TASK_CHECK(name, fn, stack, prio, hot) \
+    _Static_assert((stack)>=configMINIMAL_STACK_SIZE, #name "的栈小于configMINIMAL_STACK_SIZE"); \
+    _Static_assert((prio)<configMAX_PRIORITIES, #name "的优先级超出configMAX_PRIORITIES"); \
+    _Static_assert((hot)==0||(hot)==1, #name "的热点标记只能是0或1");
+APP_TASK_TABLE(TASK_CHECK)
+
+//任务编号：TASK_ID_Controller...，按表中顺序
+#define TASK_ENUM_ID(name, fn, stack, prio, hot)        TASK_ID_##name,
+typedef enum{
+    APP_TASK_TABLE(TASK_ENUM_ID)
+    TASK_COUNT
+}TaskId_t;
+
+//TCB槽位：空闲任务、热点任务、冷任务、定时器任务
+#define TASK_HOT_SLOT(name, fn, stack, prio, hot)       TASK_IF(hot, TCB_SLOT_##name,)
+#define TASK_COLD_SLOT(name, fn, stack, prio, hot)      TASK_IF(TASK_NOT(hot), TCB_SLOT_##name,)
+#define TASK_COUNT_HOT(name, fn, stack, prio, hot)      +(hot)
+enum{
+    TCB_SLOT_IDLE,
+    APP_TASK_TABLE(TASK_HOT_SLOT)
+    APP_TASK_TABLE(TASK_COLD_SLOT)
+    TCB_SLOT_TIMER,
+    TCB_SLOT_COUNT
+};
+enum{
+    TCB_HOT_COUNT=1 APP_TASK_TABLE(TASK_COUNT_HOT)      //包括空闲任务
+};
+
+//表中任务的栈字节数，不含空闲/定时器任务
+#define TASK_STACK_BYTES(name, fn, stack, prio, hot)    +(stack)*sizeof(StackType_t)
+#define TASK_TABLE_STACK_BYTES          (0 APP_TASK_TABLE(TASK_STACK_BYTES))
+
+//栈存储：一个结构体，每个任务一个成员
+#define TASK_STACK_MEMBER(name, fn, stack, prio, hot)   StackType_t name[stack];
+static struct{
+    StackType_t idle[configMINIMAL_STACK_SIZE];
+    APP_TASK_TABLE(TASK_STACK_MEMBER)
+#if (configUSE_TIMERS == 1)
+    StackType_t timer[configTIMER_TASK_STACK_DEPTH];
+#endif
+}task_stacks;
+
+static StaticTask_t task_tcbs[TCB_SLOT_COUNT];
+TaskHandle_t task_handles[TASK_COUNT];
+
+//常量描述表，放在Flash里
+typedef struct{
+    TaskFunction_t function;
+    const char *name;
+    StackType_t *stack;
+    uint32_t stack_words;
+    UBaseType_t priority;
+    uint8_t tcb_slot;
+}StaticTaskDef_t;
+
+#define TASK_DEF(name, fn, stack, prio, hot) \
+    { fn, #name, task_stacks.name, (stack), (prio), TCB_SLOT_##name },
+static const StaticTaskDef_t task_defs[TASK_COUNT]={
+    APP_TASK_TABLE(TASK_DEF)
+};
+
+/**
+ * 创建任务表中的全部任务
+ * 功能：按表的顺序调用xTaskCreateStatic，存储都是编译期分配好的
+ * 返回：pdPASS成功
+ */
+BaseType_t TaskTable_CreateAll(void){
+    for(uint32_t i=0;i<TASK_COUNT;i++){
+        const StaticTaskDef_t *def=&task_defs[i];
+
+        task_handles[i]=xTaskCreateStatic(def->function, def->name, def->stack_words, NULL,
+                                          def->priority, def->stack, &task_tcbs[def->tcb_slot]);
+        if(task_handles[i]==NULL){
+            return pdFAIL;
+        }
+    }
+    return pdPASS;
+}
+
+/**
+ * 空闲任务内存
+ * 功能：TCB在热点区的第一个槽位，栈是task_stacks.idle
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize){
+    *ppxIdleTaskTCBBuffer=&task_tcbs[TCB_SLOT_IDLE];
+    *ppxIdleTaskStackBuffer=task_stacks.idle;
+    *pulIdleTaskStackSize=configMINIMAL_STACK_SIZE;
+}
+
+#if (configUSE_TIMERS == 1)
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize){
+    *ppxTimerTaskTCBBuffer=&task_tcbs[TCB_SLOT_TIMER];
+    *ppxTimerTaskStackBuffer=task_stacks.timer;
+    *pulTimerTaskStackSize=configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
+
+// ==================== 任务（demo4.c） ====================
+typedef enum{
+    TASK_STATE_RUNNING,
+    TASK_STATE_SUSPENDED
+}TaskState_t;
+
+static TaskState_t work_state[3]={ TASK_STATE_RUNNING, TASK_STATE_RUNNING, TASK_STATE_RUNNING };
+static volatile uint32_t work_run_count[3];
+static volatile uint32_t control_mode=0;
+
+//Work1~3在表里是相邻的，编号连续
+static void set_work_running(uint8_t index, BaseType_t running){
+    TaskHandle_t handle=task_handles[TASK_ID_Work1+index];
+
+    if(running&&work_state[index]==TASK_STATE_SUSPENDED){
+        vTaskResume(handle);
+        work_state[index]=TASK_STATE_RUNNING;
+    }else if(!running&&work_state[index]==TASK_STATE_RUNNING){
+        vTaskSuspend(handle);
+        work_state[index]=TASK_STATE_SUSPENDED;
+    }
+}
+
+static void Controller_Task(void *pvParameters){
+    uint32_t control_cycle=0;
+
+    for(;;){
+        control_cycle++;
+
+        //每10个周期改变一次控制模式
+        if(control_cycle%10==0){
+            control_mode=(control_mode+1)%3;
+            for(uint8_t i=0;i<3;i++){
+                switch(control_mode){
+                    case 0:     //全部运行
+                        set_work_running(i,pdTRUE);
+                        break;
+                    case 1:     //暂停Worker2
+                        set_work_running(i,i!=1);
+                        break;
+                    default:    //轮流只运行一个
+                        set_work_running(i,i==(control_cycle/10)%3);
+                        break;
+                }
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+static void work_loop(uint8_t index, uint32_t period_ms){
+    for(;;){
+        work_run_count[index]++;
+        vTaskDelay(pdMS_TO_TICKS(period_ms));
+    }
+}
+
+static void Work1_Task(void *pvParameters){
+    work_loop(0,300);
+}
+
+static void Work2_Task(void *pvParameters){
+    work_loop(1,500);
+}
+
+static void Work3_Task(void *pvParameters){
+    work_loop(2,700);
+}
+
+//监控：遍历任务表打印运行情况和栈余量，按表调整栈大小
+static void Monitor_Task(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(5000));
+        printf("\n[监控] 模式%lu 工作计数 %lu/%lu/%lu\n", control_mode,
+               work_run_count[0], work_run_count[1], work_run_count[2]);
+        for(uint32_t i=0;i<TASK_COUNT;i++){
+            printf("  %-10s 优先级%lu 栈%lu字 剩余%lu字\n", task_defs[i].name,
+                   (uint32_t)task_defs[i].priority, task_defs[i].stack_words,
+                   (uint32_t)uxTaskGetStackHighWaterMark(task_handles[i]));
+        }
+    }
+}
+
+
+// ==================== 性能测试 ====================
+// 在调度器启动前测：静态创建整张表，再用xTaskCreate按同样的参数动态创建一遍
+// 动态的副本用空闲优先级创建，不会成为当前任务，测完立即删除，堆内存马上归还
+// 两边都只算表中的任务：空闲/定时器任务动态分配时在vTaskStartScheduler里才创建，不在比较范围内
+static void bench_startup(uint32_t static_cycles){
+    size_t static_bytes=TASK_TABLE_STACK_BYTES+TASK_COUNT*sizeof(StaticTask_t);
+    uintptr_t static_lo=UINTPTR_MAX,static_hi=0;
+
+    //静态TCB的实际地址，只看表中的热点任务（不含空闲任务，和动态一侧一致）
+    for(uint32_t i=0;i<TASK_COUNT;i++){
+        if(task_defs[i].tcb_slot<TCB_HOT_COUNT){
+            uintptr_t addr=(uintptr_t)&task_tcbs[task_defs[i].tcb_slot];
+            if(addr<static_lo){
+                static_lo=addr;
+            }
+            if(addr>static_hi){
+                static_hi=addr;
+            }
+        }
+    }
+
+    printf("\n[性能测试] 静态任务表与动态创建（%d个任务，不含空闲/定时器任务）\n", TASK_COUNT);
+    printf("  静态：创建耗时%lu %s，RAM %lu字节（栈%lu + TCB%lu，链接时确定），热点TCB（%d个）跨度%lu字节\n",
+           static_cycles, CYCLE_UNIT, (uint32_t)static_bytes, (uint32_t)TASK_TABLE_STACK_BYTES,
+           (uint32_t)(TASK_COUNT*sizeof(StaticTask_t)), TCB_HOT_COUNT-1,
+           (uint32_t)(static_hi-static_lo+sizeof(StaticTask_t)));
+    printf("  另有空闲/定时器任务的栈和TCB %lu字节，也在同一块静态存储里\n",
+           (uint32_t)(sizeof(task_stacks)+sizeof(task_tcbs)-static_bytes));
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    {
+        TaskHandle_t dynamic[TASK_COUNT];
+        size_t before,dynamic_bytes;
+        uintptr_t lo=UINTPTR_MAX,hi=0;
+        uint32_t start,dynamic_cycles;
+
+        before=xPortGetFreeHeapSize();
+        start=cycle_counter_get();
+        for(uint32_t i=0;i<TASK_COUNT;i++){
+            const StaticTaskDef_t *def=&task_defs[i];
+            if(xTaskCreate(def->function,def->name,(uint16_t)def->stack_words,NULL,tskIDLE_PRIORITY,&dynamic[i])!=pdPASS){
+                printf("[性能测试] 堆不够动态创建%s\n", def->name);
+                for(uint32_t j=0;j<i;j++){
+                    vTaskDelete(dynamic[j]);
+                }
+                return;
+            }
+        }
+        dynamic_cycles=cycle_counter_get()-start;
+        dynamic_bytes=before-xPortGetFreeHeapSize();
+
+        //句柄就是TCB的地址，看热点任务的TCB分散在多大的范围里
+        for(uint32_t i=0;i<TASK_COUNT;i++){
+            if(task_defs[i].tcb_slot<TCB_HOT_COUNT){
+                uintptr_t addr=(uintptr_t)dynamic[i];
+                if(addr<lo){
+                    lo=addr;
+                }
+                if(addr>hi){
+                    hi=addr;
+                }
+            }
+        }
+        for(uint32_t i=0;i<TASK_COUNT;i++){
+            vTaskDelete(dynamic[i]);
+        }
+
+        printf("  动态：创建耗时%lu %s，从堆取%lu字节（含堆块头），热点TCB跨度%lu字节（TCB和栈交错分配）\n",
+               dynamic_cycles, CYCLE_UNIT, (uint32_t)dynamic_bytes, (uint32_t)(hi-lo+sizeof(StaticTask_t)));
+    }
+#endif
+}
+
+
+int main(void){
+    uint32_t start,static_cycles;
+
+    cycle_counter_init();
+
+    start=cycle_counter_get();
+    if(TaskTable_CreateAll()!=pdPASS){
+        printf("任务创建失败\n");
+        return -1;
+    }
+    static_cycles=cycle_counter_get()-start;
+
+    bench_startup(static_cycles);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. X宏：
+   - 任务只在APP_TASK_TABLE里写一次，编号、栈、TCB、描述表、检查全部由它展开
+   - 增删任务只改一行，不会出现栈数组和xTaskCreateStatic参数对不上的情况
+
+2. 编译期保证：
+   - 栈太小、优先级越界在编译时报错
+   - 所有栈和TCB的大小在链接时确定，map文件里能直接看到，运行时不会因为堆不够而创建失败
+
+3. TCB布局：
+   - 热点任务和空闲任务的TCB连续存放，上下文切换时访问的TCB集中在少数缓存行
+   - 动态创建时TCB和栈交替从堆里分配，相邻任务的TCB之间隔着整个栈
+
+4. 空闲/定时器任务：
+   - 本demo的vApplicationGetIdleTaskMemory/vApplicationGetTimerTaskMemory从任务表的同一块存储里取
+   - 仓库里每个demo都是独立的程序，各自定义这两个钩子；这里只演示写法，并没有替换其他demo里的定义
+
+5. 启动：
+   - TaskTable_CreateAll一个循环创建全部任务，静态创建没有堆分配，耗时更短也更确定
+*/
@@ -0,0 +1,541 @@
+/*
+ * Demo: 延迟日志（格式串ID + 二进制参数，无锁环形缓冲区）
+ * 学习要点：
+ * 1. 各个demo里到处直接调用printf：demo1.c的转账函数甚至在临界段里printf，
+ *    串口115200波特率下一行40个字符要阻塞3.5ms，期间中断被屏蔽、其他任务全部等待
+ * 2. 延迟日志：调用点只记录"格式串地址 + 时间戳 + 参数的二进制值"，几十个周期；
+ *    格式化和串口输出交给最低优先级的日志任务（或者直接把原始记录发给上位机，由上位机格式化）
+ * 3. 格式串地址就是ID：字符串常量在Flash里地址固定，不需要注册；上位机可以从ELF文件查到字符串
+ * 4. 无锁多生产者环形缓冲区（Vyukov有界队列）：每个槽有序号，生产者用比较交换抢位置，
+ *    任务、中断、临界段里都能调用，不会阻塞；缓冲区满时丢弃并计数
+ * 5. 每个核一个环形缓冲区（SMP时），日志任务按时间戳合并；各核的DWT计数器互相不同步，
+ *    跨核的先后顺序只是近似的，同一个核内的顺序是准确的
+ * 6. 性能测试：每次日志调用的开销，LOG与snprintf（只格式化不输出）对比，以及串口输出的阻塞时间估算
+ *
+ * 对应场景：demo1.c的vBankTask*和safe_transfer_money，demo10.c的定时器回调，
+ *          demo5.c的custom_task_delay/TickMonitorTask
+ *
+ * 参数类型用C11的_Generic自动识别：整数、float/double、字符串（必须是常量或静态存储的字符串，
+ * 日志任务格式化时才读取内容）、指针
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 日志记录与环形缓冲区 ====================
+#define LOG_MAX_ARGS        6
+#define LOG_RING_SLOTS      128     //必须是2的幂
+#define LOG_LINE_MAX        160
+#define LOG_FLUSH_PERIOD_MS 20
+#define LOG_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+
+#if (LOG_RING_SLOTS & (LOG_RING_SLOTS-1)) != 0
+#error "LOG_RING_SLOTS必须是2的幂"
+#endif
+
+//SMP移植每个核一个缓冲区，生产者只和同一个核上的生产者竞争
+#if defined(configNUMBER_OF_CORES) && (configNUMBER_OF_CORES > 1)
+#define LOG_CORES           configNUMBER_OF_CORES
+#define LOG_CORE_ID()       portGET_CORE_ID()
+#else
+#define LOG_CORES           1
+#define LOG_CORE_ID()       0
+#endif
+
+typedef uintptr_t LogArg_t;         //整数、float的位模式、字符串指针都放得下
+
+typedef struct{
+    volatile uint32_t seq;          //槽序号：等于pos时可写，等于pos+1时可读
+    uint32_t timestamp;
+    const char *fmt;                //格式串地址，同时就是日志ID
+    uint8_t nargs;
+    uint8_t core;
+    LogArg_t args[LOG_MAX_ARGS];
+}LogSlot_t;
+
+typedef struct{
+    volatile uint32_t head;         //生产者抢占的下一个位置
+    uint32_t tail;                  //只有日志任务访问
+    volatile uint32_t dropped;      //缓冲区满丢弃的条数
+    LogSlot_t slot[LOG_RING_SLOTS];
+}LogRing_t;
+
+static LogRing_t log_rings[LOG_CORES];
+
+/**
+ * 比较交换：*ptr等于*expected时写入desired并返回1，否则把当前值写回*expected并返回0
+ * Cortex-M3及以上、主机用LDREX/STREX或者CAS指令；Cortex-M0没有独占访问指令，短暂屏蔽中断
+ */
+#if defined(__ARM_ARCH_6M__)
+static inline int log_cas(volatile uint32_t *ptr, uint32_t *expected, uint32_t desired){
+    UBaseType_t mask=portSET_INTERRUPT_MASK_FROM_ISR();     //任务和中断里都可以用
+    int ok=(*ptr==*expected);
+    if(ok){
+        *ptr=desired;
+    }else{
+        *expected=*ptr;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+    return ok;
+}
+#else
+static inline int log_cas(volatile uint32_t *ptr, uint32_t *expected, uint32_t desired){
+    return __atomic_compare_exchange_n(ptr,expected,desired,0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE);
+}
+#endif
+
+void log_ring_init(LogRing_t *ring){
+    memset(ring,0,sizeof(LogRing_t));
+    for(uint32_t i=0;i<LOG_RING_SLOTS;i++){
+        ring->slot[i].seq=i;
+    }
+}
+
+/**
+ * 写一条日志记录
+ * 功能：抢一个槽，写入时间戳、格式串地址和参数，最后发布序号；不加锁、不阻塞
+ * 参数：fmt 格式串（必须是字符串常量）；nargs 参数个数；args 参数
+ * 返回：pdPASS成功；缓冲区满返回pdFAIL
+ * 注意：任务、中断、临界段中都可以调用
+ */
+BaseType_t log_write_ring(LogRing_t *ring, const char *fmt, uint32_t nargs, const LogArg_t *args){
+    uint32_t pos=ring->head;
+    LogSlot_t *slot;
+
+    for(;;){
+        uint32_t seq;
+        slot=&ring->slot[pos&(LOG_RING_SLOTS-1)];
+        seq=__atomic_load_n(&slot->seq,__ATOMIC_ACQUIRE);
+
+        if(seq==pos){
+            //槽空闲，抢位置；失败时pos被更新为最新的head，重试
+            if(log_cas(&ring->head,&pos,pos+1)){
+                break;
+            }
+        }else if((int32_t)(seq-pos)<0){
+            //槽还没被日志任务取走：缓冲区满
+            uint32_t dropped=ring->dropped;
+            while(!log_cas(&ring->dropped,&dropped,dropped+1)){
+            }
+            return pdFAIL;
+        }else{
+            pos=ring->head;     //被别的生产者抢先了
+        }
+    }
+
+    slot->timestamp=cycle_counter_get();
+    slot->fmt=fmt;
+    slot->nargs=(uint8_t)(nargs>LOG_MAX_ARGS?LOG_MAX_ARGS:nargs);
+    slot->core=(uint8_t)LOG_CORE_ID();
+    for(uint32_t i=0;i<slot->nargs;i++){
+        slot->args[i]=args[i];
+    }
+    __atomic_store_n(&slot->seq,pos+1,__ATOMIC_RELEASE);     //发布：日志任务看到序号后才读内容
+    return pdPASS;
+}
+
+static inline BaseType_t log_write(const char *fmt, uint32_t nargs, const LogArg_t *args){
+    return log_write_ring(&log_rings[LOG_CORE_ID()],fmt,nargs,args);
+}
+
+/**
+ * 取一条记录（只有日志任务调用）
+ * 返回：pdPASS取到；缓冲区空或者下一条还没写完返回pdFAIL
+ */
+BaseType_t log_read_ring(LogRing_t *ring, LogSlot_t *out){
+    LogSlot_t *slot=&ring->slot[ring->tail&(LOG_RING_SLOTS-1)];
+
+    if(__atomic_load_n(&slot->seq,__ATOMIC_ACQUIRE)!=ring->tail+1){
+        return pdFAIL;
+    }
+    *out=*slot;
+    __atomic_store_n(&slot->seq,ring->tail+LOG_RING_SLOTS,__ATOMIC_RELEASE);     //还给生产者，下一圈再用
+    ring->tail++;
+    return pdPASS;
+}
+
+
+// ==================== 调用点的宏 ====================
+static inline LogArg_t log_arg_int(uintptr_t v){ return v; }
+static inline LogArg_t log_arg_float(float f){ uint32_t u; memcpy(&u,&f,sizeof(u)); return u; }
+static inline LogArg_t log_arg_double(double d){ return log_arg_float((float)d); }
+static inline LogArg_t log_arg_ptr(const void *p){ return (uintptr_t)p; }
+
+#define LOG_ARG(x) _Generic((x),                                    \
+    float: log_arg_float, double: log_arg_double,                   \
+    char*: log_arg_ptr, const char*: log_arg_ptr,                   \
+    void*: log_arg_ptr, const void*: log_arg_ptr,                   \
+    default: log_arg_int)(x)
+
+#define LOG_NARGS(...)      LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, N, ...) N
+#define LOG_CAT(a, b)       LOG_CAT_(a, b)
+#define LOG_CAT_(a, b)      a##b
+#define LOG_ARGS_0()
+#define LOG_ARGS_1(a)                   , LOG_ARG(a)
+#define LOG_ARGS_2(a, b)                , LOG_ARG(a), LOG_ARG(b)
+#define LOG_ARGS_3(a, b, c)             , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c)
+#define LOG_ARGS_4(a, b, c, d)          , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d)
+#define LOG_ARGS_5(a, b, c, d, e)       , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e)
+#define LOG_ARGS_6(a, b, c, d, e, f)    , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e), LOG_ARG(f)
+
+/**
+ * LOG(fmt, ...)：用法和printf一样，最多6个参数
+ * 参数数组的第0个元素是占位，保证没有参数时初始化列表也不为空
+ */
+#define LOG_TO(ring, fmt, ...)                                                          \
+    log_write_ring((ring), (fmt), LOG_NARGS(__VA_ARGS__),                               \
+                   &((const LogArg_t[]){ 0 LOG_CAT(LOG_ARGS_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__) })[1])
+#define LOG(fmt, ...)                                                                   \
+    log_write((fmt), LOG_NARGS(__VA_ARGS__),                                            \
+              &((const LogArg_t[]){ 0 LOG_CAT(LOG_ARGS_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__) })[1])
+
+
+// ==================== 格式化（日志任务或上位机） ====================
+static inline float log_float(LogArg_t a){
+    uint32_t u=(uint32_t)a;
+    float f;
+    memcpy(&f,&u,sizeof(f));
+    return f;
+}
+
+/**
+ * 按格式串把一条记录格式化成文本
+ * 功能：逐个解析转换说明，长度修饰符统一换成l，按转换字符取出对应类型的参数交给snprintf
+ * 返回：写入的字符数
+ */
+uint32_t log_format(const LogSlot_t *rec, char *buf, uint32_t size){
+    const char *f=rec->fmt;
+    uint32_t len=0,arg=0;
+
+    while(*f&&len+1<size){
+        char spec[16];
+        uint32_t s=0;
+        LogArg_t value;
+        int n;
+
+        if(*f!='%'){
+            buf[len++]=*f++;
+            continue;
+        }
+        if(f[1]=='%'){
+            buf[len++]='%';
+            f+=2;
+            continue;
+        }
+
+        //复制标志、宽度、精度，去掉长度修饰符
+        spec[s++]=*f++;
+        while(*f&&strchr("-+ #0123456789.hlzjt",*f)){
+            if(!strchr("hlzjt",*f)&&s<sizeof(spec)-3){
+                spec[s++]=*f;
+            }
+            f++;
+        }
+        if(*f=='\0'){
+            break;
+        }
+        value=(arg<rec->nargs)?rec->args[arg]:0;
+        arg++;
+
+        switch(*f){
+        case 'd': case 'i':
+            spec[s++]='l'; spec[s++]=*f; spec[s]='\0';
+            n=snprintf(buf+len,size-len,spec,(long)(int32_t)value);
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            spec[s++]='l'; spec[s++]=*f; spec[s]='\0';
+            n=snprintf(buf+len,size-len,spec,(unsigned long)(uint32_t)value);
+            break;
+        case 'c':
+            spec[s++]='c'; spec[s]='\0';
+            n=snprintf(buf+len,size-len,spec,(int)value);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            spec[s++]=*f; spec[s]='\0';
+            n=snprintf(buf+len,size-len,spec,(double)log_float(value));
+            break;
+        case 's':
+            spec[s++]='s'; spec[s]='\0';
+            n=snprintf(buf+len,size-len,spec,value?(const char*)value:"(null)");
+            break;
+        case 'p':
+            spec[s++]='p'; spec[s]='\0';
+            n=snprintf(buf+len,size-len,spec,(void*)value);
+            break;
+        default:
+            n=0;            //不支持的转换，丢掉
+            break;
+        }
+        f++;
+        if(n>0){
+            len+=((uint32_t)n<size-len)?(uint32_t)n:size-len-1;
+        }
+    }
+    buf[len]='\0';
+    return len;
+}
+
+/**
+ * 日志任务：最低优先级，周期性把各核的缓冲区按时间戳合并输出
+ * 实际项目中输出换成UART/USB/RTT；也可以不格式化，直接把原始记录发给上位机
+ */
+void LogTask(void *pvParameters){
+    static char line[LOG_LINE_MAX];
+    uint32_t reported_drops[LOG_CORES]={0};
+
+    for(;;){
+        for(;;){
+            LogSlot_t rec,candidate;
+            int32_t best=-1;
+
+            //取各核缓冲区头部时间戳最早的一条（只看一眼，不取走）
+            //时间戳来自各核自己的周期计数器，计数器之间没有同步，跨核排序只是近似
+            for(uint32_t c=0;c<LOG_CORES;c++){
+                LogRing_t *ring=&log_rings[c];
+                LogSlot_t *slot=&ring->slot[ring->tail&(LOG_RING_SLOTS-1)];
+                if(__atomic_load_n(&slot->seq,__ATOMIC_ACQUIRE)==ring->tail+1&&
+                   (best<0||(int32_t)(slot->timestamp-candidate.timestamp)<0)){
+                    candidate.timestamp=slot->timestamp;
+                    best=(int32_t)c;
+                }
+            }
+            if(best<0||log_read_ring(&log_rings[best],&rec)!=pdPASS){
+                break;
+            }
+            log_format(&rec,line,sizeof(line));
+            printf("[%10lu] %s", (uint32_t)rec.timestamp, line);
+        }
+
+        for(uint32_t c=0;c<LOG_CORES;c++){
+            uint32_t dropped=log_rings[c].dropped;
+            if(dropped!=reported_drops[c]){
+                printf("[日志] 核%lu丢弃了%lu条\n", c, dropped-reported_drops[c]);
+                reported_drops[c]=dropped;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(LOG_FLUSH_PERIOD_MS));
+    }
+}
+
+
+// ==================== 银行转账（demo1.c改用LOG） ====================
+typedef struct {
+    uint32_t account_id;        //账户ID
+    volatile int32_t balance;   //账户余额
+    char owner_name[32];        //账户持有人姓名
+    uint32_t transaction_count; //该账户的交易次数
+} BankAccount_t;
+
+BankAccount_t g_accounts[4] = {
+    {1001, 10000, "张三", 0},
+    {1002, 5000,  "李四", 0},
+    {1003, 8000,  "王五", 0},
+    {1004, 15000, "赵六", 0}
+};
+
+static volatile uint32_t g_total_transactions;
+
+BankAccount_t* find_account(uint32_t account_id){
+    for(int i=0;i<4;i++){
+        if(g_accounts[i].account_id==account_id){
+            return &g_accounts[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * 转账：临界段里只记录日志，不再等串口
+ * owner_name在全局数组里，是静态存储，可以用%s
+ */
+int safe_transfer_money(uint32_t from_id, uint32_t to_id, int32_t amount){
+    BankAccount_t *from_account=find_account(from_id);
+    BankAccount_t *to_account=find_account(to_id);
+    int result;
+
+    if(!from_account||!to_account||amount<=0||from_id==to_id){
+        LOG("转账失败: 参数错误 (从:%lu 到:%lu)\n", from_id, to_id);
+        return -1;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        g_total_transactions++;
+        if(from_account->balance>=amount){
+            from_account->balance-=amount;
+            to_account->balance+=amount;
+            from_account->transaction_count++;
+            to_account->transaction_count++;
+
+            LOG("转账成功: %s->%s, 金额:%ld, 交易#%lu\n",
+                from_account->owner_name, to_account->owner_name, amount, g_total_transactions);
+            LOG("   %s余额: %ld, %s余额: %ld\n",
+                from_account->owner_name, from_account->balance, to_account->owner_name, to_account->balance);
+            result=0;
+        }else{
+            LOG("转账失败: %s余额不足 (需要:%ld, 余额:%ld)\n",
+                from_account->owner_name, amount, from_account->balance);
+            result=-1;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+void vBankTask1(void *pvParameters){
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+    const TickType_t xFrequency=pdMS_TO_TICKS(1500);
+
+    LOG("银行任务1启动 - 执行常规转账\n");
+
+    while(1){
+        safe_transfer_money(1001,1002,200);
+        vTaskDelayUntil(&xLastWakeTime,xFrequency);
+        safe_transfer_money(1003,1004,300);
+        vTaskDelayUntil(&xLastWakeTime,xFrequency);
+        safe_transfer_money(1004,1001,150);
+        vTaskDelayUntil(&xLastWakeTime,xFrequency);
+    }
+}
+
+void vBankTask2(void *pvParameters){
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+    const TickType_t xFrequency=pdMS_TO_TICKS(2000);
+
+    LOG("银行任务2启动 - 执行大额转账\n");
+
+    while(1){
+        safe_transfer_money(1002,1003,500);
+        vTaskDelayUntil(&xLastWakeTime,xFrequency);
+        safe_transfer_money(1004,1002,800);
+        vTaskDelayUntil(&xLastWakeTime,xFrequency);
+        safe_transfer_money(1001,1004,2000);
+        vTaskDelayUntil(&xLastWakeTime,xFrequency);
+    }
+}
+
+//定时器回调在守护任务里执行，printf阻塞会拖慢所有定时器；LOG不会（demo10.c的periodic_data_callback）
+void periodic_data_callback(TimerHandle_t xTimer){
+    static uint32_t periodic_counter=0;
+    float temperature=20.0f+(float)(periodic_counter%20);
+    float humidity=50.0f+(float)(periodic_counter%30);
+
+    periodic_counter++;
+    LOG("[数据采集]第%lu次采集 - 温度:%.1f°C 湿度:%.1f%%\n", periodic_counter, temperature, humidity);
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_BATCH         64      //每批调用次数，小于缓冲区槽数，批间由测试任务自己取空
+#define BENCH_BATCHES       200
+#define BENCH_UART_BAUD     115200
+
+static LogRing_t bench_ring;
+static char bench_line[LOG_LINE_MAX];
+static volatile uint32_t bench_sink;
+
+void bench_task(void *pvParameters){
+    const char *name=g_accounts[0].owner_name;
+    uint32_t log_cycles=0,snprintf_cycles=0,format_cycles=0,chars=0;
+    uint32_t total=BENCH_BATCH*BENCH_BATCHES;
+
+    vTaskDelay(pdMS_TO_TICKS(8000));
+    log_ring_init(&bench_ring);
+
+    for(uint32_t b=0;b<BENCH_BATCHES;b++){
+        uint32_t start;
+        LogSlot_t rec;
+
+        //调用点：LOG
+        start=cycle_counter_get();
+        for(uint32_t i=0;i<BENCH_BATCH;i++){
+            LOG_TO(&bench_ring,"转账成功: %s->%s, 金额:%ld, 交易#%lu 温度:%.1f\n", name, name, (int32_t)i, b, 25.5f);
+        }
+        log_cycles+=cycle_counter_get()-start;
+
+        //日志任务里的格式化：这部分开销从调用点移走了
+        start=cycle_counter_get();
+        while(log_read_ring(&bench_ring,&rec)==pdPASS){
+            chars+=log_format(&rec,bench_line,sizeof(bench_line));
+            bench_sink+=(uint8_t)bench_line[0];
+        }
+        format_cycles+=cycle_counter_get()-start;
+
+        //调用点：只格式化不输出的snprintf，是printf开销的下限
+        start=cycle_counter_get();
+        for(uint32_t i=0;i<BENCH_BATCH;i++){
+            snprintf(bench_line,sizeof(bench_line),"转账成功: %s->%s, 金额:%ld, 交易#%lu 温度:%.1f\n",
+                     name, name, (long)i, (unsigned long)b, 25.5);
+            bench_sink+=(uint8_t)bench_line[0];
+        }
+        snprintf_cycles+=cycle_counter_get()-start;
+    }
+
+    printf("\n[性能测试] %lu次日志调用，平均每行%lu字节\n", total, chars/total);
+    printf("  调用点LOG              %8lu %s/次\n", log_cycles/total, CYCLE_UNIT);
+    printf("  调用点snprintf         %8lu %s/次（printf的下限，还不算输出）\n", snprintf_cycles/total, CYCLE_UNIT);
+    printf("  日志任务格式化         %8lu %s/次（移到最低优先级任务里）\n", format_cycles/total, CYCLE_UNIT);
+    printf("  串口输出(%d波特)    %8lu us/次（阻塞式printf在调用点等待的时间）\n",
+           BENCH_UART_BAUD, (uint32_t)((uint64_t)(chars/total)*10*1000000/BENCH_UART_BAUD));
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    TimerHandle_t data_timer;
+
+    //LOG用周期计数器打时间戳，必须在第一次LOG之前使能
+    cycle_counter_init();
+    for(uint32_t c=0;c<LOG_CORES;c++){
+        log_ring_init(&log_rings[c]);
+    }
+
+    data_timer=xTimerCreate("DataTimer",pdMS_TO_TICKS(1000),pdTRUE,NULL,periodic_data_callback);
+    if(data_timer!=NULL){
+        xTimerStart(data_timer,0);
+    }
+
+    xTaskCreate(LogTask, "Log", 512, NULL, LOG_TASK_PRIORITY, NULL);
+    xTaskCreate(vBankTask1, "BankTask1", configMINIMAL_STACK_SIZE*2, NULL, tskIDLE_PRIORITY+2, NULL);
+    xTaskCreate(vBankTask2, "BankTask2", configMINIMAL_STACK_SIZE*2, NULL, tskIDLE_PRIORITY+3, NULL);
+    xTaskCreate(bench_task, "Bench", 512, NULL, tskIDLE_PRIORITY+4, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. printf的代价不只是格式化：
+   - 阻塞式串口输出一行要几毫秒，调用任务在这段时间里什么也做不了
+   - 在临界段里printf，中断被屏蔽几毫秒；多个任务printf还会互相等待串口
+
+2. 延迟日志：
+   - 调用点：抢一个槽，写时间戳、格式串地址和几个参数，没有格式化、没有锁
+   - 日志任务：在空闲时间格式化输出，缓冲区满时丢弃并计数，不会反过来拖住调用点
+
+3. 无锁环形缓冲区：
+   - 每个槽的序号表示状态：可写(pos)、已写好(pos+1)、已读(pos+槽数)
+   - 生产者先比较交换抢位置，再写内容，最后发布序号；被抢占也不会破坏其他生产者的记录
+   - 只有一个消费者（日志任务），tail不需要原子操作
+
+4. 格式串地址当ID：
+   - 字符串常量不需要注册，调用点只存一个指针
+   - %s参数只存指针，所以只能是常量或静态存储的字符串
+
+5. 多核：
+   - 每个核一个缓冲区，生产者只和本核竞争；日志任务按时间戳合并
+   - 每个核的DWT计数器各自计数、互不同步，合并出的跨核顺序是近似的；
+     需要精确顺序时改用全局时间源（共享的硬件定时器）打时间戳
+*/
@@ -0,0 +1,478 @@
+/*
+ * Demo: Tick中断剖析与预算（分阶段计时 + 直方图 + 超预算事件 + 钩子工作延后）
+ * 学习要点：
+ * 1. demo5.c的vApplicationTickHook()在SysTick中断里执行，和xTaskIncrementTick()的延时列表处理挨着，
+ *    钩子里多做一点、同一个tick到期的任务多几个，tick中断就会超出预算，推迟所有更低优先级的中断
+ * 2. 分阶段计时：SysTick_Handler包一层测总时间，跟踪宏traceTASK_INCREMENT_TICK标记进入内核，
+ *    traceMOVED_TASK_TO_READY_STATE标记延时到期的任务移入就绪列表，钩子前后各打一次时间戳
+ *    总时间 = 内核记账 + 唤醒到期任务 + tick钩子
+ * 3. 对数直方图：每个桶是一个2的幂区间，一次加法就能记录，能看出长尾（p99/最大值），不只是平均值
+ * 4. 超预算事件：总时间超过TICK_BUDGET_US时记下当时的各阶段时间，通知监控任务
+ * 5. 钩子工作分级：紧急的（计数、喂狗）留在中断里；不紧急的（统计、计算）在中断里只置一个挂起位，
+ *    交给守护任务执行，多次挂起合并成一次
+ * 6. 性能测试：16个每1~16 tick醒一次的任务 + 一个耗时的统计钩子，钩子在中断里执行与延后执行的对比
+ *
+ * 对应场景：demo5.c的vApplicationTickHook和TickMonitorTask
+ *
+ * 需要在FreeRTOSConfig.h中设置：
+ *   #define configUSE_TICK_HOOK 1
+ *   extern void tick_profile_kernel_enter(void);
+ *   extern void tick_profile_task_ready(void);
+ *   #define traceTASK_INCREMENT_TICK(xTickCount)    tick_profile_kernel_enter()
+ *   #define traceMOVED_TASK_TO_READY_STATE(pxTCB)   tick_profile_task_ready()
+ * Cortex-M上不要把xPortSysTickHandler映射成SysTick_Handler，本文件自己定义SysTick_Handler包住它；
+ * 主机（POSIX移植）的tick在信号处理函数里，没法包，总时间从进入内核量到钩子结束
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include "../cycle_counter.h"
+
+#if (configUSE_TICK_HOOK == 0)
+    #error "本demo需要configUSE_TICK_HOOK为1"
+#endif
+
+
+// ==================== 对数直方图 ====================
+#define TICK_HIST_BUCKETS   16
+#define TICK_HIST_SHIFT     4       //第0个桶是[0,16)，第k个桶是[2^(k+3),2^(k+4))，最后一个桶不封顶
+
+typedef struct{
+    uint32_t bucket[TICK_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+}TickHistogram_t;
+
+static inline void hist_add(TickHistogram_t *hist, uint32_t value){
+    uint32_t k=value?(32-(uint32_t)__builtin_clz(value)):0;
+
+    k=(k>TICK_HIST_SHIFT)?(k-TICK_HIST_SHIFT):0;
+    if(k>=TICK_HIST_BUCKETS){
+        k=TICK_HIST_BUCKETS-1;
+    }
+    hist->bucket[k]++;
+    hist->count++;
+    hist->sum+=value;
+    if(value>hist->max){
+        hist->max=value;
+    }
+}
+
+/**
+ * 从直方图估计分位数
+ * 返回：分位数所在桶的上界（保守估计），最后一个桶返回最大值
+ */
+static uint32_t hist_percentile(const TickHistogram_t *hist, uint32_t percent){
+    uint32_t target=(uint32_t)(((uint64_t)hist->count*percent+99)/100);
+    uint32_t seen=0;
+
+    for(uint32_t k=0;k<TICK_HIST_BUCKETS;k++){
+        seen+=hist->bucket[k];
+        if(seen>=target&&seen>0){
+            uint32_t upper=(k==TICK_HIST_BUCKETS-1)?hist->max:(1UL<<(k+TICK_HIST_SHIFT));
+            return (upper<hist->max)?upper:hist->max;
+        }
+    }
+    return hist->max;
+}
+
+
+// ==================== Tick中断剖析 ====================
+#define TICK_BUDGET_US      20
+#define TICK_BUDGET         ((uint32_t)(CYCLES_PER_SECOND/1000000*TICK_BUDGET_US))
+
+enum{ PHASE_TOTAL=0, PHASE_KERNEL, PHASE_WAKE, PHASE_HOOK, PHASE_COUNT };
+
+typedef struct{
+    TickType_t tick;
+    uint32_t phase[PHASE_COUNT];
+    uint32_t woken;
+}TickSample_t;
+
+typedef struct{
+    //当前这次中断的时间戳，只在tick中断里访问
+    uint8_t in_tick;
+    uint32_t t_enter;               //进入SysTick_Handler（主机上是进入内核）
+    uint32_t t_first_ready;         //第一个到期任务移入就绪列表
+    uint32_t t_last_ready;          //最后一个到期任务移入就绪列表
+    uint32_t t_hook_enter;
+    uint32_t t_hook_exit;
+    uint32_t woken;
+
+    //统计，监控任务在临界段里读取
+    TickHistogram_t hist[PHASE_COUNT];
+    uint32_t max_woken;
+    uint32_t overruns;
+    TickSample_t worst;             //总时间最长的一次
+    TickSample_t last_overrun;
+    TaskHandle_t notify_task;       //超预算时通知的任务
+}TickProfile_t;
+
+static TickProfile_t tick_profile;
+
+static void tick_profile_begin(void){
+    tick_profile.t_enter=cycle_counter_get();
+    tick_profile.t_hook_enter=0;
+    tick_profile.t_hook_exit=0;
+    tick_profile.woken=0;
+    tick_profile.in_tick=1;
+}
+
+/**
+ * 一次tick中断结束：拆分各阶段，记入直方图，检查预算
+ * 注意：在中断里调用；主机上是在tick钩子里（xTaskIncrementTick内部）调用，这里不能切换任务
+ */
+static void tick_profile_end(void){
+    TickProfile_t *p=&tick_profile;
+    uint32_t now=cycle_counter_get();
+    TickSample_t sample;
+
+    if(!p->in_tick){
+        return;
+    }
+    p->in_tick=0;
+
+    //调度器挂起时内核只累计挂起的tick，不调用钩子
+    if(p->t_hook_enter==0){
+        p->t_hook_enter=p->t_hook_exit=now;
+    }
+    sample.tick=xTaskGetTickCountFromISR();
+    sample.woken=p->woken;
+    sample.phase[PHASE_TOTAL]=now-p->t_enter;
+    sample.phase[PHASE_HOOK]=p->t_hook_exit-p->t_hook_enter;
+    sample.phase[PHASE_WAKE]=p->woken?(p->t_last_ready-p->t_first_ready):0;
+    sample.phase[PHASE_KERNEL]=sample.phase[PHASE_TOTAL]-sample.phase[PHASE_HOOK]-sample.phase[PHASE_WAKE];
+
+    for(uint32_t i=0;i<PHASE_COUNT;i++){
+        hist_add(&p->hist[i],sample.phase[i]);
+    }
+    if(sample.woken>p->max_woken){
+        p->max_woken=sample.woken;
+    }
+    if(sample.phase[PHASE_TOTAL]>p->worst.phase[PHASE_TOTAL]){
+        p->worst=sample;
+    }
+    if(sample.phase[PHASE_TOTAL]>TICK_BUDGET){
+        p->overruns++;
+        p->last_overrun=sample;
+        if(p->notify_task!=NULL){
+            //不传xHigherPriorityTaskWoken：内核记下挂起的切换请求，下一个切换点切到监控任务
+            vTaskNotifyGiveFromISR(p->notify_task,NULL);
+        }
+    }
+}
+
+//traceTASK_INCREMENT_TICK：进入xTaskIncrementTick
+void tick_profile_kernel_enter(void){
+#if !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__)
+    tick_profile_begin();       //主机上没有SysTick_Handler可包，从这里开始计时
+#endif
+}
+
+//traceMOVED_TASK_TO_READY_STATE：只统计tick中断里的（延时到期），任务和其他中断里的不算
+void tick_profile_task_ready(void){
+    if(tick_profile.in_tick){
+        tick_profile.t_last_ready=cycle_counter_get();
+        if(tick_profile.woken++==0){
+            tick_profile.t_first_ready=tick_profile.t_last_ready;
+        }
+    }
+}
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+extern void xPortSysTickHandler(void);
+
+void SysTick_Handler(void){
+    tick_profile_begin();
+    xPortSysTickHandler();
+    tick_profile_end();
+}
+#endif
+
+//监控任务取一份统计快照并清零
+static void tick_profile_snapshot(TickProfile_t *out, BaseType_t reset){
+    taskENTER_CRITICAL();       //屏蔽到configMAX_SYSCALL_INTERRUPT_PRIORITY，SysTick进不来
+    {
+        *out=tick_profile;
+        if(reset){
+            memset(tick_profile.hist,0,sizeof(tick_profile.hist));
+            tick_profile.max_woken=0;
+            tick_profile.overruns=0;
+            memset(&tick_profile.worst,0,sizeof(tick_profile.worst));
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+
+// ==================== Tick钩子工作：紧急的留在中断，其余延后 ====================
+#define TICK_WORK_MAX       8
+#define TICK_WORKER_PRIORITY    (tskIDLE_PRIORITY + 3)
+
+typedef void (*TickWorkFunction_t)(void);
+
+typedef struct{
+    const char *name;
+    TickWorkFunction_t function;
+    uint16_t period;                //每period个tick执行一次
+    uint16_t countdown;
+    uint8_t urgent;                 //1：必须在tick中断里执行
+    uint32_t runs;
+    uint32_t coalesced;             //上次挂起还没执行又到期了，合并成一次
+}TickWork_t;
+
+static TickWork_t tick_work[TICK_WORK_MAX];
+static uint32_t tick_work_count;
+static volatile uint32_t tick_work_pending;     //挂起位，中断里置位，守护任务清零
+static volatile uint8_t tick_defer_enabled=1;   //0：所有工作都在中断里执行（对比用）
+static TaskHandle_t tick_worker_handle;
+
+/**
+ * 注册一项tick工作（调度器启动前调用）
+ * 返回：pdPASS成功
+ */
+BaseType_t TickWork_Register(const char *name, TickWorkFunction_t function, uint16_t period, uint8_t urgent){
+    TickWork_t *work;
+
+    if(tick_work_count>=TICK_WORK_MAX||period==0){
+        return pdFAIL;
+    }
+    work=&tick_work[tick_work_count++];
+    work->name=name;
+    work->function=function;
+    work->period=period;
+    work->countdown=period;
+    work->urgent=urgent;
+    return pdPASS;
+}
+
+void vApplicationTickHook(void){
+    uint32_t pending=0;
+
+    tick_profile.t_hook_enter=cycle_counter_get();
+
+    for(uint32_t i=0;i<tick_work_count;i++){
+        TickWork_t *work=&tick_work[i];
+        if(--work->countdown==0){
+            work->countdown=work->period;
+            if(work->urgent||!tick_defer_enabled){
+                work->function();
+                work->runs++;
+            }else{
+                pending|=1UL<<i;
+            }
+        }
+    }
+
+    if(pending){
+        if(tick_work_pending&pending){
+            for(uint32_t i=0;i<tick_work_count;i++){
+                tick_work[i].coalesced+=(tick_work_pending&pending&(1UL<<i))?1:0;
+            }
+        }
+        tick_work_pending|=pending;     //tick中断里不会被任务打断，守护任务清零时在临界段里
+        //钩子在xTaskIncrementTick内部执行，不能在这里portYIELD_FROM_ISR；
+        //通知设置的挂起切换请求由xTaskIncrementTick的返回值带给移植层
+        vTaskNotifyGiveFromISR(tick_worker_handle,NULL);
+    }
+
+    tick_profile.t_hook_exit=cycle_counter_get();
+
+#if !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__)
+    tick_profile_end();
+#endif
+}
+
+//守护任务：执行延后的tick工作
+void TickWorkerTask(void *pvParameters){
+    for(;;){
+        uint32_t pending;
+
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+
+        taskENTER_CRITICAL();
+        {
+            pending=tick_work_pending;
+            tick_work_pending=0;
+        }
+        taskEXIT_CRITICAL();
+
+        while(pending){
+            uint32_t i=(uint32_t)__builtin_ctz(pending);
+            pending&=pending-1;
+            tick_work[i].function();
+            tick_work[i].runs++;
+        }
+    }
+}
+
+
+// ==================== demo5.c的钩子工作 ====================
+volatile uint32_t systicks_count=0;         // 系统tick计数器
+volatile uint32_t task_delay_upload=0;      // 每1000个tick统计一次
+
+#define STATS_WINDOW        512
+
+static volatile uint16_t adc_window[STATS_WINDOW];
+static volatile uint32_t stats_result;
+
+//紧急：每个tick计数
+static void count_tick_work(void){
+    systicks_count++;
+}
+
+//不紧急：每秒统计一次
+static void upload_work(void){
+    task_delay_upload++;
+}
+
+//不紧急但耗时：每10个tick对一个采样窗口做一次统计，模拟钩子里"顺手"做的计算
+static void window_stats_work(void){
+    uint32_t sum=0;
+    uint64_t sum_sq=0;
+
+    for(uint32_t i=0;i<STATS_WINDOW;i++){
+        uint32_t v=adc_window[i];
+        sum+=v;
+        sum_sq+=(uint64_t)v*v;
+    }
+    stats_result=(uint32_t)(sum_sq/STATS_WINDOW)-(sum/STATS_WINDOW)*(sum/STATS_WINDOW);
+}
+
+//按到期节奏唤醒的任务：第k个每k个tick醒一次，让每个tick都有数量不等的任务到期
+#define WAKER_TASKS         16
+
+void WakerTask(void *pvParameters){
+    TickType_t period=(TickType_t)(uintptr_t)pvParameters;
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+    uint32_t i=0;
+
+    for(;;){
+        adc_window[(i++)%STATS_WINDOW]=(uint16_t)(xLastWakeTime*period);
+        vTaskDelayUntil(&xLastWakeTime,period);
+    }
+}
+
+
+// ==================== 监控任务 ====================
+#define MONITOR_PERIOD_MS   5000
+#define MONITOR_PRIORITY    (tskIDLE_PRIORITY + 4)
+
+static const char *const phase_names[PHASE_COUNT]={"总计","内核记账","唤醒任务","tick钩子"};
+
+static void print_profile(const TickProfile_t *snap){
+    printf("  阶段        次数      平均     p50     p99     最大 (%s)\n", CYCLE_UNIT);
+    for(uint32_t i=0;i<PHASE_COUNT;i++){
+        const TickHistogram_t *h=&snap->hist[i];
+        printf("  %-10s %6lu %8lu %7lu %7lu %8lu\n", phase_names[i], h->count,
+               (uint32_t)(h->count?h->sum/h->count:0), hist_percentile(h,50), hist_percentile(h,99), h->max);
+    }
+    printf("  同一tick最多唤醒%lu个任务，超预算(%d us)%lu次\n", snap->max_woken, TICK_BUDGET_US, snap->overruns);
+}
+
+//超预算事件：由tick中断通知，立即打印当时的各阶段时间；每5秒打印一次直方图（自上次清零以来，性能测试会清零）
+void TickMonitorTask(void *pvParameters){
+    TickProfile_t snap;
+    TickType_t last_report=xTaskGetTickCount();
+
+    for(;;){
+        if(ulTaskNotifyTake(pdTRUE,pdMS_TO_TICKS(MONITOR_PERIOD_MS))>0){
+            tick_profile_snapshot(&snap,pdFALSE);
+            printf("[Tick监控] 超预算 tick=%lu 总计%lu = 内核%lu + 唤醒%lu(%lu个任务) + 钩子%lu %s\n",
+                   snap.last_overrun.tick, snap.last_overrun.phase[PHASE_TOTAL],
+                   snap.last_overrun.phase[PHASE_KERNEL], snap.last_overrun.phase[PHASE_WAKE],
+                   snap.last_overrun.woken, snap.last_overrun.phase[PHASE_HOOK], CYCLE_UNIT);
+            vTaskDelay(pdMS_TO_TICKS(100));     //超预算连续发生时限制打印速度
+        }
+        if(xTaskGetTickCount()-last_report>=pdMS_TO_TICKS(MONITOR_PERIOD_MS)){
+            last_report=xTaskGetTickCount();
+            tick_profile_snapshot(&snap,pdFALSE);
+            printf("\n[Tick监控] 钩子工作%s\n", tick_defer_enabled?"延后":"在中断里");
+            print_profile(&snap);
+        }
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_WINDOW_MS     5000
+
+void bench_task(void *pvParameters){
+    TickProfile_t in_isr,deferred;
+
+    vTaskDelay(pdMS_TO_TICKS(2000));
+
+    //两种模式各测一个窗口，开始前清零统计
+    tick_defer_enabled=0;
+    tick_profile_snapshot(&in_isr,pdTRUE);
+    vTaskDelay(pdMS_TO_TICKS(BENCH_WINDOW_MS));
+    tick_profile_snapshot(&in_isr,pdTRUE);
+
+    tick_defer_enabled=1;
+    vTaskDelay(pdMS_TO_TICKS(BENCH_WINDOW_MS));
+    tick_profile_snapshot(&deferred,pdTRUE);
+
+    printf("\n[性能测试] %d个周期任务 + 每10 tick一次的窗口统计，预算%d us\n", WAKER_TASKS, TICK_BUDGET_US);
+    printf("钩子工作全部在tick中断里：\n");
+    print_profile(&in_isr);
+    printf("不紧急的钩子工作延后到守护任务：\n");
+    print_profile(&deferred);
+    for(uint32_t i=0;i<tick_work_count;i++){
+        printf("  工作%-8s %s 执行%lu次 合并%lu次\n", tick_work[i].name, tick_work[i].urgent?"紧急":"延后",
+               tick_work[i].runs, tick_work[i].coalesced);
+    }
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    TaskHandle_t monitor_handle;
+
+    cycle_counter_init();
+
+    TickWork_Register("计数",count_tick_work,1,1);
+    TickWork_Register("上报",upload_work,1000,0);
+    TickWork_Register("窗口统计",window_stats_work,10,0);
+
+    xTaskCreate(TickWorkerTask, "TickWorker", 256, NULL, TICK_WORKER_PRIORITY, &tick_worker_handle);
+    xTaskCreate(TickMonitorTask, "TickMonitor", 512, NULL, MONITOR_PRIORITY, &monitor_handle);
+    tick_profile.notify_task=monitor_handle;
+
+    for(uint32_t k=1;k<=WAKER_TASKS;k++){
+        xTaskCreate(WakerTask, "Waker", configMINIMAL_STACK_SIZE, (void*)(uintptr_t)k, tskIDLE_PRIORITY+2, NULL);
+    }
+    xTaskCreate(bench_task, "Bench", 512, NULL, tskIDLE_PRIORITY+1, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. tick中断的组成：
+   - 内核记账：tick计数加1、检查延时列表头、时间片、挂起PendSV
+   - 唤醒任务：从第一个到期任务移入就绪列表到最后一个，同一个tick到期的任务越多越长
+   - tick钩子：用户代码，最容易失控
+
+2. 测量方法：
+   - 包住SysTick_Handler测总时间，跟踪宏标出进入内核和每次移入就绪列表
+   - 跟踪宏在任务里也会被调用，用in_tick标志只统计tick中断里的
+
+3. 直方图而不是平均值：
+   - 预算看的是最坏情况，平均值会把偶尔的长尾掩盖掉
+   - 对数分桶：记录只要一次clz和一次加法，适合放在中断里
+
+4. 超预算事件：
+   - 中断里只记下当时的各阶段时间，通知监控任务，打印放在任务里
+
+5. 钩子工作延后：
+   - 中断里只做必须在tick上做的事（计数、喂狗、时间戳）
+   - 其余的置挂起位，交给守护任务；守护任务来不及时多次到期合并成一次
+   - 中断时间变短、抖动变小，代价是延后的工作有调度延迟
+*/
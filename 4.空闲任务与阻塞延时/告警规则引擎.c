@@ -0,0 +1,587 @@
+/*
+ * Demo: 告警规则引擎（规则编译成表，按样本块批量求值）
+ * 学习要点：
+ * 1. 工业数据采集与监控系统.c的告警是写死的两个比较：TEMP_ALARM_THRESHOLD、HUMIDITY_ALARM_THRESHOLD，
+ *    结果放在alarm_flags里；规则一多，if/switch分支就成了瓶颈，也没法在运行时配置
+ * 2. 规则三要素：
+ *    - 条件：高于/低于阈值，上升/下降速率超过阈值（单位/秒）
+ *    - 回差（hysteresis）：触发后要回落到"阈值-回差"以下才解除，防止在阈值附近抖动
+ *    - 持续时间：条件连续满足N个样本才触发，连续不满足N个样本才解除
+ * 3. 编译：把"高于/低于"统一成"sign*输入 > 门限"，速率阈值换算成每样本的差值，
+ *    触发/解除门限预先算好，规则按通道排序，存成结构体数组（SoA）
+ * 4. 求值无分支：门限、计数器、状态翻转都用选择和乘法计算，内层循环可以向量化；
+ *    翻转很少，只在有翻转的样本上再扫一遍记录边沿
+ * 5. 边沿通过xSystemEvents发布：每个事件位有引用计数，多条规则共用一个位，块处理完一次性置位/清位
+ * 6. 性能测试：3通道×200条规则，按块求值与逐条switch解释的每秒规则求值次数
+ *
+ * 对应场景：工业数据采集与监控系统.c的DataProcessTask告警判断
+ *
+ * 内层循环要向量化需要-O3（或-O2 -ftree-vectorize -fvect-cost-model=dynamic），
+ * 没有浮点SIMD的MCU上也能受益于无分支
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 规则定义 ====================
+#define ALARM_MAX_CHANNELS  8
+#define ALARM_MAX_RULES     640
+#define ALARM_MAX_EDGES     256     //一个块最多记录的边沿数，超出的计入edges_lost
+#define ALARM_EVENT_BITS    24      //事件组可用的位数（configUSE_16_BIT_TICKS为0时）
+
+typedef enum{
+    ALARM_ABOVE=0,          //输入高于阈值
+    ALARM_BELOW,            //输入低于阈值
+    ALARM_RISE_RATE,        //上升速率高于阈值（单位/秒）
+    ALARM_FALL_RATE         //下降速率高于阈值（单位/秒）
+}AlarmCondition_t;
+
+//规则的配置形式：由用户填写，可以来自配置文件或上位机
+typedef struct{
+    uint16_t id;
+    uint8_t channel;
+    uint8_t condition;      //AlarmCondition_t
+    float threshold;
+    float hysteresis;       //解除时要越过的回差，>=0
+    uint16_t duration;      //触发/解除前条件需要连续保持的样本数，>=1
+    uint8_t event_bit;      //触发时在xSystemEvents上置的位号
+}AlarmRule_t;
+
+//边沿：规则状态的一次翻转
+typedef struct{
+    uint16_t rule_id;
+    uint16_t index;         //规则在编译表中的位置
+    uint8_t raised;         //1触发，0解除
+    uint8_t channel;
+    TickType_t tick;        //触发样本的时刻
+    float value;            //触发样本的值
+}AlarmEdge_t;
+
+
+// ==================== 编译后的规则表 ====================
+//规则按通道排序存放，通道ch的规则在[channel_begin[ch],channel_begin[ch+1])之间
+typedef struct{
+    uint16_t num_rules;
+    uint16_t channel_begin[ALARM_MAX_CHANNELS+1];
+
+    //只读部分：编译时生成；参与内层循环的数组都是32位宽，向量化时不用拆包
+    float sign[ALARM_MAX_RULES];            //高于/上升为+1，低于/下降为-1
+    float raise_level[ALARM_MAX_RULES];     //未触发时：sign*输入 > raise_level 则条件成立
+    float clear_level[ALARM_MAX_RULES];     //已触发时：sign*输入 > clear_level 则条件仍成立
+    uint32_t duration[ALARM_MAX_RULES];
+    uint32_t is_rate[ALARM_MAX_RULES];      //1：输入取本样本与上一样本的差
+    uint8_t event_bit[ALARM_MAX_RULES];
+    uint16_t rule_id[ALARM_MAX_RULES];
+
+    //运行状态
+    uint32_t active[ALARM_MAX_RULES];
+    uint32_t counter[ALARM_MAX_RULES];      //条件与当前状态不一致的连续样本数
+    uint32_t flipped[ALARM_MAX_RULES];      //本样本是否翻转
+    uint16_t flip_list[ALARM_MAX_RULES];    //本样本翻转的规则下标，记录边沿用
+    float last_value[ALARM_MAX_CHANNELS];
+    uint8_t has_last[ALARM_MAX_CHANNELS];
+
+    //事件位的引用计数：有几条规则处于触发状态
+    uint16_t bit_refs[ALARM_EVENT_BITS];
+    uint16_t active_rules;
+    EventBits_t used_bits;                  //规则用到的事件位，Publish只动这些位
+
+    //最近一个块的边沿
+    AlarmEdge_t edges[ALARM_MAX_EDGES];
+    uint32_t num_edges;
+
+    //统计信息
+    uint32_t evaluations;
+    uint32_t edges_total;
+    uint32_t edges_lost;
+}AlarmEngine_t;
+
+/**
+ * 编译规则集
+ * 功能：检查规则，按通道排序，换算出门限，清空运行状态
+ * 参数：rules 规则数组；num_rules 规则数；sample_period_ms 采样周期（速率规则换算用）
+ * 返回：pdPASS成功；规则非法或超出容量返回pdFAIL
+ */
+BaseType_t AlarmEngine_Compile(AlarmEngine_t *engine, const AlarmRule_t *rules, uint32_t num_rules,
+                               uint32_t sample_period_ms){
+    uint16_t fill[ALARM_MAX_CHANNELS];
+    float period_s=(float)sample_period_ms/1000.0f;
+
+    if(num_rules>ALARM_MAX_RULES||sample_period_ms==0){
+        return pdFAIL;
+    }
+    memset(engine,0,sizeof(AlarmEngine_t));
+
+    //计数排序：先数每个通道的规则数
+    for(uint32_t i=0;i<num_rules;i++){
+        const AlarmRule_t *rule=&rules[i];
+        if(rule->channel>=ALARM_MAX_CHANNELS||rule->condition>ALARM_FALL_RATE||
+           rule->hysteresis<0.0f||rule->duration==0||rule->event_bit>=ALARM_EVENT_BITS){
+            return pdFAIL;
+        }
+        engine->channel_begin[rule->channel+1]++;
+    }
+    for(uint32_t ch=0;ch<ALARM_MAX_CHANNELS;ch++){
+        engine->channel_begin[ch+1]+=engine->channel_begin[ch];
+        fill[ch]=engine->channel_begin[ch];
+    }
+
+    for(uint32_t i=0;i<num_rules;i++){
+        const AlarmRule_t *rule=&rules[i];
+        uint16_t r=fill[rule->channel]++;
+        float sign=(rule->condition==ALARM_ABOVE||rule->condition==ALARM_RISE_RATE)?1.0f:-1.0f;
+        float level;
+
+        if(rule->condition==ALARM_RISE_RATE||rule->condition==ALARM_FALL_RATE){
+            //速率阈值是正数：上升d>t，下降-d>t，单位/秒换算成单位/样本
+            level=rule->threshold*period_s;
+            engine->is_rate[r]=1;
+        }else{
+            //低于阈值取反后变成高于：x<t ⇔ -x>-t，解除门限x<t+h ⇔ -x>-t-h
+            level=sign*rule->threshold;
+        }
+        engine->sign[r]=sign;
+        engine->raise_level[r]=level;
+        engine->clear_level[r]=level-rule->hysteresis;
+        engine->duration[r]=rule->duration;
+        engine->event_bit[r]=rule->event_bit;
+        engine->rule_id[r]=rule->id;
+        engine->used_bits|=(EventBits_t)1<<rule->event_bit;
+    }
+    engine->num_rules=(uint16_t)num_rules;
+    return pdPASS;
+}
+
+/**
+ * 对一个通道的一块样本求值
+ * 功能：样本在外层、规则在内层；内层循环各规则互不依赖、没有分支，编译器可以向量化；
+ *      翻转很少发生，只在有翻转的样本上再扫一遍记录边沿
+ * 参数：samples 该通道的样本；count 样本数；base_tick/period_ticks 第i个样本的时刻为base+i*period
+ */
+static void alarm_eval_channel(AlarmEngine_t *engine, uint8_t channel, const float *samples, uint16_t count,
+                               TickType_t base_tick, TickType_t period_ticks){
+    uint32_t begin=engine->channel_begin[channel];
+    uint32_t end=engine->channel_begin[channel+1];
+    const float *sign=engine->sign;
+    const float *raise_level=engine->raise_level;
+    const float *clear_level=engine->clear_level;
+    const uint32_t *duration=engine->duration;
+    const uint32_t *is_rate=engine->is_rate;
+    uint32_t *active=engine->active;
+    uint32_t *counter=engine->counter;
+    uint32_t *flipped=engine->flipped;
+    uint32_t n=engine->num_edges;
+    float last;
+
+    if(begin==end||count==0){
+        return;
+    }
+    //第一个样本没有前值，差值按0算
+    last=engine->has_last[channel]?engine->last_value[channel]:samples[0];
+
+    for(uint16_t i=0;i<count;i++){
+        float level=samples[i];
+        float delta=level-last;
+        uint32_t any=0;
+        last=level;
+
+        for(uint32_t r=begin;r<end;r++){
+            //两个门限都读出来再选择，不做条件加载
+            float raise=raise_level[r];
+            float clear=clear_level[r];
+            float input=is_rate[r]?delta:level;
+            uint32_t was=active[r];
+            float gate=was?clear:raise;
+            uint32_t cond=(sign[r]*input>gate);
+            uint32_t cnt=(counter[r]+1u)*(cond^was);
+            uint32_t flip=(cnt>=duration[r]);
+
+            active[r]=was^flip;
+            counter[r]=cnt*(flip^1u);
+            flipped[r]=flip;
+            any|=flip;
+        }
+
+        if(any){
+            //先把翻转的规则下标无分支地压缩到列表里，再逐个写边沿
+            uint32_t m=0;
+            for(uint32_t r=begin;r<end;r++){
+                engine->flip_list[m]=(uint16_t)r;
+                m+=flipped[r];
+            }
+            for(uint32_t k=0;k<m;k++){
+                uint32_t r=engine->flip_list[k];
+                if(n<ALARM_MAX_EDGES){
+                    AlarmEdge_t *edge=&engine->edges[n];
+                    edge->rule_id=engine->rule_id[r];
+                    edge->index=(uint16_t)r;
+                    edge->raised=(uint8_t)active[r];
+                    edge->channel=channel;
+                    edge->tick=base_tick+(TickType_t)i*period_ticks;
+                    edge->value=level;
+                }
+                n++;
+            }
+        }
+    }
+
+    engine->last_value[channel]=last;
+    engine->has_last[channel]=1;
+    engine->evaluations+=(uint32_t)count*(end-begin);
+    engine->num_edges=n;
+}
+
+/**
+ * 对一个样本块求值
+ * 参数：channels 每个通道一个样本数组（NULL表示该通道本块没有数据）
+ * 返回：本块的边沿数，边沿在engine->edges[0..min(返回值,ALARM_MAX_EDGES))
+ */
+uint32_t AlarmEngine_EvaluateBlock(AlarmEngine_t *engine, const float *const channels[ALARM_MAX_CHANNELS],
+                                   uint16_t count, TickType_t base_tick, TickType_t period_ticks){
+    engine->num_edges=0;
+    for(uint8_t ch=0;ch<ALARM_MAX_CHANNELS;ch++){
+        if(channels[ch]!=NULL){
+            alarm_eval_channel(engine,ch,channels[ch],count,base_tick,period_ticks);
+        }
+    }
+    engine->edges_total+=engine->num_edges;
+    if(engine->num_edges>ALARM_MAX_EDGES){
+        engine->edges_lost+=engine->num_edges-ALARM_MAX_EDGES;
+        engine->num_edges=ALARM_MAX_EDGES;
+    }
+    return engine->num_edges;
+}
+
+/**
+ * 把本块的边沿发布到事件组
+ * 功能：维护每个事件位的引用计数，块结束时一次置位、一次清位；
+ *      any_alarm_bit在有任何规则触发时保持置位；事件组中规则没用到的位属于其他模块，不会被改动
+ * 注意：边沿缓冲区溢出时引用计数按规则的当前状态重算，保证事件位和规则状态一致
+ */
+void AlarmEngine_Publish(AlarmEngine_t *engine, EventGroupHandle_t events, EventBits_t any_alarm_bit){
+    EventBits_t set_bits=0,clear_bits=0;
+
+    if(engine->num_edges<ALARM_MAX_EDGES){
+        for(uint32_t i=0;i<engine->num_edges;i++){
+            const AlarmEdge_t *edge=&engine->edges[i];
+            uint8_t bit=engine->event_bit[edge->index];
+            if(edge->raised){
+                engine->bit_refs[bit]++;
+                engine->active_rules++;
+            }else{
+                engine->bit_refs[bit]--;
+                engine->active_rules--;
+            }
+        }
+    }else{
+        memset(engine->bit_refs,0,sizeof(engine->bit_refs));
+        engine->active_rules=0;
+        for(uint16_t r=0;r<engine->num_rules;r++){
+            engine->bit_refs[engine->event_bit[r]]+=engine->active[r];
+            engine->active_rules+=engine->active[r];
+        }
+    }
+
+    for(uint8_t bit=0;bit<ALARM_EVENT_BITS;bit++){
+        if(!(engine->used_bits&((EventBits_t)1<<bit))){
+            continue;
+        }
+        if(engine->bit_refs[bit]){
+            set_bits|=(EventBits_t)1<<bit;
+        }else{
+            clear_bits|=(EventBits_t)1<<bit;
+        }
+    }
+    if(engine->active_rules){
+        set_bits|=any_alarm_bit;
+    }else{
+        clear_bits|=any_alarm_bit;
+    }
+    clear_bits&=~set_bits;
+    if(set_bits){
+        xEventGroupSetBits(events,set_bits);
+    }
+    if(clear_bits){
+        xEventGroupClearBits(events,clear_bits);
+    }
+}
+
+
+// ==================== 工业数据采集系统的告警 ====================
+#define SAMPLE_PERIOD_MS    100
+#define ALARM_BLOCK_SIZE    10      //每秒求值一次
+
+enum{ CH_TEMPERATURE=0, CH_HUMIDITY, CH_PRESSURE };
+
+// 事件位定义（0~3与工业数据采集与监控系统.c一致）
+#define SENSOR_DATA_READY_BIT    (1 << 0)
+#define DATA_PROCESSED_BIT       (1 << 1)
+#define COMM_SEND_BIT           (1 << 2)
+#define ALARM_BIT               (1 << 3)
+#define TEMP_HIGH_BIT_NUM       4
+#define HUMIDITY_HIGH_BIT_NUM   5
+#define TEMP_RISE_BIT_NUM       6
+#define PRESSURE_LOW_BIT_NUM    7
+#define ALARM_DETAIL_BITS       (0xFUL << TEMP_HIGH_BIT_NUM)
+
+// 系统配置参数（原来的两个阈值变成了规则）
+#define TEMP_ALARM_THRESHOLD    80.0f   // 温度告警阈值
+#define HUMIDITY_ALARM_THRESHOLD 90.0f  // 湿度告警阈值
+
+static const AlarmRule_t system_rules[]={
+    //id  通道            条件             阈值                      回差  持续  事件位
+    { 1, CH_TEMPERATURE, ALARM_ABOVE,     TEMP_ALARM_THRESHOLD,     2.0f, 3,  TEMP_HIGH_BIT_NUM     },
+    { 2, CH_HUMIDITY,    ALARM_ABOVE,     HUMIDITY_ALARM_THRESHOLD, 3.0f, 5,  HUMIDITY_HIGH_BIT_NUM },
+    { 3, CH_TEMPERATURE, ALARM_RISE_RATE, 10.0f,                    0.0f, 2,  TEMP_RISE_BIT_NUM     },
+    { 4, CH_PRESSURE,    ALARM_BELOW,     100.0f,                   0.5f, 10, PRESSURE_LOW_BIT_NUM  },
+};
+
+static AlarmEngine_t system_alarms;
+EventGroupHandle_t xSystemEvents;  // 系统事件组
+
+//模拟传感器：温度缓慢升到85℃再回落，中间有一次阶跃；湿度和压力带噪声
+static void simulate_sample(uint32_t n, float *temperature, float *humidity, float *pressure){
+    float t=(float)n*SAMPLE_PERIOD_MS/1000.0f;
+
+    *temperature=70.0f+15.0f*sinf(t*0.05f)+(float)(rand()%100)/100.0f;
+    if(n%600>=300&&n%600<305){
+        *temperature+=5.0f;     //0.5秒内上升5℃
+    }
+    *humidity=80.0f+12.0f*sinf(t*0.03f+1.0f)+(float)(rand()%200)/100.0f;
+    *pressure=100.5f+1.0f*sinf(t*0.02f)+(float)(rand()%20)/100.0f;
+}
+
+void SensorAlarmTask(void *pvParameters){
+    static float temperature[ALARM_BLOCK_SIZE],humidity[ALARM_BLOCK_SIZE],pressure[ALARM_BLOCK_SIZE];
+    const float *const channels[ALARM_MAX_CHANNELS]={ temperature, humidity, pressure };
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+    uint32_t n=0;
+
+    for(;;){
+        TickType_t base_tick=xTaskGetTickCount();
+        uint32_t edges;
+
+        for(uint16_t i=0;i<ALARM_BLOCK_SIZE;i++){
+            simulate_sample(n++,&temperature[i],&humidity[i],&pressure[i]);
+            vTaskDelayUntil(&xLastWakeTime,pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
+        }
+
+        edges=AlarmEngine_EvaluateBlock(&system_alarms,channels,ALARM_BLOCK_SIZE,base_tick,
+                                        pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
+        for(uint32_t i=0;i<edges;i++){
+            const AlarmEdge_t *edge=&system_alarms.edges[i];
+            printf("[告警] 规则%u %s  tick=%lu 值=%.2f\n", edge->rule_id, edge->raised?"触发":"解除",
+                   edge->tick, edge->value);
+        }
+        AlarmEngine_Publish(&system_alarms,xSystemEvents,ALARM_BIT);
+    }
+}
+
+//显示任务：等待告警事件位变化
+void AlarmDisplayTask(void *pvParameters){
+    EventBits_t shown=0;
+
+    for(;;){
+        EventBits_t bits=xEventGroupWaitBits(xSystemEvents,ALARM_BIT,pdFALSE,pdFALSE,pdMS_TO_TICKS(1000));
+        bits&=(ALARM_BIT|ALARM_DETAIL_BITS);
+        if(bits!=shown){
+            printf("[显示] 告警状态:%s%s%s%s%s\n", (bits&ALARM_BIT)?"":" 无",
+                   (bits&(1UL<<TEMP_HIGH_BIT_NUM))?" 温度高":"",
+                   (bits&(1UL<<HUMIDITY_HIGH_BIT_NUM))?" 湿度高":"",
+                   (bits&(1UL<<TEMP_RISE_BIT_NUM))?" 温升快":"",
+                   (bits&(1UL<<PRESSURE_LOW_BIT_NUM))?" 压力低":"");
+            shown=bits;
+        }
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_CHANNELS          3
+#define BENCH_RULES_PER_CHANNEL 200
+#define BENCH_BLOCK_SIZE        64
+#define BENCH_BLOCKS            200
+
+static AlarmRule_t bench_rules[BENCH_CHANNELS*BENCH_RULES_PER_CHANNEL];
+static AlarmEngine_t bench_engine;
+static float bench_samples[BENCH_BLOCKS][BENCH_CHANNELS][BENCH_BLOCK_SIZE];
+
+//对照组：规则按配置形式逐条解释，switch + if，和把阈值判断写死在处理任务里一样
+typedef struct{
+    uint8_t active;
+    uint16_t counter;
+}NaiveRuleState_t;
+
+static NaiveRuleState_t naive_state[BENCH_CHANNELS*BENCH_RULES_PER_CHANNEL];
+
+static uint32_t naive_evaluate(const AlarmRule_t *rules, uint32_t num_rules, const float *samples,
+                               uint16_t count, uint8_t channel, float *last, float period_s){
+    uint32_t edges=0;
+
+    for(uint16_t i=0;i<count;i++){
+        float x=samples[i];
+        float delta=x-*last;
+        *last=x;
+
+        for(uint32_t k=0;k<num_rules;k++){
+            const AlarmRule_t *rule=&rules[k];
+            NaiveRuleState_t *st=&naive_state[k];
+            uint8_t cond;
+
+            if(rule->channel!=channel){
+                continue;
+            }
+            switch(rule->condition){
+            case ALARM_ABOVE:
+                cond=st->active?(x>rule->threshold-rule->hysteresis):(x>rule->threshold);
+                break;
+            case ALARM_BELOW:
+                cond=st->active?(x<rule->threshold+rule->hysteresis):(x<rule->threshold);
+                break;
+            case ALARM_RISE_RATE:
+                cond=st->active?(delta>rule->threshold*period_s-rule->hysteresis):(delta>rule->threshold*period_s);
+                break;
+            default:
+                cond=st->active?(-delta>rule->threshold*period_s-rule->hysteresis):(-delta>rule->threshold*period_s);
+                break;
+            }
+            if(cond!=st->active){
+                if(++st->counter>=rule->duration){
+                    st->active=!st->active;
+                    st->counter=0;
+                    edges++;
+                }
+            }else{
+                st->counter=0;
+            }
+        }
+    }
+    return edges;
+}
+
+void bench_task(void *pvParameters){
+    const uint32_t num_rules=BENCH_CHANNELS*BENCH_RULES_PER_CHANNEL;
+    const float period_s=(float)SAMPLE_PERIOD_MS/1000.0f;
+    uint64_t evaluations=(uint64_t)num_rules*BENCH_BLOCK_SIZE*BENCH_BLOCKS;
+    uint32_t start,compiled_cycles,naive_cycles,naive_edges=0;
+    float naive_last[BENCH_CHANNELS];
+
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    cycle_counter_init();
+
+    //随机规则：阈值落在信号范围内，保证有边沿；回差和持续时间按实际告警配置取，边沿不会太频繁
+    for(uint32_t k=0;k<num_rules;k++){
+        AlarmRule_t *rule=&bench_rules[k];
+        rule->id=(uint16_t)k;
+        rule->channel=(uint8_t)(k%BENCH_CHANNELS);
+        rule->condition=(uint8_t)(rand()%4);
+        if(rule->condition<=ALARM_BELOW){
+            rule->threshold=40.0f+(float)(rand()%2000)/100.0f;
+        }else{
+            rule->threshold=20.0f+(float)(rand()%4000)/100.0f;
+        }
+        rule->hysteresis=1.0f+(float)(rand()%300)/100.0f;
+        rule->duration=(uint16_t)(3+rand()%8);
+        rule->event_bit=(uint8_t)(k%ALARM_EVENT_BITS);
+    }
+    for(uint32_t b=0;b<BENCH_BLOCKS;b++){
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            for(uint32_t i=0;i<BENCH_BLOCK_SIZE;i++){
+                float t=(float)(b*BENCH_BLOCK_SIZE+i)*0.01f;
+                bench_samples[b][ch][i]=50.0f+10.0f*sinf(t+(float)ch)+(float)(rand()%300)/100.0f;
+            }
+        }
+    }
+    AlarmEngine_Compile(&bench_engine,bench_rules,num_rules,SAMPLE_PERIOD_MS);
+
+    start=cycle_counter_get();
+    for(uint32_t b=0;b<BENCH_BLOCKS;b++){
+        const float *const channels[ALARM_MAX_CHANNELS]={ bench_samples[b][0], bench_samples[b][1], bench_samples[b][2] };
+        AlarmEngine_EvaluateBlock(&bench_engine,channels,BENCH_BLOCK_SIZE,0,1);
+    }
+    compiled_cycles=cycle_counter_get()-start;
+
+    for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+        naive_last[ch]=bench_samples[0][ch][0];
+    }
+    start=cycle_counter_get();
+    for(uint32_t b=0;b<BENCH_BLOCKS;b++){
+        for(uint8_t ch=0;ch<BENCH_CHANNELS;ch++){
+            naive_edges+=naive_evaluate(bench_rules,num_rules,bench_samples[b][ch],BENCH_BLOCK_SIZE,ch,
+                                        &naive_last[ch],period_s);
+        }
+    }
+    naive_cycles=cycle_counter_get()-start;
+
+    printf("\n[性能测试] %d通道×%d条规则，块长%d，%d块\n",
+           BENCH_CHANNELS, BENCH_RULES_PER_CHANNEL, BENCH_BLOCK_SIZE, BENCH_BLOCKS);
+    printf("  方式        总耗时(%s)   每秒规则求值     边沿数\n", CYCLE_UNIT);
+    printf("  逐条解释    %12lu   %14lu   %8lu\n", naive_cycles,
+           (uint32_t)(evaluations*CYCLES_PER_SECOND/(naive_cycles?naive_cycles:1)), naive_edges);
+    printf("  编译规则表  %12lu   %14lu   %8lu\n", compiled_cycles,
+           (uint32_t)(evaluations*CYCLES_PER_SECOND/(compiled_cycles?compiled_cycles:1)), bench_engine.edges_total);
+    printf("  两种方式的边沿数应当相同；逐条解释每个样本还要扫一遍其他通道的规则\n");
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    srand(1234);
+
+    xSystemEvents=xEventGroupCreate();
+    if(!xSystemEvents||
+       AlarmEngine_Compile(&system_alarms,system_rules,sizeof(system_rules)/sizeof(system_rules[0]),
+                           SAMPLE_PERIOD_MS)!=pdPASS){
+        printf("告警引擎初始化失败\n");
+        return -1;
+    }
+
+    //自检：规则没用到的位由其他模块使用，发布告警时不能被清掉
+    xEventGroupSetBits(xSystemEvents,SENSOR_DATA_READY_BIT);
+    AlarmEngine_Publish(&system_alarms,xSystemEvents,ALARM_BIT);
+    if(!(xEventGroupGetBits(xSystemEvents)&SENSOR_DATA_READY_BIT)){
+        printf("告警发布清掉了其他模块的事件位\n");
+        return -1;
+    }
+    xEventGroupClearBits(xSystemEvents,SENSOR_DATA_READY_BIT);
+
+    xTaskCreate(SensorAlarmTask, "Alarm", 512, NULL, 3, NULL);
+    xTaskCreate(AlarmDisplayTask, "Display", 256, NULL, 1, NULL);
+    xTaskCreate(bench_task, "Bench", 512, NULL, 2, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 规则的两种形式：
+   - 配置形式AlarmRule_t：直观，方便编辑和下发
+   - 编译形式AlarmEngine_t：按通道排序的SoA数组，门限预先换算，求值时只剩比较和选择
+
+2. 统一条件：
+   - 低于阈值取反变成高于，速率阈值乘采样周期变成每样本差值
+   - 内层循环只有一种比较：sign*输入 > 门限，门限由当前状态选择触发/解除门限
+
+3. 回差和持续时间：
+   - 回差防止在阈值附近反复触发
+   - 持续时间计数条件与状态不一致的连续样本数，达到N才翻转，触发和解除对称
+
+4. 无分支求值：
+   - 计数器：(counter+1)*(cond^active)，一致时清零
+   - 翻转标志：内层循环只记标志，有翻转的样本才再扫一遍写边沿
+
+5. 批量发布：
+   - 一个块的所有边沿处理完再调用一次SetBits/ClearBits，减少事件组操作和唤醒
+   - 多条规则共用一个事件位，用引用计数决定置位还是清位
+*/
@@ -0,0 +1,597 @@
+/*
+ * Demo: 流式统计引擎（工业数据采集系统的数据处理阶段）
+ * 学习要点：
+ * 1. 工业数据采集与监控系统.c的ProcessedData_t按HISTORY_SIZE个历史值算平均/最大/最小，
+ *    每来一个样本就重扫一遍历史，窗口越大越慢
+ * 2. Welford算法：增量更新均值和方差，O(1)，不需要保存历史，数值上比"平方和"稳定
+ * 3. 单调队列：滑动窗口最大/最小值，每个样本最多进出队列一次，均摊O(1)
+ * 4. EWMA（指数加权滑动平均）：一次乘加，跟踪最近的趋势；
+ *    滑动窗口均值：环形缓冲 + 累加和，进一个减一个，和原系统的"最近HISTORY_SIZE个样本平均"含义相同
+ * 5. P²分位数估计：5个标记点估计任意分位数（如P95），O(1)更新，固定内存
+ * 6. 每个通道可以单独选择要算的统计量和窗口长度
+ * 7. 性能测试：10000个通道×1kHz采样，各种配置下每次更新的开销和CPU占用
+ *
+ * 对应场景：工业数据采集与监控系统.c的DataProcessTask，温度/湿度/压力通道的统计与告警
+ *
+ * 性能测试的静态内存约19MB（10000通道×64窗口），在MCU上运行时把BENCH_CHANNELS和BENCH_WINDOW调小
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 流式统计 ====================
+//每个通道要算的统计量
+#define STATS_MEAN_VAR      (1U<<0)     //Welford均值/方差（全程）
+#define STATS_WINDOW_MINMAX (1U<<1)     //滑动窗口最大/最小值
+#define STATS_EWMA          (1U<<2)     //指数加权滑动平均
+#define STATS_PERCENTILE    (1U<<3)     //P²分位数估计
+#define STATS_WINDOW_MEAN   (1U<<4)     //滑动窗口均值
+#define STATS_WINDOW_FLAGS  (STATS_WINDOW_MINMAX|STATS_WINDOW_MEAN)
+#define STATS_ALL           (STATS_MEAN_VAR|STATS_WINDOW_MINMAX|STATS_EWMA|STATS_PERCENTILE|STATS_WINDOW_MEAN)
+
+#define STATS_WINDOW_MAX    1024        //单个通道滑动窗口上限
+
+typedef struct{
+    uint8_t flags;          //STATS_xxx组合
+    uint16_t window;        //滑动窗口长度（样本数），STATS_WINDOW_MINMAX/STATS_WINDOW_MEAN时有效
+    float ewma_alpha;       //EWMA系数，0~1，越大越跟手
+    float quantile;         //要估计的分位数，如0.95
+}StatsConfig_t;
+
+//单调队列：环形缓冲里存值和样本序号，容量等于窗口长度
+typedef struct{
+    float *value;
+    uint32_t *seq;
+    uint16_t head;
+    uint16_t size;
+}MonoDeque_t;
+
+//P²算法的5个标记点
+typedef struct{
+    float height[5];        //标记点的高度（估计值）
+    float desired[5];       //期望位置
+    float increment[5];     //每个样本期望位置的增量
+    int32_t position[5];    //实际位置
+}P2Quantile_t;
+
+typedef struct{
+    StatsConfig_t cfg;
+    uint32_t count;
+
+    //Welford
+    float mean;
+    float m2;               //与均值之差的平方和
+    float min;              //全程最小/最大
+    float max;
+
+    float ewma;
+
+    MonoDeque_t max_q;      //队首是窗口最大值，值单调递减
+    MonoDeque_t min_q;      //队首是窗口最小值，值单调递增
+
+    float *window_samples;  //窗口内的样本，环形缓冲
+    float window_sum;
+    uint16_t window_pos;    //下一个样本写入的位置
+
+    P2Quantile_t p2;
+}StatsChannel_t;
+
+//查询结果
+typedef struct{
+    uint32_t count;
+    float mean;
+    float stddev;
+    float min;
+    float max;
+    float window_min;
+    float window_max;
+    float window_mean;
+    float ewma;
+    float percentile;
+}StatsSummary_t;
+
+
+// ==================== 单调队列 ====================
+static inline uint16_t deque_index(const StatsChannel_t *ch, uint32_t i){
+    return (uint16_t)((i>=ch->cfg.window)?(i-ch->cfg.window):i);
+}
+
+/**
+ * 把样本压入单调队列并淘汰窗口外的元素
+ * 参数：greater pdTRUE维护最大值（队尾不大于新值的都出队），pdFALSE维护最小值
+ */
+static inline void deque_push(StatsChannel_t *ch, MonoDeque_t *q, float x, BaseType_t greater){
+    uint32_t seq=ch->count;
+
+    //队首滑出窗口（先淘汰再入队，队列长度不会超过窗口）
+    if(q->size>0&&seq-q->seq[q->head]>=ch->cfg.window){
+        q->head=deque_index(ch,(uint32_t)q->head+1);
+        q->size--;
+    }
+    //队尾被新样本"压制"的元素永远不会再成为最值
+    while(q->size>0){
+        uint16_t back=deque_index(ch,(uint32_t)q->head+q->size-1);
+        if(greater?(q->value[back]>x):(q->value[back]<x)){
+            break;
+        }
+        q->size--;
+    }
+    {
+        uint16_t slot=deque_index(ch,(uint32_t)q->head+q->size);
+        q->value[slot]=x;
+        q->seq[slot]=seq;
+        q->size++;
+    }
+}
+
+
+// ==================== P²分位数 ====================
+static void p2_init(P2Quantile_t *p2, float quantile){
+    float p=quantile;
+
+    p2->desired[0]=0.0f;
+    p2->desired[1]=2.0f*p;
+    p2->desired[2]=4.0f*p;
+    p2->desired[3]=2.0f+2.0f*p;
+    p2->desired[4]=4.0f;
+    p2->increment[0]=0.0f;
+    p2->increment[1]=p/2.0f;
+    p2->increment[2]=p;
+    p2->increment[3]=(1.0f+p)/2.0f;
+    p2->increment[4]=1.0f;
+    for(int i=0;i<5;i++){
+        p2->position[i]=i;
+    }
+}
+
+/**
+ * P²更新
+ * 功能：前5个样本直接插入排序；之后找到样本所在的区间，右边的标记点位置加1，
+ *      中间3个标记点偏离期望位置超过1时用分段抛物线（不单调时退化为线性）调整高度
+ */
+static void p2_update(P2Quantile_t *p2, uint32_t count, float x){
+    float *q=p2->height;
+    int32_t *n=p2->position;
+    int k;
+
+    if(count<5){
+        int i=(int)count;
+        while(i>0&&q[i-1]>x){
+            q[i]=q[i-1];
+            i--;
+        }
+        q[i]=x;
+        return;
+    }
+
+    if(x<q[0]){
+        q[0]=x;
+        k=0;
+    }else if(x>=q[4]){
+        q[4]=x;
+        k=3;
+    }else{
+        k=0;
+        while(k<3&&x>=q[k+1]){
+            k++;
+        }
+    }
+
+    for(int i=k+1;i<5;i++){
+        n[i]++;
+    }
+    for(int i=0;i<5;i++){
+        p2->desired[i]+=p2->increment[i];
+    }
+
+    for(int i=1;i<4;i++){
+        float d=p2->desired[i]-(float)n[i];
+
+        if((d>=1.0f&&n[i+1]-n[i]>1)||(d<=-1.0f&&n[i-1]-n[i]<-1)){
+            int s=(d>=0.0f)?1:-1;
+            float qp=q[i]+(float)s/(float)(n[i+1]-n[i-1])*
+                     ((float)(n[i]-n[i-1]+s)*(q[i+1]-q[i])/(float)(n[i+1]-n[i])+
+                      (float)(n[i+1]-n[i]-s)*(q[i]-q[i-1])/(float)(n[i]-n[i-1]));
+
+            if(q[i-1]<qp&&qp<q[i+1]){
+                q[i]=qp;
+            }else{
+                q[i]+=(float)s*(q[i+s]-q[i])/(float)(n[i+s]-n[i]);
+            }
+            n[i]+=s;
+        }
+    }
+}
+
+static float p2_result(const P2Quantile_t *p2, uint32_t count, float quantile){
+    if(count==0){
+        return 0.0f;
+    }
+    if(count<5){
+        //样本不足5个时直接取排序后的近似位置
+        return p2->height[(uint32_t)(quantile*(float)(count-1)+0.5f)];
+    }
+    return p2->height[2];
+}
+
+
+// ==================== 通道管理 ====================
+//通道的滑动窗口（单调队列和样本环形缓冲）需要的存储字节数
+static inline size_t Stats_StorageSize(const StatsConfig_t *cfg){
+    if(!(cfg->flags&STATS_WINDOW_FLAGS)){
+        return 0;
+    }
+    return 2U*cfg->window*(sizeof(float)+sizeof(uint32_t))+cfg->window*sizeof(float);
+}
+
+//按窗口长度声明滑动窗口的存储：成员按实际元素类型声明，保证对齐，也不需要把字节数组当float/uint32_t访问
+//布局是Stats_ChannelInit()使用的顺序，大小等于Stats_StorageSize()
+#define STATS_WINDOW_STORAGE(window) \
+    struct{ float max_value[window]; float min_value[window]; uint32_t max_seq[window]; uint32_t min_seq[window]; \
+            float samples[window]; }
+
+/**
+ * 初始化通道
+ * 参数：storage 滑动窗口的存储，用STATS_WINDOW_STORAGE(cfg->window)声明；不需要窗口时可为NULL
+ * 返回：pdPASS成功，窗口长度非法返回pdFAIL
+ */
+BaseType_t Stats_ChannelInit(StatsChannel_t *ch, const StatsConfig_t *cfg, void *storage){
+    memset(ch,0,sizeof(StatsChannel_t));
+    ch->cfg=*cfg;
+
+    if(cfg->flags&STATS_WINDOW_FLAGS){
+        float *values=(float*)storage;
+        uint32_t *seqs;
+
+        if(storage==NULL||cfg->window==0||cfg->window>STATS_WINDOW_MAX){
+            return pdFAIL;
+        }
+        seqs=(uint32_t*)(values+2U*cfg->window);
+        ch->max_q.value=values;
+        ch->min_q.value=values+cfg->window;
+        ch->max_q.seq=seqs;
+        ch->min_q.seq=seqs+cfg->window;
+        ch->window_samples=(float*)(seqs+2U*cfg->window);
+    }
+    if(cfg->flags&STATS_PERCENTILE){
+        p2_init(&ch->p2,cfg->quantile);
+    }
+    return pdPASS;
+}
+
+/**
+ * 加入一个样本，O(1)（单调队列均摊O(1)）
+ */
+void Stats_Update(StatsChannel_t *ch, float x){
+    uint8_t flags=ch->cfg.flags;
+
+    if(flags&STATS_MEAN_VAR){
+        float delta=x-ch->mean;
+        ch->mean+=delta/(float)(ch->count+1);
+        ch->m2+=delta*(x-ch->mean);
+        if(ch->count==0||x<ch->min){
+            ch->min=x;
+        }
+        if(ch->count==0||x>ch->max){
+            ch->max=x;
+        }
+    }
+    if(flags&STATS_EWMA){
+        ch->ewma=(ch->count==0)?x:ch->ewma+ch->cfg.ewma_alpha*(x-ch->ewma);
+    }
+    if(flags&STATS_WINDOW_MEAN){
+        if(ch->count>=ch->cfg.window){
+            ch->window_sum-=ch->window_samples[ch->window_pos];
+        }
+        ch->window_samples[ch->window_pos]=x;
+        ch->window_sum+=x;
+        if(++ch->window_pos==ch->cfg.window){
+            //每转一圈按缓冲区重新求和，消掉浮点加减累积的误差，均摊下来仍是O(1)
+            ch->window_pos=0;
+            ch->window_sum=0.0f;
+            for(uint16_t i=0;i<ch->cfg.window;i++){
+                ch->window_sum+=ch->window_samples[i];
+            }
+        }
+    }
+    if(flags&STATS_WINDOW_MINMAX){
+        deque_push(ch,&ch->max_q,x,pdTRUE);
+        deque_push(ch,&ch->min_q,x,pdFALSE);
+    }
+    if(flags&STATS_PERCENTILE){
+        p2_update(&ch->p2,ch->count,x);
+    }
+    ch->count++;
+}
+
+void Stats_GetSummary(const StatsChannel_t *ch, StatsSummary_t *out){
+    memset(out,0,sizeof(StatsSummary_t));
+    out->count=ch->count;
+    if(ch->count==0){
+        return;
+    }
+    out->mean=ch->mean;
+    out->stddev=(ch->count>1)?sqrtf(ch->m2/(float)(ch->count-1)):0.0f;
+    out->min=ch->min;
+    out->max=ch->max;
+    out->ewma=ch->ewma;
+    if(ch->cfg.flags&STATS_WINDOW_MINMAX){
+        out->window_max=ch->max_q.value[ch->max_q.head];
+        out->window_min=ch->min_q.value[ch->min_q.head];
+    }
+    if(ch->cfg.flags&STATS_WINDOW_MEAN){
+        out->window_mean=ch->window_sum/(float)((ch->count<ch->cfg.window)?ch->count:ch->cfg.window);
+    }
+    if(ch->cfg.flags&STATS_PERCENTILE){
+        out->percentile=p2_result(&ch->p2,ch->count,ch->cfg.quantile);
+    }
+}
+
+
+// ==================== 工业数据采集系统的数据处理 ====================
+#define TEMP_ALARM_THRESHOLD        80.0f   // 温度告警阈值
+#define HUMIDITY_ALARM_THRESHOLD    90.0f   // 湿度告警阈值
+#define HISTORY_SIZE                10      // 与原系统的历史长度一致，作为滑动窗口长度
+
+typedef struct {
+    float temperature;    // 温度 (°C)
+    float humidity;      // 湿度 (%)
+    float pressure;      // 压力 (kPa)
+    uint32_t timestamp;  // 时间戳
+    uint8_t status;      // 状态标志
+} SensorData_t;
+
+typedef struct {
+    SensorData_t data;
+    float temp_avg;      // 温度平均值
+    float temp_max;      // 温度最大值
+    float temp_min;      // 温度最小值
+    uint8_t alarm_flags; // 告警标志
+} ProcessedData_t;
+
+enum{
+    CH_TEMPERATURE=0,
+    CH_HUMIDITY,
+    CH_PRESSURE,
+    CH_COUNT
+};
+
+static StatsChannel_t sensor_channels[CH_COUNT];
+static STATS_WINDOW_STORAGE(HISTORY_SIZE) sensor_channel_storage[CH_COUNT];
+static QueueHandle_t xSensorDataQueue;
+
+//每个通道的配置不同：温度全要，湿度只要平均和窗口极值，压力只要均值方差和P99
+static const StatsConfig_t sensor_channel_cfg[CH_COUNT]={
+    [CH_TEMPERATURE]={STATS_ALL,HISTORY_SIZE,0.2f,0.95f},
+    [CH_HUMIDITY]   ={STATS_EWMA|STATS_WINDOW_MINMAX,HISTORY_SIZE,0.1f,0.0f},
+    [CH_PRESSURE]   ={STATS_MEAN_VAR|STATS_PERCENTILE,0,0.0f,0.99f},
+};
+
+void SensorTask(void *pvParameters){
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+    uint32_t tick=0;
+
+    for(;;){
+        SensorData_t data;
+
+        //模拟：温度缓慢上升并带噪声，偶尔有尖峰
+        tick++;
+        data.temperature=25.0f+(float)(tick%600)/10.0f+(float)(rand()%50)/10.0f;
+        if(tick%97==0){
+            data.temperature+=30.0f;
+        }
+        data.humidity=50.0f+(float)(rand()%200)/10.0f;
+        data.pressure=101.3f+(float)(rand()%100)/100.0f;
+        data.timestamp=xTaskGetTickCount();
+        data.status=0;
+
+        xQueueSend(xSensorDataQueue,&data,0);
+        vTaskDelayUntil(&xLastWakeTime,pdMS_TO_TICKS(100));
+    }
+}
+
+/**
+ * 数据处理任务：每个样本O(1)更新统计量，再从摘要里填ProcessedData_t
+ */
+void DataProcessTask(void *pvParameters){
+    SensorData_t data;
+    uint32_t processed=0;
+
+    for(;;){
+        if(xQueueReceive(xSensorDataQueue,&data,portMAX_DELAY)==pdTRUE){
+            ProcessedData_t result;
+            StatsSummary_t temp,hum,press;
+
+            Stats_Update(&sensor_channels[CH_TEMPERATURE],data.temperature);
+            Stats_Update(&sensor_channels[CH_HUMIDITY],data.humidity);
+            Stats_Update(&sensor_channels[CH_PRESSURE],data.pressure);
+
+            Stats_GetSummary(&sensor_channels[CH_TEMPERATURE],&temp);
+            result.data=data;
+            result.temp_avg=temp.window_mean;   //与原系统一致：最近HISTORY_SIZE个样本的平均
+            result.temp_max=temp.window_max;
+            result.temp_min=temp.window_min;
+            result.alarm_flags=0;
+            if(data.temperature>TEMP_ALARM_THRESHOLD){
+                result.alarm_flags|=0x01;
+            }
+            if(data.humidity>HUMIDITY_ALARM_THRESHOLD){
+                result.alarm_flags|=0x02;
+            }
+
+            processed++;
+            if(processed%50==0){
+                Stats_GetSummary(&sensor_channels[CH_HUMIDITY],&hum);
+                Stats_GetSummary(&sensor_channels[CH_PRESSURE],&press);
+                printf("\n[统计] 第%lu个样本\n", processed);
+                printf("  温度: 窗口平均%.1f 窗口[%.1f, %.1f] EWMA%.1f 全程均值%.1f±%.1f P95=%.1f 告警0x%02X\n",
+                       result.temp_avg, result.temp_min, result.temp_max, temp.ewma,
+                       temp.mean, temp.stddev, temp.percentile, result.alarm_flags);
+                printf("  湿度: EWMA%.1f 窗口[%.1f, %.1f]\n", hum.ewma, hum.window_min, hum.window_max);
+                printf("  压力: 均值%.2f±%.3f P99=%.2f\n", press.mean, press.stddev, press.percentile);
+            }
+        }
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_CHANNELS      10000   //通道数
+#define BENCH_RATE_HZ       1000    //每通道采样率
+#define BENCH_ROUNDS        200     //测量的采样轮数（每轮每个通道一个样本）
+#define BENCH_WINDOW        64      //滑动窗口长度
+#define BENCH_NOISE_SIZE    4096
+
+static StatsChannel_t bench_channels[BENCH_CHANNELS];
+static STATS_WINDOW_STORAGE(HISTORY_SIZE) bench_storage_short[BENCH_CHANNELS];   //窗口10的配置用
+static STATS_WINDOW_STORAGE(BENCH_WINDOW) bench_storage[BENCH_CHANNELS];          //窗口64的配置用
+static float bench_history[BENCH_CHANNELS][BENCH_WINDOW];      //原系统做法：历史环形缓冲
+static float bench_noise[BENCH_NOISE_SIZE];
+
+static inline float bench_sample(uint32_t ch, uint32_t round){
+    return 25.0f+(float)(ch&63)+bench_noise[(ch*7+round*13)&(BENCH_NOISE_SIZE-1)];
+}
+
+/**
+ * 原系统的做法：样本写进历史环形缓冲，然后重扫整个窗口求平均/最大/最小
+ */
+static uint32_t bench_rescan(uint32_t window){
+    volatile float sink=0.0f;
+    uint32_t start=cycle_counter_get();
+
+    for(uint32_t round=0;round<BENCH_ROUNDS;round++){
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            float *hist=bench_history[ch];
+            float sum=0.0f,max,min;
+
+            hist[round%window]=bench_sample(ch,round);
+            max=min=hist[0];
+            for(uint32_t i=0;i<window;i++){
+                sum+=hist[i];
+                if(hist[i]>max) max=hist[i];
+                if(hist[i]<min) min=hist[i];
+            }
+            sink+=sum/(float)window+max-min;
+        }
+    }
+    (void)sink;
+    return cycle_counter_get()-start;
+}
+
+static uint32_t bench_engine(uint8_t flags, uint16_t window){
+    StatsConfig_t cfg={flags,window,0.1f,0.95f};
+    uint32_t start;
+
+    //存储按实际的窗口长度取，通道之间的间距和实际部署时一样
+    configASSERT(window==0||window==HISTORY_SIZE||window==BENCH_WINDOW);
+    for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+        void *storage=NULL;
+        if(window==HISTORY_SIZE){
+            storage=&bench_storage_short[ch];
+        }else if(window==BENCH_WINDOW){
+            storage=&bench_storage[ch];
+        }
+        Stats_ChannelInit(&bench_channels[ch],&cfg,storage);
+    }
+
+    start=cycle_counter_get();
+    for(uint32_t round=0;round<BENCH_ROUNDS;round++){
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            Stats_Update(&bench_channels[ch],bench_sample(ch,round));
+        }
+    }
+    return cycle_counter_get()-start;
+}
+
+/**
+ * 打印一行：每次更新的开销，以及10000通道×1kHz时需要的CPU比例
+ */
+static void bench_report(const char *name, uint32_t elapsed){
+    uint64_t updates=(uint64_t)BENCH_CHANNELS*BENCH_ROUNDS;
+    uint64_t per_second=(uint64_t)elapsed*BENCH_RATE_HZ/BENCH_ROUNDS;   //处理1秒数据的耗时
+
+    printf("  %-28s %6lu.%02lu %-6s %5lu%%\n", name,
+           (uint32_t)(elapsed/updates), (uint32_t)((uint64_t)elapsed*100/updates%100), CYCLE_UNIT,
+           (uint32_t)(per_second*100/CYCLES_PER_SECOND));
+}
+
+void bench_task(void *pvParameters){
+    vTaskDelay(pdMS_TO_TICKS(6000));
+    cycle_counter_init();
+
+    for(uint32_t i=0;i<BENCH_NOISE_SIZE;i++){
+        bench_noise[i]=(float)(rand()%1000)/100.0f;
+    }
+    memset(bench_history,0,sizeof(bench_history));
+
+    printf("\n[性能测试] %d通道×%dHz，测量%d轮\n", BENCH_CHANNELS, BENCH_RATE_HZ, BENCH_ROUNDS);
+    printf("  配置                         每次更新          CPU占用\n");
+    bench_report("重扫历史(窗口10)",bench_rescan(HISTORY_SIZE));
+    bench_report("重扫历史(窗口64)",bench_rescan(BENCH_WINDOW));
+    bench_report("Welford均值方差",bench_engine(STATS_MEAN_VAR,0));
+    bench_report("EWMA",bench_engine(STATS_EWMA,0));
+    bench_report("滑动窗口均值(窗口10)",bench_engine(STATS_WINDOW_MEAN,HISTORY_SIZE));
+    bench_report("单调队列极值(窗口10)",bench_engine(STATS_WINDOW_MINMAX,HISTORY_SIZE));
+    bench_report("单调队列极值(窗口64)",bench_engine(STATS_WINDOW_MINMAX,BENCH_WINDOW));
+    bench_report("P²分位数",bench_engine(STATS_PERCENTILE,0));
+    bench_report("全部(窗口64)",bench_engine(STATS_ALL,BENCH_WINDOW));
+    printf("  CPU占用超过100%%表示单核处理不过来，需要减少通道或降低采样率\n");
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    printf("=== 流式统计引擎 ===\n");
+
+    for(int i=0;i<CH_COUNT;i++){
+        Stats_ChannelInit(&sensor_channels[i],&sensor_channel_cfg[i],&sensor_channel_storage[i]);
+    }
+
+    xSensorDataQueue=xQueueCreate(10,sizeof(SensorData_t));
+    if(!xSensorDataQueue){
+        printf("ERROR: Failed to create queue!\n");
+        return -1;
+    }
+
+    xTaskCreate(SensorTask, "Sensor", 256, NULL, 3, NULL);
+    xTaskCreate(DataProcessTask, "DataProc", 512, NULL, 2, NULL);
+    xTaskCreate(bench_task, "Bench", 512, NULL, 1, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 为什么不重扫历史：
+   - 每个样本O(窗口)，通道多、窗口大时开销成倍增长
+   - 历史缓冲本身也要占内存：通道数×窗口×4字节
+
+2. Welford：
+   - mean += delta/n；m2 += delta*(x-新mean)；方差 = m2/(n-1)
+   - 避免"平方和-和的平方"的大数相减，float下也不容易丢精度
+
+3. 单调队列：
+   - 最大值队列里的值单调递减，新样本把队尾比它小的都挤掉
+   - 队首的序号滑出窗口就出队，队首永远是窗口最大值
+   - 每个样本最多进出各一次，均摊O(1)，最坏情况（单调序列）也只有一次比较
+
+4. P²分位数：
+   - 5个标记点：最小、p/2、p、(1+p)/2、最大
+   - 每个样本只调整标记点的位置和高度，不保存样本
+   - 估计值在样本分布平滑时很准，不适合离散值很少的数据
+
+5. 按通道配置：
+   - 只算需要的统计量，分支在通道内不变，分支预测几乎不会失败
+   - 滑动窗口的存储由调用者按窗口长度提供，不需要窗口的通道不占这部分内存
+*/
@@ -0,0 +1,659 @@
+/*
+ * Demo: 遥测编码器（通信任务的紧凑二进制帧）
+ * 学习要点：
+ * 1. 工业数据采集与监控系统.c的CommunicationTask、综合.c的CommTask直接转发float结构体，
+ *    或者用printf格式化成文本；上行链路带宽有限，一个样本20字节（文本约25字节）太贵
+ * 2. 批量成帧：一帧装很多个样本，按通道分列存放（列存），同一列相邻的值相近，容易压缩
+ * 3. 时间戳：delta-of-delta（二阶差分），固定周期采样时每个样本只要1字节
+ * 4. 量化值：按通道的分辨率（如0.01℃）转成整数，存相邻差值，再zig-zag + varint：
+ *    - zig-zag把有符号数映射成无符号：0,-1,1,-2,2 → 0,1,2,3,4，小的负数也很短
+ *    - varint每字节7位有效数据，最高位表示后面还有没有，小数值1字节
+ * 5. Gorilla XOR（可选，无损）：当前float与上一个异或，相同为1位，
+ *    不同时只存中间有效位，前导零/尾随零落在上一个窗口内时不用重复存窗口
+ * 6. 帧尾CRC-16（半字节查表），接收端可以发现传输错误
+ * 7. 性能测试：真实感的传感器轨迹，各种方式的字节数/压缩比和编码吞吐量
+ *
+ * 对应场景：工业数据采集与监控系统.c的CommunicationTask/xCommQueue，综合.c的CommTask
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 批量缓冲区 ====================
+#define TELEM_MAX_CHANNELS  4
+#define TELEM_MAX_SAMPLES   256
+#define TELEM_SYNC          0xA5
+#define TELEM_VERSION       1
+
+//帧的最坏长度：头部 + 时间戳每个最多5字节 + 每列每个值最多6字节（Gorilla最坏44位）+ CRC
+#define TELEM_FRAME_MAX(channels,samples)   (16+5*(samples)+(channels)*(6*(samples)+5)+2)
+
+typedef enum{
+    TELEM_QUANT_DELTA=0,    //量化 + 差分 + zig-zag varint，有损（误差不超过半个分辨率）
+    TELEM_GORILLA           //Gorilla XOR，无损
+}TelemetryMode_t;
+
+typedef struct{
+    uint8_t mode;           //TelemetryMode_t
+    uint8_t decimals;       //量化的小数位数：分辨率为10^-decimals，0~7
+}TelemetryChannel_t;
+
+typedef struct{
+    uint8_t num_channels;
+    uint16_t num_samples;
+    TelemetryChannel_t channel[TELEM_MAX_CHANNELS];
+    uint32_t timestamp[TELEM_MAX_SAMPLES];
+    float value[TELEM_MAX_CHANNELS][TELEM_MAX_SAMPLES];     //按通道分列存放
+}TelemetryBatch_t;
+
+static const float telem_scale[8]={ 1.0f, 10.0f, 100.0f, 1000.0f, 1e4f, 1e5f, 1e6f, 1e7f };
+
+/**
+ * 初始化批量缓冲区
+ * 返回：pdPASS成功；通道配置非法返回pdFAIL
+ */
+BaseType_t Telemetry_BatchInit(TelemetryBatch_t *batch, const TelemetryChannel_t *channels, uint8_t num_channels){
+    if(num_channels==0||num_channels>TELEM_MAX_CHANNELS){
+        return pdFAIL;
+    }
+    for(uint8_t ch=0;ch<num_channels;ch++){
+        if(channels[ch].mode>TELEM_GORILLA||channels[ch].decimals>7){
+            return pdFAIL;
+        }
+        batch->channel[ch]=channels[ch];
+    }
+    batch->num_channels=num_channels;
+    batch->num_samples=0;
+    return pdPASS;
+}
+
+/**
+ * 加入一个样本
+ * 参数：values 每个通道一个值
+ * 返回：pdPASS成功；缓冲区满返回pdFAIL（调用者先编码发送，再重新开始）
+ */
+BaseType_t Telemetry_BatchAdd(TelemetryBatch_t *batch, uint32_t timestamp, const float *values){
+    uint16_t n=batch->num_samples;
+
+    if(n>=TELEM_MAX_SAMPLES){
+        return pdFAIL;
+    }
+    batch->timestamp[n]=timestamp;
+    for(uint8_t ch=0;ch<batch->num_channels;ch++){
+        batch->value[ch][n]=values[ch];
+    }
+    batch->num_samples=n+1;
+    return pdPASS;
+}
+
+
+// ==================== 基本编码 ====================
+static inline uint32_t zigzag_encode(int32_t v){
+    return ((uint32_t)v<<1)^(uint32_t)(v>>31);
+}
+
+static inline int32_t zigzag_decode(uint32_t v){
+    return (int32_t)(v>>1)^-(int32_t)(v&1);
+}
+
+//写varint，调用者保证至少还有5字节空间
+static inline uint8_t *varint_put(uint8_t *p, uint32_t v){
+    while(v>=0x80){
+        *p++=(uint8_t)(v|0x80);
+        v>>=7;
+    }
+    *p++=(uint8_t)v;
+    return p;
+}
+
+//读varint，越界或超过5字节返回NULL
+static const uint8_t *varint_get(const uint8_t *p, const uint8_t *end, uint32_t *v){
+    uint32_t result=0;
+
+    for(uint32_t shift=0;shift<35;shift+=7){
+        uint8_t byte;
+        if(p>=end){
+            return NULL;
+        }
+        byte=*p++;
+        result|=(uint32_t)(byte&0x7F)<<shift;
+        if((byte&0x80)==0){
+            *v=result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+//CRC-16/CCITT-FALSE，按半字节查表：每字节两次查表代替8次移位，表只有16项（32字节），比256项的表省ROM
+static const uint16_t crc16_nibble[16]={
+    0x0000,0x1021,0x2042,0x3063,0x4084,0x50A5,0x60C6,0x70E7,
+    0x8108,0x9129,0xA14A,0xB16B,0xC18C,0xD1AD,0xE1CE,0xF1EF
+};
+
+static uint16_t crc16_ccitt(const uint8_t *data, uint32_t len){
+    uint16_t crc=0xFFFF;
+
+    for(uint32_t i=0;i<len;i++){
+        crc=(uint16_t)((crc<<4)^crc16_nibble[(crc>>12)^(data[i]>>4)]);
+        crc=(uint16_t)((crc<<4)^crc16_nibble[(crc>>12)^(data[i]&0x0F)]);
+    }
+    return crc;
+}
+
+static inline uint32_t float_bits(float f){
+    uint32_t u;
+    memcpy(&u,&f,sizeof(u));
+    return u;
+}
+
+static inline float bits_float(uint32_t u){
+    float f;
+    memcpy(&f,&u,sizeof(f));
+    return f;
+}
+
+
+// ==================== 位流（Gorilla用） ====================
+typedef struct{
+    uint8_t *p;
+    uint64_t acc;           //未写出的位，最多7+32位
+    uint32_t nbits;
+}BitWriter_t;
+
+static inline void bits_put(BitWriter_t *bw, uint32_t value, uint32_t bits){
+    bw->acc=(bw->acc<<bits)|((uint64_t)value&((1ULL<<bits)-1));
+    bw->nbits+=bits;
+    while(bw->nbits>=8){
+        bw->nbits-=8;
+        *bw->p++=(uint8_t)(bw->acc>>bw->nbits);
+    }
+}
+
+//补齐到字节边界
+static inline uint8_t *bits_flush(BitWriter_t *bw){
+    if(bw->nbits){
+        *bw->p++=(uint8_t)(bw->acc<<(8-bw->nbits));
+        bw->nbits=0;
+    }
+    return bw->p;
+}
+
+typedef struct{
+    const uint8_t *p;
+    const uint8_t *end;
+    uint64_t acc;
+    uint32_t nbits;
+    uint8_t error;          //读越界
+}BitReader_t;
+
+static inline uint32_t bits_get(BitReader_t *br, uint32_t bits){
+    while(br->nbits<bits){
+        br->acc=(br->acc<<8)|(br->p<br->end?*br->p:0);
+        br->error|=(br->p>=br->end);
+        br->p++;
+        br->nbits+=8;
+    }
+    br->nbits-=bits;
+    return (uint32_t)((br->acc>>br->nbits)&((1ULL<<bits)-1));
+}
+
+
+// ==================== 列编码 ====================
+//量化 + 差分：第一个值相对0，之后相对前一个；差值按32位回绕计算，解码时同样回绕，不会溢出出错
+static uint8_t *encode_quant_column(uint8_t *p, const float *values, uint16_t n, uint8_t decimals){
+    float scale=telem_scale[decimals];
+    uint32_t prev=0;
+
+    for(uint16_t i=0;i<n;i++){
+        uint32_t q=(uint32_t)(int32_t)lrintf(values[i]*scale);
+        p=varint_put(p,zigzag_encode((int32_t)(q-prev)));
+        prev=q;
+    }
+    return p;
+}
+
+/**
+ * Gorilla XOR：
+ *   第一个值原样32位
+ *   与上一个相同：    '0'
+ *   有效位落在窗口内：'10' + 窗口内的位
+ *   否则：            '11' + 前导零(5位) + 有效长度-1(5位) + 有效位，并更新窗口
+ */
+static uint8_t *encode_gorilla_column(uint8_t *p, const float *values, uint16_t n){
+    BitWriter_t bw={ p, 0, 0 };
+    uint32_t prev,lead=32,trail=0;
+
+    if(n==0){
+        return p;
+    }
+    prev=float_bits(values[0]);
+    bits_put(&bw,prev,32);
+
+    for(uint16_t i=1;i<n;i++){
+        uint32_t cur=float_bits(values[i]);
+        uint32_t x=cur^prev;
+        prev=cur;
+
+        if(x==0){
+            bits_put(&bw,0,1);
+        }else{
+            uint32_t l=(uint32_t)__builtin_clz(x);
+            uint32_t t=(uint32_t)__builtin_ctz(x);
+            if(lead<32&&l>=lead&&t>=trail){
+                bits_put(&bw,2,2);
+                bits_put(&bw,x>>trail,32-lead-trail);
+            }else{
+                uint32_t len=32-l-t;
+                bits_put(&bw,3,2);
+                bits_put(&bw,l,5);
+                bits_put(&bw,len-1,5);
+                bits_put(&bw,x>>t,len);
+                lead=l;
+                trail=t;
+            }
+        }
+    }
+    return bits_flush(&bw);
+}
+
+/**
+ * 编码一帧
+ * 帧格式：
+ *   同步字 版本 通道数 | 每通道1字节(模式<<4|小数位) | 样本数(varint)
+ *   时间戳：第一个(varint) 第一个差值(zig-zag varint) 之后每个二阶差分(zig-zag varint)
+ *   每通道一列，Gorilla列按字节对齐
+ *   CRC-16（大端）
+ * 参数：frame 输出缓冲区，capacity不小于TELEM_FRAME_MAX时一定够用
+ * 返回：帧长度；缓冲区不够返回0
+ */
+uint32_t Telemetry_Encode(const TelemetryBatch_t *batch, uint8_t *frame, uint32_t capacity){
+    uint16_t n=batch->num_samples;
+    uint8_t *p=frame;
+    uint16_t crc;
+
+    //只在开头检查一次最坏长度，编码循环里不用逐字节检查
+    if(capacity<(uint32_t)TELEM_FRAME_MAX(batch->num_channels,n)){
+        return 0;
+    }
+
+    *p++=TELEM_SYNC;
+    *p++=TELEM_VERSION;
+    *p++=batch->num_channels;
+    for(uint8_t ch=0;ch<batch->num_channels;ch++){
+        *p++=(uint8_t)(batch->channel[ch].mode<<4|batch->channel[ch].decimals);
+    }
+    p=varint_put(p,n);
+
+    if(n>0){
+        uint32_t prev_delta=0;
+        p=varint_put(p,batch->timestamp[0]);
+        for(uint16_t i=1;i<n;i++){
+            uint32_t delta=batch->timestamp[i]-batch->timestamp[i-1];
+            p=varint_put(p,zigzag_encode((int32_t)(delta-prev_delta)));
+            prev_delta=delta;
+        }
+    }
+
+    for(uint8_t ch=0;ch<batch->num_channels;ch++){
+        if(batch->channel[ch].mode==TELEM_GORILLA){
+            p=encode_gorilla_column(p,batch->value[ch],n);
+        }else{
+            p=encode_quant_column(p,batch->value[ch],n,batch->channel[ch].decimals);
+        }
+    }
+
+    crc=crc16_ccitt(frame,(uint32_t)(p-frame));
+    *p++=(uint8_t)(crc>>8);
+    *p++=(uint8_t)crc;
+    return (uint32_t)(p-frame);
+}
+
+/**
+ * 解码一帧（接收端，也用来在测试里校验）
+ * 返回：pdPASS成功；CRC错误、格式错误或越界返回pdFAIL
+ */
+BaseType_t Telemetry_Decode(const uint8_t *frame, uint32_t len, TelemetryBatch_t *batch){
+    const uint8_t *end;
+    const uint8_t *p=frame;
+    uint32_t n,v;
+
+    //先检查长度再算end：len<2时frame+len-2已经越过了数组开头
+    if(len<6||crc16_ccitt(frame,len-2)!=(uint16_t)(frame[len-2]<<8|frame[len-1])){
+        return pdFAIL;
+    }
+    end=frame+len-2;
+    if(p[0]!=TELEM_SYNC||p[1]!=TELEM_VERSION||p[2]==0||p[2]>TELEM_MAX_CHANNELS){
+        return pdFAIL;
+    }
+    batch->num_channels=p[2];
+    p+=3;
+    if(end-p<batch->num_channels){
+        return pdFAIL;
+    }
+    for(uint8_t ch=0;ch<batch->num_channels;ch++){
+        batch->channel[ch].mode=(uint8_t)(*p>>4);
+        batch->channel[ch].decimals=(uint8_t)(*p&0x0F);
+        if(batch->channel[ch].mode>TELEM_GORILLA||batch->channel[ch].decimals>7){
+            return pdFAIL;
+        }
+        p++;
+    }
+    if((p=varint_get(p,end,&n))==NULL||n>TELEM_MAX_SAMPLES){
+        return pdFAIL;
+    }
+    batch->num_samples=(uint16_t)n;
+
+    if(n>0){
+        uint32_t delta=0;
+        if((p=varint_get(p,end,&batch->timestamp[0]))==NULL){
+            return pdFAIL;
+        }
+        for(uint32_t i=1;i<n;i++){
+            if((p=varint_get(p,end,&v))==NULL){
+                return pdFAIL;
+            }
+            delta+=(uint32_t)zigzag_decode(v);
+            batch->timestamp[i]=batch->timestamp[i-1]+delta;
+        }
+    }
+
+    for(uint8_t ch=0;ch<batch->num_channels;ch++){
+        float *values=batch->value[ch];
+
+        if(batch->channel[ch].mode==TELEM_GORILLA){
+            BitReader_t br={ p, end, 0, 0, 0 };
+            uint32_t prev,lead=0,trail=0;
+
+            if(n==0){
+                continue;
+            }
+            prev=bits_get(&br,32);
+            values[0]=bits_float(prev);
+            for(uint32_t i=1;i<n;i++){
+                if(bits_get(&br,1)){
+                    if(bits_get(&br,1)){
+                        lead=bits_get(&br,5);
+                        trail=32-lead-(bits_get(&br,5)+1);
+                        if(trail>31){
+                            return pdFAIL;
+                        }
+                    }
+                    prev^=bits_get(&br,32-lead-trail)<<trail;
+                }
+                values[i]=bits_float(prev);
+            }
+            if(br.error){
+                return pdFAIL;
+            }
+            p=br.p-br.nbits/8;      //退回预读但没用到的整字节
+        }else{
+            float scale=telem_scale[batch->channel[ch].decimals];
+            uint32_t q=0;
+            for(uint32_t i=0;i<n;i++){
+                if((p=varint_get(p,end,&v))==NULL){
+                    return pdFAIL;
+                }
+                q+=(uint32_t)zigzag_decode(v);
+                values[i]=(float)(int32_t)q/scale;      //除法是正确舍入的，乘倒数会多出误差
+            }
+        }
+    }
+    return (p==end)?pdPASS:pdFAIL;
+}
+
+
+// ==================== 工业数据采集系统的通信任务 ====================
+#define SAMPLE_PERIOD_MS    100
+#define COMM_PERIOD_MS      5000    //每5秒上报一帧，一帧50个样本
+
+typedef struct {
+    float temperature;    // 温度 (°C)
+    float humidity;      // 湿度 (%)
+    float pressure;      // 压力 (kPa)
+    uint32_t timestamp;  // 时间戳
+    uint8_t status;      // 状态标志
+} SensorData_t;
+
+enum{ CH_TEMPERATURE=0, CH_HUMIDITY, CH_PRESSURE, NUM_CHANNELS };
+
+//温度0.01℃、湿度0.1%、压力0.01kPa，与传感器本身的分辨率一致，量化不损失信息
+static const TelemetryChannel_t comm_channels[NUM_CHANNELS]={
+    { TELEM_QUANT_DELTA, 2 },
+    { TELEM_QUANT_DELTA, 1 },
+    { TELEM_QUANT_DELTA, 2 },
+};
+
+QueueHandle_t xCommQueue;          // 通信队列
+static TelemetryBatch_t comm_batch;
+static uint8_t comm_frame[TELEM_FRAME_MAX(NUM_CHANNELS,TELEM_MAX_SAMPLES)];
+
+/**
+ * 模拟一条真实感的传感器轨迹
+ * 温度：日变化 + 慢漂移 + 噪声，按0.01℃的ADC分辨率量化；湿度与温度反相；压力缓慢变化
+ * 时间戳：标称100ms，偶尔有±1 tick的抖动
+ */
+static void simulate_trace(uint32_t n, SensorData_t *data, uint32_t *timestamp){
+    float t=(float)n*SAMPLE_PERIOD_MS/1000.0f;
+    float noise=(float)(rand()%21-10)/100.0f;
+
+    data->temperature=roundf((25.0f+3.0f*sinf(t/600.0f)+0.5f*sinf(t/37.0f)+noise)*100.0f)/100.0f;
+    data->humidity=roundf((55.0f-6.0f*sinf(t/600.0f)+(float)(rand()%5-2)/10.0f)*10.0f)/10.0f;
+    data->pressure=roundf((101.3f+0.2f*sinf(t/1800.0f)+(float)(rand()%3-1)/100.0f)*100.0f)/100.0f;
+    *timestamp+=pdMS_TO_TICKS(SAMPLE_PERIOD_MS)+(uint32_t)((rand()%20==0)?(rand()%3-1):0);
+    data->timestamp=*timestamp;
+    data->status=0;
+}
+
+void SensorTask(void *pvParameters){
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+    uint32_t n=0,timestamp=0;
+
+    for(;;){
+        SensorData_t data;
+        simulate_trace(n++,&data,&timestamp);
+        xQueueSend(xCommQueue,&data,0);
+        vTaskDelayUntil(&xLastWakeTime,pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
+    }
+}
+
+void CommunicationTask(void *pvParameters){
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+
+    Telemetry_BatchInit(&comm_batch,comm_channels,NUM_CHANNELS);
+
+    for(;;){
+        SensorData_t data;
+        uint32_t len;
+
+        //批量缓冲区满就不再取，先发出去，剩下的留在队列里下次再取
+        while(comm_batch.num_samples<TELEM_MAX_SAMPLES&&xQueueReceive(xCommQueue,&data,0)==pdTRUE){
+            float values[NUM_CHANNELS]={ data.temperature, data.humidity, data.pressure };
+            Telemetry_BatchAdd(&comm_batch,data.timestamp,values);
+        }
+
+        if(comm_batch.num_samples>0){
+            len=Telemetry_Encode(&comm_batch,comm_frame,sizeof(comm_frame));
+            //实际应用中在这里交给UART/LoRa/NB-IoT发送
+            printf("[通信] 帧%lu字节，%u个样本（结构体%lu字节，压缩比%.1f）首字节:%02X %02X %02X\n",
+                   len, comm_batch.num_samples,
+                   (uint32_t)(comm_batch.num_samples*sizeof(SensorData_t)),
+                   (float)(comm_batch.num_samples*sizeof(SensorData_t))/(float)len,
+                   comm_frame[0], comm_frame[1], comm_frame[2]);
+            comm_batch.num_samples=0;
+        }
+
+        vTaskDelayUntil(&xLastWakeTime,pdMS_TO_TICKS(COMM_PERIOD_MS));
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_TRACE_SAMPLES 10240   //约17分钟的轨迹
+#define BENCH_ROUNDS        5
+
+static SensorData_t bench_trace[BENCH_TRACE_SAMPLES];
+static TelemetryBatch_t bench_batch;
+static TelemetryBatch_t bench_decoded;
+static uint8_t bench_frame[TELEM_FRAME_MAX(NUM_CHANNELS,TELEM_MAX_SAMPLES)];
+static volatile uint32_t bench_sink;
+
+typedef enum{ BENCH_STRUCT=0, BENCH_TEXT, BENCH_QUANT, BENCH_GORILLA }BenchMethod_t;
+
+/**
+ * 按一种方式把整条轨迹编码一遍
+ * 返回：总字节数；*cycles 编码用时；*errors 解码后与原值的不一致数
+ */
+static uint32_t bench_encode_trace(BenchMethod_t method, uint16_t batch_size, uint32_t *cycles, uint32_t *errors){
+    TelemetryChannel_t channels[NUM_CHANNELS];
+    uint32_t total=0,start;
+
+    for(uint8_t ch=0;ch<NUM_CHANNELS;ch++){
+        channels[ch]=comm_channels[ch];
+        channels[ch].mode=(method==BENCH_GORILLA)?TELEM_GORILLA:TELEM_QUANT_DELTA;
+    }
+    *errors=0;
+    *cycles=0;
+
+    for(uint32_t base=0;base<BENCH_TRACE_SAMPLES;base+=batch_size){
+        uint16_t n=(uint16_t)((BENCH_TRACE_SAMPLES-base<batch_size)?(BENCH_TRACE_SAMPLES-base):batch_size);
+        uint32_t len=0;
+
+        //填批量缓冲区不计时：这一步各方式都一样（结构体方式对应的是入队）
+        Telemetry_BatchInit(&bench_batch,channels,NUM_CHANNELS);
+        for(uint16_t i=0;i<n;i++){
+            const SensorData_t *d=&bench_trace[base+i];
+            float values[NUM_CHANNELS]={ d->temperature, d->humidity, d->pressure };
+            Telemetry_BatchAdd(&bench_batch,d->timestamp,values);
+        }
+
+        start=cycle_counter_get();
+        for(uint32_t round=0;round<BENCH_ROUNDS;round++){
+            switch(method){
+            case BENCH_STRUCT:
+                len=n*sizeof(SensorData_t);
+                memcpy(bench_frame,&bench_trace[base],len);
+                break;
+            case BENCH_TEXT:
+                len=0;
+                for(uint16_t i=0;i<n;i++){
+                    const SensorData_t *d=&bench_trace[base+i];
+                    len+=(uint32_t)snprintf((char*)bench_frame,sizeof(bench_frame),"%lu,%.2f,%.1f,%.2f\n",
+                                            (unsigned long)d->timestamp,d->temperature,d->humidity,d->pressure);
+                }
+                break;
+            default:
+                len=Telemetry_Encode(&bench_batch,bench_frame,sizeof(bench_frame));
+                break;
+            }
+            bench_sink+=bench_frame[0];
+        }
+        *cycles+=(cycle_counter_get()-start)/BENCH_ROUNDS;
+        total+=len;
+
+        if(method==BENCH_QUANT||method==BENCH_GORILLA){
+            if(Telemetry_Decode(bench_frame,len,&bench_decoded)!=pdPASS){
+                *errors+=n;
+                continue;
+            }
+            for(uint16_t i=0;i<n;i++){
+                for(uint8_t ch=0;ch<NUM_CHANNELS;ch++){
+                    float diff=fabsf(bench_decoded.value[ch][i]-bench_batch.value[ch][i]);
+                    //量化：误差不超过半个分辨率；Gorilla：逐位相同
+                    float tol=(method==BENCH_GORILLA)?0.0f:0.5f/telem_scale[channels[ch].decimals]*1.001f;
+                    if(diff>tol){
+                        (*errors)++;
+                    }
+                }
+                if(bench_decoded.timestamp[i]!=bench_batch.timestamp[i]){
+                    (*errors)++;
+                }
+            }
+        }
+    }
+    return total;
+}
+
+void bench_task(void *pvParameters){
+    static const uint16_t batch_sizes[]={10,50,256};
+    static const char *const names[]={"结构体","printf文本","量化+varint","Gorilla XOR"};
+    uint32_t raw=BENCH_TRACE_SAMPLES*sizeof(SensorData_t);
+    uint32_t timestamp=0;
+
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    cycle_counter_init();
+
+    srand(42);
+    for(uint32_t i=0;i<BENCH_TRACE_SAMPLES;i++){
+        simulate_trace(i,&bench_trace[i],&timestamp);
+    }
+
+    printf("\n[性能测试] %d个样本（温度/湿度/压力+时间戳），结构体%lu字节/样本\n",
+           BENCH_TRACE_SAMPLES, (uint32_t)sizeof(SensorData_t));
+    printf("  方式          批量  字节/样本  压缩比  编码(%s/样本)  编码吞吐(千样本/秒)  解码错误\n", CYCLE_UNIT);
+    for(uint32_t m=BENCH_STRUCT;m<=BENCH_GORILLA;m++){
+        for(uint32_t k=0;k<sizeof(batch_sizes)/sizeof(batch_sizes[0]);k++){
+            uint32_t cycles,errors,bytes;
+
+            //结构体和文本与批量大小无关，只测一次
+            if(m<BENCH_QUANT&&k>0){
+                continue;
+            }
+            bytes=bench_encode_trace((BenchMethod_t)m,batch_sizes[k],&cycles,&errors);
+            printf("  %-12s  %4u  %9lu.%02lu  %5lu.%lu  %14lu  %19lu  %8lu\n", names[m], batch_sizes[k],
+                   bytes/BENCH_TRACE_SAMPLES, (bytes*100/BENCH_TRACE_SAMPLES)%100,
+                   raw/bytes, (raw*10/bytes)%10, cycles/BENCH_TRACE_SAMPLES,
+                   (uint32_t)((uint64_t)BENCH_TRACE_SAMPLES*CYCLES_PER_SECOND/(cycles?cycles:1)/1000), errors);
+        }
+    }
+    printf("  （Gorilla对带噪声的十进制量化值效果有限，适合变化慢或者需要无损的通道）\n");
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    srand(1234);
+
+    xCommQueue=xQueueCreate(TELEM_MAX_SAMPLES,sizeof(SensorData_t));
+
+    xTaskCreate(SensorTask, "Sensor", 256, NULL, 3, NULL);
+    xTaskCreate(CommunicationTask, "Comm", 512, NULL, 2, NULL);
+    xTaskCreate(bench_task, "Bench", 1024, NULL, 1, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. 列存 + 批量：
+   - 一帧里同一通道的值连续存放，相邻值的差很小
+   - 帧头、CRC等固定开销由一批样本分摊，批量越大每样本开销越低
+
+2. 整数编码三件套：
+   - 差分（时间戳用二阶差分）：把大数变成小数
+   - zig-zag：把小的负数变成小的正数
+   - varint：小数只占1字节
+
+3. 量化：
+   - 按传感器的实际分辨率量化，不损失有用信息
+   - 误差上限是半个分辨率，解码端按同样的分辨率还原
+
+4. Gorilla XOR：
+   - 无损，适合变化慢或者要求逐位还原的浮点通道
+   - 对带噪声的十进制数，尾数位变化大，压缩效果不如量化
+
+5. 编码端不逐字节检查越界：
+   - 按最坏情况先检查一次缓冲区长度，编码循环里没有分支
+   - 解码端面对的是外部数据，每一步都检查越界和CRC
+*/
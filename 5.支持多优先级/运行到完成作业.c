@@ -0,0 +1,536 @@
+/*
+ * Demo: 运行到完成的作业（同一优先级的作业共用一个栈）
+ * 学习要点：
+ * 1. 仓库里很多任务只是小小的周期循环：demo1.c的三个LED任务，demo4.c的sensor_task/ui_task/communication_task，
+ *    每个都要一个完整的TCB和128~512字的栈，大部分时间栈里只放着一次vTaskDelay的现场
+ * 2. 作业（Job）：一个函数 + 一个小控制块，事件到来时被调用一次，处理完就返回，中间不能阻塞；
+ *    状态放在context里，不放在栈上（无栈、事件驱动）
+ * 3. 每个优先级一个执行器任务：内核按优先级调度执行器，同一级的所有作业在执行器的栈上依次运行，
+ *    高一级的执行器照常抢占低一级的
+ * 4. 事件：其他任务或中断投递事件位；周期/单次定时由执行器自己的定时列表产生，不占用定时器守护任务
+ * 5. 同级作业之间投递事件不需要上下文切换，执行器取下一个作业直接调用
+ * 6. 性能测试：32个周期任务与32个作业的RAM占用、投递到开始执行的延迟、两两乒乓的切换开销
+ *
+ * 对应场景：demo1.c的LED任务，demo4.c的sensor_task/ui_task/communication_task
+ *
+ * 作业函数的限制：不能调用会阻塞的API（vTaskDelay、带等待时间的队列操作等），执行时间要短，
+ * 同一级的其他作业要等它返回；需要等待时返回，等下一个事件
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 作业与执行器 ====================
+#define JOB_EVENT_TIMER     (1UL<<31)   //定时到期，其余31位由用户定义
+
+typedef struct Job Job_t;
+typedef struct JobLevel JobLevel_t;
+
+/**
+ * 作业函数
+ * 参数：job 作业本身（job->context是用户数据）；events 自上次运行以来累积的事件位
+ */
+typedef void (*JobFunction_t)(Job_t *job, uint32_t events);
+
+struct Job{
+    JobFunction_t run;
+    void *context;
+    const char *name;
+    JobLevel_t *level;
+    Job_t *next_ready;              //就绪链表（FIFO）
+    Job_t *next_timer;              //定时链表（按到期时间排序）
+    volatile uint32_t events;       //挂起的事件位，取出时清零
+    TickType_t wake_tick;
+    TickType_t period;              //0：单次定时
+    uint8_t queued;                 //已在就绪链表中
+    uint8_t timer_active;
+    uint32_t runs;
+};
+
+struct JobLevel{
+    TaskHandle_t executor;          //这一级的执行器任务，它的栈就是所有作业共用的栈
+    const char *name;
+    Job_t *ready_head;
+    Job_t *ready_tail;
+    Job_t *timer_head;
+
+    //统计信息
+    uint32_t dispatches;            //作业被调用的次数
+    uint32_t wakeups;               //执行器被唤醒的次数
+    uint32_t max_run;               //最长的一次作业执行时间，运行到完成的作业要短
+};
+
+//把作业挂到就绪链表，调用者在临界段内；返回是否需要唤醒执行器
+static BaseType_t job_enqueue_locked(Job_t *job, uint32_t events){
+    JobLevel_t *level=job->level;
+    BaseType_t was_empty=(level->ready_head==NULL);
+
+    job->events|=events;
+    if(job->queued){
+        return pdFALSE;     //已经在排队，事件位合并
+    }
+    job->queued=1;
+    job->next_ready=NULL;
+    if(level->ready_tail){
+        level->ready_tail->next_ready=job;
+    }else{
+        level->ready_head=job;
+    }
+    level->ready_tail=job;
+    return was_empty;
+}
+
+//按到期时间插入定时链表，调用者在临界段内；返回是否成了新的链表头
+static BaseType_t job_timer_insert_locked(Job_t *job){
+    JobLevel_t *level=job->level;
+    Job_t **link=&level->timer_head;
+
+    while(*link&&(int32_t)((*link)->wake_tick-job->wake_tick)<=0){
+        link=&(*link)->next_timer;
+    }
+    job->next_timer=*link;
+    *link=job;
+    job->timer_active=1;
+    return (link==&level->timer_head);
+}
+
+static void job_timer_remove_locked(Job_t *job){
+    Job_t **link=&job->level->timer_head;
+
+    while(*link&&*link!=job){
+        link=&(*link)->next_timer;
+    }
+    if(*link){
+        *link=job->next_timer;
+    }
+    job->timer_active=0;
+}
+
+/**
+ * 投递事件（任务中调用）
+ * 功能：置事件位，作业不在排队时挂到就绪链表；执行器自己投递给同级作业时不用通知
+ */
+void Job_Post(Job_t *job, uint32_t events){
+    BaseType_t kick;
+
+    taskENTER_CRITICAL();
+    {
+        kick=job_enqueue_locked(job,events);
+    }
+    taskEXIT_CRITICAL();
+
+    if(kick&&xTaskGetCurrentTaskHandle()!=job->level->executor){
+        xTaskNotifyGive(job->level->executor);
+    }
+}
+
+/**
+ * 投递事件（中断中调用）
+ */
+void Job_PostFromISR(Job_t *job, uint32_t events, BaseType_t *pxHigherPriorityTaskWoken){
+    UBaseType_t saved=taskENTER_CRITICAL_FROM_ISR();
+    BaseType_t kick=job_enqueue_locked(job,events);
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+
+    if(kick){
+        vTaskNotifyGiveFromISR(job->level->executor,pxHigherPriorityTaskWoken);
+    }
+}
+
+/**
+ * 启动定时
+ * 参数：delay 第一次到期的延时；period 之后的周期，0表示单次
+ */
+void Job_StartTimer(Job_t *job, TickType_t delay, TickType_t period){
+    BaseType_t kick;
+
+    taskENTER_CRITICAL();
+    {
+        if(job->timer_active){
+            job_timer_remove_locked(job);
+        }
+        job->wake_tick=xTaskGetTickCount()+delay;
+        job->period=period;
+        kick=job_timer_insert_locked(job);
+    }
+    taskEXIT_CRITICAL();
+
+    //新的最早到期时间，执行器要重新算睡多久
+    if(kick&&xTaskGetCurrentTaskHandle()!=job->level->executor){
+        xTaskNotifyGive(job->level->executor);
+    }
+}
+
+void Job_StopTimer(Job_t *job){
+    taskENTER_CRITICAL();
+    {
+        if(job->timer_active){
+            job_timer_remove_locked(job);
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+void Job_Init(Job_t *job, JobLevel_t *level, const char *name, JobFunction_t run, void *context){
+    memset(job,0,sizeof(Job_t));
+    job->level=level;
+    job->name=name;
+    job->run=run;
+    job->context=context;
+}
+
+//到期的定时挂到就绪链表；周期定时按原来的节拍推进，错过的周期不补
+static void job_expire_timers(JobLevel_t *level){
+    TickType_t now=xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    {
+        while(level->timer_head&&(int32_t)(level->timer_head->wake_tick-now)<=0){
+            Job_t *job=level->timer_head;
+            level->timer_head=job->next_timer;
+            job->timer_active=0;
+            if(job->period){
+                do{
+                    job->wake_tick+=job->period;
+                }while((int32_t)(job->wake_tick-now)<=0);
+                job_timer_insert_locked(job);
+            }
+            job_enqueue_locked(job,JOB_EVENT_TIMER);
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+//执行器：睡到最早的定时到期或者被投递唤醒，然后把就绪的作业依次调用完
+static void job_executor(void *pvParameters){
+    JobLevel_t *level=(JobLevel_t*)pvParameters;
+
+    for(;;){
+        TickType_t wait=portMAX_DELAY;
+
+        taskENTER_CRITICAL();
+        {
+            if(level->ready_head!=NULL){
+                wait=0;
+            }else if(level->timer_head!=NULL){
+                int32_t remaining=(int32_t)(level->timer_head->wake_tick-xTaskGetTickCount());
+                wait=(remaining>0)?(TickType_t)remaining:0;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if(wait){
+            ulTaskNotifyTake(pdTRUE,wait);
+            level->wakeups++;
+        }
+        job_expire_timers(level);
+
+        for(;;){
+            Job_t *job;
+            uint32_t events=0,start,elapsed;
+
+            taskENTER_CRITICAL();
+            {
+                job=level->ready_head;
+                if(job){
+                    level->ready_head=job->next_ready;
+                    if(level->ready_head==NULL){
+                        level->ready_tail=NULL;
+                    }
+                    job->queued=0;
+                    events=job->events;
+                    job->events=0;
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if(job==NULL){
+                break;
+            }
+            start=cycle_counter_get();
+            job->run(job,events);
+            elapsed=cycle_counter_get()-start;
+            job->runs++;
+            level->dispatches++;
+            if(elapsed>level->max_run){
+                level->max_run=elapsed;
+            }
+        }
+    }
+}
+
+/**
+ * 创建一级执行器
+ * 参数：priority 这一级作业的优先级；stack_words 共用栈的大小，按这一级最深的作业取
+ * 返回：pdPASS成功
+ */
+BaseType_t JobLevel_Create(JobLevel_t *level, const char *name, UBaseType_t priority, uint16_t stack_words){
+    memset(level,0,sizeof(JobLevel_t));
+    level->name=name;
+    return xTaskCreate(job_executor,name,stack_words,level,priority,&level->executor);
+}
+
+
+// ==================== demo1.c / demo4.c改成作业 ====================
+#define HIGH_LEVEL_PRIORITY     (tskIDLE_PRIORITY + 3)
+#define LOW_LEVEL_PRIORITY      (tskIDLE_PRIORITY + 1)
+#define LEVEL_STACK_WORDS       256
+#define EVENT_BUTTON            (1UL<<0)
+
+static JobLevel_t high_level,low_level;
+
+typedef struct{
+    volatile uint8_t *state;
+    TickType_t half_period;
+}LedContext_t;
+
+volatile uint8_t red_led_state=0;
+volatile uint8_t green_led_state=0;
+volatile uint8_t blue_led_state=0;
+
+static LedContext_t red_ctx={ &red_led_state, pdMS_TO_TICKS(200) };
+static LedContext_t green_ctx={ &green_led_state, pdMS_TO_TICKS(500) };
+static LedContext_t blue_ctx={ &blue_led_state, pdMS_TO_TICKS(1000) };
+static Job_t red_job,green_job,blue_job;
+static Job_t sensor_job,ui_job,comm_job;
+static uint32_t sensor_data=0;
+static uint32_t ui_frames=0,ui_buttons=0;
+
+//LED：原来的"点亮-延时-熄灭-延时"循环，变成每半个周期翻转一次
+static void led_job(Job_t *job, uint32_t events){
+    LedContext_t *ctx=(LedContext_t*)job->context;
+    *ctx->state^=1;
+}
+
+//传感器：20ms一次（demo4.c的sensor_task）
+static void sensor_job_run(Job_t *job, uint32_t events){
+    sensor_data++;
+    for(volatile int i=0;i<1000;i++);
+}
+
+//界面：33ms刷新一帧，按键事件立即响应（不用等下一帧）
+static void ui_job_run(Job_t *job, uint32_t events){
+    if(events&EVENT_BUTTON){
+        ui_buttons++;
+    }
+    if(events&JOB_EVENT_TIMER){
+        ui_frames++;
+        for(volatile int i=0;i<3000;i++);
+    }
+}
+
+//通信：500ms一次，顺便打印状态
+static void comm_job_run(Job_t *job, uint32_t events){
+    for(volatile int i=0;i<5000;i++);
+    printf("[作业] 传感器%lu次 界面%lu帧/按键%lu次 LED:%u%u%u 高级调度%lu次/唤醒%lu次 最长%lu %s\n",
+           sensor_data, ui_frames, ui_buttons, red_led_state, green_led_state, blue_led_state,
+           high_level.dispatches, high_level.wakeups, high_level.max_run, CYCLE_UNIT);
+}
+
+//模拟按键中断：这里用任务投递，中断里用Job_PostFromISR
+void ButtonTask(void *pvParameters){
+    for(;;){
+        vTaskDelay(pdMS_TO_TICKS(700+rand()%600));
+        Job_Post(&ui_job,EVENT_BUTTON);
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_UNITS         32      //任务/作业的数量
+#define BENCH_LATENCY_ROUNDS    1000
+#define BENCH_PINGPONG      10000
+
+static JobLevel_t bench_level;
+static Job_t bench_ping_job,bench_pong_job,bench_probe_job;
+static TaskHandle_t bench_handle,bench_ping_task,bench_pong_task,bench_probe_task;
+static volatile uint32_t bench_run_stamp;
+static volatile uint32_t bench_exchanges;
+
+static void bench_idle_task(void *pvParameters){
+    for(;;){
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+    }
+}
+
+static void bench_noop_job(Job_t *job, uint32_t events){
+}
+
+//延迟探针：记录开始执行的时刻
+static void bench_probe_job_run(Job_t *job, uint32_t events){
+    bench_run_stamp=cycle_counter_get();
+}
+
+static void bench_probe_task_run(void *pvParameters){
+    for(;;){
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+        bench_run_stamp=cycle_counter_get();
+    }
+}
+
+//乒乓：两个作业互相投递，同一个执行器里只是函数调用
+static void bench_ping_job_run(Job_t *job, uint32_t events){
+    if(++bench_exchanges>=BENCH_PINGPONG){
+        xTaskNotifyGive(bench_handle);
+    }else{
+        Job_Post(&bench_pong_job,1);
+    }
+}
+
+static void bench_pong_job_run(Job_t *job, uint32_t events){
+    Job_Post(&bench_ping_job,1);
+}
+
+//乒乓：两个任务互相通知，每次都是一次上下文切换
+static void bench_ping_task_run(void *pvParameters){
+    for(;;){
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+        if(++bench_exchanges>=BENCH_PINGPONG){
+            xTaskNotifyGive(bench_handle);
+        }else{
+            xTaskNotifyGive(bench_pong_task);
+        }
+    }
+}
+
+static void bench_pong_task_run(void *pvParameters){
+    for(;;){
+        ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+        xTaskNotifyGive(bench_ping_task);
+    }
+}
+
+void bench_task(void *pvParameters){
+    static TaskHandle_t tasks[BENCH_UNITS];
+    size_t before,task_bytes,job_bytes;
+    uint32_t task_latency=0,job_latency=0,task_pp,job_pp,start;
+    Job_t *jobs;
+
+    bench_handle=xTaskGetCurrentTaskHandle();
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    cycle_counter_init();
+
+    //RAM：32个最小栈的任务，对比一个执行器 + 32个作业控制块
+    before=xPortGetFreeHeapSize();
+    for(uint32_t i=0;i<BENCH_UNITS;i++){
+        xTaskCreate(bench_idle_task,"BenchT",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+1,&tasks[i]);
+    }
+    task_bytes=before-xPortGetFreeHeapSize();
+    for(uint32_t i=0;i<BENCH_UNITS;i++){
+        vTaskDelete(tasks[i]);
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));     //让空闲任务回收被删除任务的内存
+
+    before=xPortGetFreeHeapSize();
+    JobLevel_Create(&bench_level,"BenchLvl",tskIDLE_PRIORITY+3,configMINIMAL_STACK_SIZE);
+    jobs=(Job_t*)pvPortMalloc(BENCH_UNITS*sizeof(Job_t));
+    for(uint32_t i=0;i<BENCH_UNITS;i++){
+        Job_Init(&jobs[i],&bench_level,"BenchJ",bench_noop_job,NULL);
+    }
+    job_bytes=before-xPortGetFreeHeapSize();
+
+    //投递到开始执行的延迟：目标优先级高于本任务，投递后立即被抢占
+    Job_Init(&bench_probe_job,&bench_level,"Probe",bench_probe_job_run,NULL);
+    xTaskCreate(bench_probe_task_run,"Probe",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+3,&bench_probe_task);
+    for(uint32_t i=0;i<BENCH_LATENCY_ROUNDS;i++){
+        start=cycle_counter_get();
+        xTaskNotifyGive(bench_probe_task);
+        task_latency+=bench_run_stamp-start;
+
+        start=cycle_counter_get();
+        Job_Post(&bench_probe_job,1);
+        job_latency+=bench_run_stamp-start;
+    }
+
+    //乒乓切换开销
+    xTaskCreate(bench_ping_task_run,"Ping",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+3,&bench_ping_task);
+    xTaskCreate(bench_pong_task_run,"Pong",configMINIMAL_STACK_SIZE,NULL,tskIDLE_PRIORITY+3,&bench_pong_task);
+    bench_exchanges=0;
+    start=cycle_counter_get();
+    xTaskNotifyGive(bench_ping_task);
+    ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+    task_pp=cycle_counter_get()-start;
+
+    Job_Init(&bench_ping_job,&bench_level,"Ping",bench_ping_job_run,NULL);
+    Job_Init(&bench_pong_job,&bench_level,"Pong",bench_pong_job_run,NULL);
+    bench_exchanges=0;
+    start=cycle_counter_get();
+    Job_Post(&bench_ping_job,1);
+    ulTaskNotifyTake(pdTRUE,portMAX_DELAY);
+    job_pp=cycle_counter_get()-start;
+
+    printf("\n[性能测试] 任务与作业对比\n");
+    printf("  RAM：%d个任务(栈%d字) %lu字节，每个%lu字节\n", BENCH_UNITS, configMINIMAL_STACK_SIZE,
+           (uint32_t)task_bytes, (uint32_t)(task_bytes/BENCH_UNITS));
+    printf("       1个执行器 + %d个作业 %lu字节，作业控制块每个%lu字节\n", BENCH_UNITS,
+           (uint32_t)job_bytes, (uint32_t)sizeof(Job_t));
+    printf("  投递到开始执行：任务%lu %s，作业%lu %s\n",
+           task_latency/BENCH_LATENCY_ROUNDS, CYCLE_UNIT, job_latency/BENCH_LATENCY_ROUNDS, CYCLE_UNIT);
+    printf("  乒乓一次：任务%lu %s，同级作业%lu %s\n",
+           task_pp/BENCH_PINGPONG, CYCLE_UNIT, job_pp/BENCH_PINGPONG, CYCLE_UNIT);
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    srand(1234);
+
+    //两级：LED和传感器、界面在高一级共用一个栈，通信在低一级
+    if(JobLevel_Create(&high_level,"JobsHigh",HIGH_LEVEL_PRIORITY,LEVEL_STACK_WORDS)!=pdPASS||
+       JobLevel_Create(&low_level,"JobsLow",LOW_LEVEL_PRIORITY,LEVEL_STACK_WORDS)!=pdPASS){
+        printf("执行器创建失败\n");
+        return -1;
+    }
+
+    Job_Init(&red_job,&high_level,"RedLED",led_job,&red_ctx);
+    Job_Init(&green_job,&high_level,"GreenLED",led_job,&green_ctx);
+    Job_Init(&blue_job,&high_level,"BlueLED",led_job,&blue_ctx);
+    Job_Init(&sensor_job,&high_level,"Sensor",sensor_job_run,NULL);
+    Job_Init(&ui_job,&high_level,"UI",ui_job_run,NULL);
+    Job_Init(&comm_job,&low_level,"Comm",comm_job_run,NULL);
+
+    //调度器启动前xTaskGetTickCount为0，定时从0开始算
+    Job_StartTimer(&red_job,red_ctx.half_period,red_ctx.half_period);
+    Job_StartTimer(&green_job,green_ctx.half_period,green_ctx.half_period);
+    Job_StartTimer(&blue_job,blue_ctx.half_period,blue_ctx.half_period);
+    Job_StartTimer(&sensor_job,pdMS_TO_TICKS(20),pdMS_TO_TICKS(20));
+    Job_StartTimer(&ui_job,pdMS_TO_TICKS(33),pdMS_TO_TICKS(33));
+    Job_StartTimer(&comm_job,pdMS_TO_TICKS(500),pdMS_TO_TICKS(500));
+
+    xTaskCreate(ButtonTask, "Button", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+2, NULL);
+    xTaskCreate(bench_task, "Bench", 512, NULL, tskIDLE_PRIORITY+2, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. RAM从哪里省下来：
+   - 任务：TCB + 独立的栈，栈要按最深的调用链和中断嵌套留余量
+   - 作业：几十字节的控制块；栈由同一级的执行器提供，一级只有一份
+
+2. 运行到完成：
+   - 作业被调用一次处理完就返回，不在中间阻塞，所以不需要保存自己的栈
+   - 需要等待时返回，把状态放在context里，由下一个事件（定时或投递）继续
+
+3. 优先级：
+   - 同一级的作业按就绪顺序依次执行，互不抢占
+   - 不同级之间是普通的任务抢占，需要快速响应的作业放高一级
+
+4. 切换开销：
+   - 同级作业之间投递：入链表 + 函数调用，没有上下文切换
+   - 从任务或中断投递：一次任务通知，和唤醒普通任务一样
+
+5. 什么时候仍然用任务：
+   - 需要阻塞等待的代码（同步驱动、长时间计算、复杂协议栈）
+   - 执行时间长、会拖住同级其他作业的工作
+*/
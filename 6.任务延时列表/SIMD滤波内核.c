@@ -0,0 +1,670 @@
+/*
+ * Demo: SIMD向量化的传感器数据滤波内核（按块、SoA布局）
+ * 学习要点：
+ * 1. 综合.c的FilerAndProcess()一次处理一个SensorData_t（AoS：温度、湿度交错存放），
+ *    每个样本一次函数调用，编译器没法向量化
+ * 2. SoA（Structure of Arrays）：每个通道一个连续数组，一条SIMD指令同时处理4/8个样本
+ * 3. 一层很薄的向量抽象（vfloat_t + VLOAD/VMLA/VMIN...），同一份内核代码编译成
+ *    AVX2（8路）/SSE2（4路）/NEON（4路）/Helium MVE（4路）/标量（1路）
+ * 4. FIR：沿样本方向向量化，历史样本拼在块前面，每个抽头一次广播乘加
+ * 5. 中值滤波（5点）：用min/max比较网络代替排序，没有分支
+ * 6. IIR（二阶节）：样本之间有递推依赖，改为跨通道向量化，状态一直留在寄存器里
+ * 7. 性能测试：每秒处理的样本数，与逐样本的标量写法对比
+ *
+ * 对应场景：综合.c的ProcessTask、工业数据采集与监控系统.c的数据处理阶段
+ *
+ * 编译：主机上加-mavx2 -mfma（或-msse2）；Cortex-A加-mfpu=neon；Cortex-M55加-mcpu=cortex-m55（MVE）
+ *      定义DSP_FORCE_SCALAR可强制使用标量实现；Cortex-M4/M7没有浮点SIMD，自动走标量
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../cycle_counter.h"
+
+
+// ==================== 向量抽象层 ====================
+// 内核只用下面这些宏，换指令集不用改内核
+#if defined(__AVX2__) && !defined(DSP_FORCE_SCALAR)
+#include <immintrin.h>
+typedef __m256 vfloat_t;
+#define DSP_ISA             "AVX2"
+#define DSP_LANES           8
+#define VLOAD(p)            _mm256_loadu_ps(p)
+#define VSTORE(p,v)         _mm256_storeu_ps((p),(v))
+#define VDUP(x)             _mm256_set1_ps(x)
+#define VADD(a,b)           _mm256_add_ps((a),(b))
+#define VSUB(a,b)           _mm256_sub_ps((a),(b))
+#define VMUL(a,b)           _mm256_mul_ps((a),(b))
+#define VMIN(a,b)           _mm256_min_ps((a),(b))
+#define VMAX(a,b)           _mm256_max_ps((a),(b))
+#if defined(__FMA__)
+#define VMLA(acc,a,b)       _mm256_fmadd_ps((a),(b),(acc))
+#else
+#define VMLA(acc,a,b)       _mm256_add_ps((acc),_mm256_mul_ps((a),(b)))
+#endif
+
+#elif defined(__SSE2__) && !defined(DSP_FORCE_SCALAR)
+#include <emmintrin.h>
+typedef __m128 vfloat_t;
+#define DSP_ISA             "SSE2"
+#define DSP_LANES           4
+#define VLOAD(p)            _mm_loadu_ps(p)
+#define VSTORE(p,v)         _mm_storeu_ps((p),(v))
+#define VDUP(x)             _mm_set1_ps(x)
+#define VADD(a,b)           _mm_add_ps((a),(b))
+#define VSUB(a,b)           _mm_sub_ps((a),(b))
+#define VMUL(a,b)           _mm_mul_ps((a),(b))
+#define VMIN(a,b)           _mm_min_ps((a),(b))
+#define VMAX(a,b)           _mm_max_ps((a),(b))
+#define VMLA(acc,a,b)       _mm_add_ps((acc),_mm_mul_ps((a),(b)))
+
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2) && !defined(DSP_FORCE_SCALAR)
+#include <arm_mve.h>
+typedef float32x4_t vfloat_t;
+#define DSP_ISA             "Helium MVE"
+#define DSP_LANES           4
+#define VLOAD(p)            vld1q_f32(p)
+#define VSTORE(p,v)         vst1q_f32((p),(v))
+#define VDUP(x)             vdupq_n_f32(x)
+#define VADD(a,b)           vaddq_f32((a),(b))
+#define VSUB(a,b)           vsubq_f32((a),(b))
+#define VMUL(a,b)           vmulq_f32((a),(b))
+#define VMIN(a,b)           vminnmq_f32((a),(b))
+#define VMAX(a,b)           vmaxnmq_f32((a),(b))
+#define VMLA(acc,a,b)       vfmaq_f32((acc),(a),(b))
+
+#elif defined(__ARM_NEON) && !defined(DSP_FORCE_SCALAR)
+#include <arm_neon.h>
+typedef float32x4_t vfloat_t;
+#define DSP_ISA             "NEON"
+#define DSP_LANES           4
+#define VLOAD(p)            vld1q_f32(p)
+#define VSTORE(p,v)         vst1q_f32((p),(v))
+#define VDUP(x)             vdupq_n_f32(x)
+#define VADD(a,b)           vaddq_f32((a),(b))
+#define VSUB(a,b)           vsubq_f32((a),(b))
+#define VMUL(a,b)           vmulq_f32((a),(b))
+#define VMIN(a,b)           vminq_f32((a),(b))
+#define VMAX(a,b)           vmaxq_f32((a),(b))
+#define VMLA(acc,a,b)       vmlaq_f32((acc),(a),(b))
+
+#else
+typedef float vfloat_t;
+#define DSP_ISA             "标量"
+#define DSP_LANES           1
+#define VLOAD(p)            (*(p))
+#define VSTORE(p,v)         (*(p)=(v))
+#define VDUP(x)             (x)
+#define VADD(a,b)           ((a)+(b))
+#define VSUB(a,b)           ((a)-(b))
+#define VMUL(a,b)           ((a)*(b))
+#define VMIN(a,b)           (((a)<(b))?(a):(b))
+#define VMAX(a,b)           (((a)>(b))?(a):(b))
+#define VMLA(acc,a,b)       ((acc)+(a)*(b))
+#endif
+
+//对照组保持逐样本调用、不让编译器自动向量化，测出的才是逐样本写法的真实开销
+//每轮测试之间加编译器屏障，防止每轮输入相同的循环被合并掉
+#if defined(__GNUC__) && !defined(__clang__)
+#define DSP_NO_AUTOVEC      __attribute__((noipa,optimize("no-tree-vectorize")))
+#define BENCH_BARRIER()     __asm__ volatile("":::"memory")
+#elif defined(__GNUC__)
+#define DSP_NO_AUTOVEC      __attribute__((noinline))
+#define BENCH_BARRIER()     __asm__ volatile("":::"memory")
+#else
+#define DSP_NO_AUTOVEC
+#define BENCH_BARRIER()
+#endif
+
+
+// ==================== 滤波内核 ====================
+#define DSP_MAX_BLOCK       256     //一块最多的样本数，必须是DSP_LANES的倍数
+#define DSP_FIR_MAX_TAPS    32
+#define DSP_MEDIAN_TAPS     5
+#define DSP_MAX_CHANNELS    16
+
+/*
+ * 历史缓冲：前hist个是上一块末尾的样本，后面拼接本块
+ * 内核直接在连续内存上按偏移取"过去的样本"，块边界不需要特殊处理
+ */
+typedef struct{
+    float buf[DSP_FIR_MAX_TAPS-1+DSP_MAX_BLOCK];
+    uint16_t hist;
+}DspHistory_t;
+
+typedef struct{
+    DspHistory_t history;
+    float taps[DSP_FIR_MAX_TAPS];
+    uint16_t num_taps;
+}DspFir_t;
+
+typedef struct{
+    DspHistory_t history;
+}DspMedian_t;
+
+//同一组二阶节系数作用于多个通道（直接II型转置）
+typedef struct{
+    float b0,b1,b2,a1,a2;
+    float z1[DSP_MAX_CHANNELS];
+    float z2[DSP_MAX_CHANNELS];
+}DspBiquadBank_t;
+
+static void dsp_history_init(DspHistory_t *h, uint16_t hist){
+    memset(h->buf,0,sizeof(h->buf));
+    h->hist=hist;
+}
+
+//把新块接到历史后面，返回拼接后的起点
+static inline const float *dsp_history_append(DspHistory_t *h, const float *x, uint32_t n){
+    memcpy(&h->buf[h->hist],x,n*sizeof(float));
+    return h->buf;
+}
+
+//保留本块最后hist个样本，作为下一块的历史
+static inline void dsp_history_commit(DspHistory_t *h, uint32_t n){
+    memmove(h->buf,&h->buf[n],h->hist*sizeof(float));
+}
+
+/**
+ * 增益+偏移：y=x*gain+offset（FilerAndProcess的按块版本）
+ */
+void Dsp_Scale(const float *x, float *y, uint32_t n, float gain, float offset){
+    vfloat_t vg=VDUP(gain),vo=VDUP(offset);
+
+    configASSERT(n%DSP_LANES==0);
+    for(uint32_t i=0;i<n;i+=DSP_LANES){
+        VSTORE(&y[i],VMLA(vo,VLOAD(&x[i]),vg));
+    }
+}
+
+void Dsp_FirInit(DspFir_t *f, const float *taps, uint16_t num_taps){
+    configASSERT(num_taps>0&&num_taps<=DSP_FIR_MAX_TAPS);
+    memcpy(f->taps,taps,num_taps*sizeof(float));
+    f->num_taps=num_taps;
+    dsp_history_init(&f->history,num_taps-1);
+}
+
+/**
+ * FIR：y[i]=Σh[k]*x[i-k]
+ * 外层按DSP_LANES个输出一组，内层每个抽头一次"广播系数×连续的输入向量"
+ */
+void Dsp_Fir(DspFir_t *f, const float *x, float *y, uint32_t n){
+    const float *ext=dsp_history_append(&f->history,x,n);
+    const uint32_t last=f->num_taps-1;
+
+    configASSERT(n<=DSP_MAX_BLOCK&&n%DSP_LANES==0);
+    for(uint32_t i=0;i<n;i+=DSP_LANES){
+        vfloat_t acc=VDUP(0.0f);
+        for(uint32_t k=0;k<=last;k++){
+            acc=VMLA(acc,VDUP(f->taps[k]),VLOAD(&ext[i+last-k]));
+        }
+        VSTORE(&y[i],acc);
+    }
+    dsp_history_commit(&f->history,n);
+}
+
+/**
+ * 滑动平均：等权FIR，沿样本方向向量化
+ * 窗口很大时逐样本的"加新减旧"更省，这里面向传感器常用的4~16点窗口
+ */
+void Dsp_MovingAverageInit(DspFir_t *f, uint16_t window){
+    float taps[DSP_FIR_MAX_TAPS];
+
+    configASSERT(window>0&&window<=DSP_FIR_MAX_TAPS);
+    for(uint16_t k=0;k<window;k++){
+        taps[k]=1.0f/(float)window;
+    }
+    Dsp_FirInit(f,taps,window);
+}
+
+void Dsp_MedianInit(DspMedian_t *m){
+    dsp_history_init(&m->history,DSP_MEDIAN_TAPS-1);
+}
+
+/**
+ * 5点中值滤波：去掉传感器的尖峰干扰
+ * 比较网络：两两排序后，两个较小者中更小的、两个较大者中更大的一定不是中值，
+ *          去掉它们后中值就是剩下3个数的中值，全程只有min/max，没有分支
+ */
+void Dsp_Median5(DspMedian_t *m, const float *x, float *y, uint32_t n){
+    const float *ext=dsp_history_append(&m->history,x,n);
+
+    configASSERT(n<=DSP_MAX_BLOCK&&n%DSP_LANES==0);
+    for(uint32_t i=0;i<n;i+=DSP_LANES){
+        vfloat_t a=VLOAD(&ext[i]),b=VLOAD(&ext[i+1]),c=VLOAD(&ext[i+2]);
+        vfloat_t d=VLOAD(&ext[i+3]),e=VLOAD(&ext[i+4]);
+        vfloat_t lo1=VMIN(a,b),hi1=VMAX(a,b);
+        vfloat_t lo2=VMIN(c,d),hi2=VMAX(c,d);
+        vfloat_t p=VMAX(lo1,lo2);
+        vfloat_t q=VMIN(hi1,hi2);
+
+        //median3(p,q,e)
+        VSTORE(&y[i],VMAX(VMIN(p,q),VMIN(VMAX(p,q),e)));
+    }
+    dsp_history_commit(&m->history,n);
+}
+
+void Dsp_BiquadBankInit(DspBiquadBank_t *bank, float b0, float b1, float b2, float a1, float a2){
+    memset(bank,0,sizeof(DspBiquadBank_t));
+    bank->b0=b0;
+    bank->b1=b1;
+    bank->b2=b2;
+    bank->a1=a1;
+    bank->a2=a2;
+}
+
+/**
+ * 多通道二阶节
+ * 功能：同一通道的样本有递推依赖，改为DSP_LANES个通道一组并行，
+ *      一组通道的状态在整块处理期间一直放在向量寄存器里
+ * 参数：x/y SoA布局，第ch个通道从x+ch*stride开始；num_channels须为DSP_LANES的倍数
+ */
+void Dsp_BiquadBank(DspBiquadBank_t *bank, const float *x, float *y, uint32_t num_channels,
+                    uint32_t n, uint32_t stride){
+    vfloat_t b0=VDUP(bank->b0),b1=VDUP(bank->b1),b2=VDUP(bank->b2);
+    vfloat_t a1=VDUP(bank->a1),a2=VDUP(bank->a2);
+
+    configASSERT(num_channels<=DSP_MAX_CHANNELS&&num_channels%DSP_LANES==0);
+    for(uint32_t ch=0;ch<num_channels;ch+=DSP_LANES){
+        vfloat_t z1=VLOAD(&bank->z1[ch]);
+        vfloat_t z2=VLOAD(&bank->z2[ch]);
+        float lane[DSP_LANES];
+
+        for(uint32_t i=0;i<n;i++){
+            vfloat_t in,out;
+
+            //跨通道取同一时刻的样本（SoA下相隔stride）
+            for(uint32_t l=0;l<DSP_LANES;l++){
+                lane[l]=x[(ch+l)*stride+i];
+            }
+            in=VLOAD(lane);
+            out=VMLA(z1,b0,in);
+            z1=VSUB(VMLA(z2,b1,in),VMUL(a1,out));
+            z2=VSUB(VMUL(b2,in),VMUL(a2,out));
+            VSTORE(lane,out);
+            for(uint32_t l=0;l<DSP_LANES;l++){
+                y[(ch+l)*stride+i]=lane[l];
+            }
+        }
+        VSTORE(&bank->z1[ch],z1);
+        VSTORE(&bank->z2[ch],z2);
+    }
+}
+
+
+// ==================== 逐样本的对照实现 ====================
+// 综合.c的写法：AoS结构体，每个样本一次函数调用
+typedef struct{
+    float temperature;
+    float humidity;
+}SensorData_t;
+
+typedef struct{
+    float fileredtemperature;
+    float fileredhumidity;
+}ProcessedData_t;
+
+DSP_NO_AUTOVEC ProcessedData_t FilerAndProcess(SensorData_t* data){
+    ProcessedData_t result;
+    result.fileredtemperature=data->temperature*0.8f;
+    result.fileredhumidity=data->humidity*0.8f;
+
+    return result;
+}
+
+//延迟线环形缓冲的FIR，嵌入式里最常见的写法
+typedef struct{
+    float delay[DSP_FIR_MAX_TAPS];
+    uint16_t pos;
+}RefFir_t;
+
+DSP_NO_AUTOVEC static float ref_fir_sample(RefFir_t *f, const float *taps, uint16_t num_taps, float x){
+    float acc=0.0f;
+    uint16_t idx=f->pos;
+
+    f->delay[f->pos]=x;
+    for(uint16_t k=0;k<num_taps;k++){
+        acc+=taps[k]*f->delay[idx];
+        idx=(idx==0)?(num_taps-1):(idx-1);
+    }
+    f->pos=(f->pos+1==num_taps)?0:(f->pos+1);
+    return acc;
+}
+
+//加新减旧的滑动平均
+typedef struct{
+    float ring[DSP_FIR_MAX_TAPS];
+    float sum;
+    uint16_t pos;
+}RefAverage_t;
+
+DSP_NO_AUTOVEC static float ref_average_sample(RefAverage_t *a, uint16_t window, float x){
+    a->sum+=x-a->ring[a->pos];
+    a->ring[a->pos]=x;
+    a->pos=(a->pos+1==window)?0:(a->pos+1);
+    return a->sum/(float)window;
+}
+
+//拷贝窗口后插入排序取中值
+typedef struct{
+    float ring[DSP_MEDIAN_TAPS];
+    uint16_t pos;
+}RefMedian_t;
+
+DSP_NO_AUTOVEC static float ref_median_sample(RefMedian_t *m, float x){
+    float sorted[DSP_MEDIAN_TAPS];
+
+    m->ring[m->pos]=x;
+    m->pos=(m->pos+1==DSP_MEDIAN_TAPS)?0:(m->pos+1);
+    for(int i=0;i<DSP_MEDIAN_TAPS;i++){
+        int j=i;
+        while(j>0&&sorted[j-1]>m->ring[i]){
+            sorted[j]=sorted[j-1];
+            j--;
+        }
+        sorted[j]=m->ring[i];
+    }
+    return sorted[DSP_MEDIAN_TAPS/2];
+}
+
+DSP_NO_AUTOVEC static float ref_biquad_sample(DspBiquadBank_t *bank, uint32_t ch, float x){
+    float y=bank->b0*x+bank->z1[ch];
+    bank->z1[ch]=bank->b1*x-bank->a1*y+bank->z2[ch];
+    bank->z2[ch]=bank->b2*x-bank->a2*y;
+    return y;
+}
+
+
+// ==================== 处理任务 ====================
+#define BLOCK_SIZE          64
+#define SENSOR_CHANNELS     8       //通道0是温度，1是湿度，其余是同类的温度探头
+#define FIR_TAPS            15
+
+//SoA：每个通道一个数组
+typedef struct{
+    float samples[SENSOR_CHANNELS][BLOCK_SIZE];
+    uint32_t timestamp;
+}SensorBlock_t;
+
+static SensorBlock_t raw_block,filtered_block;
+static DspMedian_t median_state[SENSOR_CHANNELS];
+static DspFir_t lowpass_state[SENSOR_CHANNELS];
+static DspBiquadBank_t dc_block_bank;
+static float lowpass_taps[FIR_TAPS];
+
+//汉明窗截断的sinc低通，截止频率为采样率的0.1
+static void design_lowpass(float *taps, uint16_t num_taps, float cutoff){
+    float sum=0.0f;
+    int mid=num_taps/2;
+
+    for(int k=0;k<num_taps;k++){
+        int m=k-mid;
+        float sinc=(m==0)?2.0f*cutoff:sinf(2.0f*3.14159265f*cutoff*(float)m)/(3.14159265f*(float)m);
+        float window=0.54f-0.46f*cosf(2.0f*3.14159265f*(float)k/(float)(num_taps-1));
+        taps[k]=sinc*window;
+        sum+=taps[k];
+    }
+    for(int k=0;k<num_taps;k++){
+        taps[k]/=sum;
+    }
+}
+
+static void fill_block(SensorBlock_t *block, uint32_t round){
+    for(uint32_t ch=0;ch<SENSOR_CHANNELS;ch++){
+        float base=(ch==1)?60.0f:25.0f+(float)ch;
+        for(uint32_t i=0;i<BLOCK_SIZE;i++){
+            float v=base+(float)(rand()%100)/50.0f;
+            if(rand()%50==0){
+                v+=40.0f;           //偶发尖峰
+            }
+            block->samples[ch][i]=v;
+        }
+    }
+    block->timestamp=round*BLOCK_SIZE;
+}
+
+/**
+ * 处理链：中值去尖峰 → FIR低通 → 二阶节隔直（只保留波动） → 增益0.8
+ */
+void ProcessTask(void *pvParameters){
+    TickType_t xLastWakeTime=xTaskGetTickCount();
+    static float dc_removed[SENSOR_CHANNELS][BLOCK_SIZE];
+    uint32_t round=0;
+
+    for(;;){
+        fill_block(&raw_block,round);
+
+        for(uint32_t ch=0;ch<SENSOR_CHANNELS;ch++){
+            Dsp_Median5(&median_state[ch],raw_block.samples[ch],filtered_block.samples[ch],BLOCK_SIZE);
+            Dsp_Fir(&lowpass_state[ch],filtered_block.samples[ch],filtered_block.samples[ch],BLOCK_SIZE);
+        }
+        Dsp_BiquadBank(&dc_block_bank,&filtered_block.samples[0][0],&dc_removed[0][0],
+                       SENSOR_CHANNELS,BLOCK_SIZE,BLOCK_SIZE);
+        for(uint32_t ch=0;ch<SENSOR_CHANNELS;ch++){
+            Dsp_Scale(filtered_block.samples[ch],filtered_block.samples[ch],BLOCK_SIZE,0.8f,0.0f);
+        }
+
+        round++;
+        if(round%10==0){
+            printf("[处理] 第%lu块 温度: 原始%.2f 滤波后%.2f 波动%.3f  湿度: 原始%.2f 滤波后%.2f\n",
+                   round, raw_block.samples[0][BLOCK_SIZE-1], filtered_block.samples[0][BLOCK_SIZE-1],
+                   dc_removed[0][BLOCK_SIZE-1],
+                   raw_block.samples[1][BLOCK_SIZE-1], filtered_block.samples[1][BLOCK_SIZE-1]);
+        }
+        vTaskDelayUntil(&xLastWakeTime,pdMS_TO_TICKS(500));
+    }
+}
+
+
+// ==================== 性能测试 ====================
+#define BENCH_BLOCK         DSP_MAX_BLOCK
+#define BENCH_CHANNELS      8
+#define BENCH_ROUNDS        500
+
+static float bench_in[BENCH_CHANNELS][BENCH_BLOCK];
+static float bench_out[BENCH_CHANNELS][BENCH_BLOCK];
+static SensorData_t bench_aos[BENCH_BLOCK];
+static ProcessedData_t bench_aos_out[BENCH_BLOCK];
+
+static void bench_report(const char *name, uint32_t ref_cycles, uint32_t vec_cycles, uint32_t samples_per_round){
+    uint64_t samples=(uint64_t)samples_per_round*BENCH_ROUNDS;
+    uint32_t ref_rate=(uint32_t)(samples*CYCLES_PER_SECOND/(ref_cycles?ref_cycles:1)/1000);
+    uint32_t vec_rate=(uint32_t)(samples*CYCLES_PER_SECOND/(vec_cycles?vec_cycles:1)/1000);
+
+    printf("  %-18s %12lu %12lu %6lu.%lux\n", name, ref_rate, vec_rate,
+           vec_rate/(ref_rate?ref_rate:1), (vec_rate*10/(ref_rate?ref_rate:1))%10);
+}
+
+void bench_task(void *pvParameters){
+    static DspFir_t fir[BENCH_CHANNELS],avg[BENCH_CHANNELS];
+    static DspMedian_t med[BENCH_CHANNELS];
+    static RefFir_t ref_fir[BENCH_CHANNELS];
+    static RefAverage_t ref_avg[BENCH_CHANNELS];
+    static RefMedian_t ref_med[BENCH_CHANNELS];
+    static DspBiquadBank_t bank,ref_bank;
+    uint32_t start,ref,vec;
+    float max_err=0.0f;
+
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    cycle_counter_init();
+
+    for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+        for(uint32_t i=0;i<BENCH_BLOCK;i++){
+            bench_in[ch][i]=(float)(rand()%1000)/10.0f;
+        }
+        Dsp_FirInit(&fir[ch],lowpass_taps,FIR_TAPS);
+        Dsp_MovingAverageInit(&avg[ch],8);
+        Dsp_MedianInit(&med[ch]);
+    }
+    for(uint32_t i=0;i<BENCH_BLOCK;i++){
+        bench_aos[i].temperature=bench_in[0][i];
+        bench_aos[i].humidity=bench_in[1][i];
+    }
+    memset(ref_fir,0,sizeof(ref_fir));
+    memset(ref_avg,0,sizeof(ref_avg));
+    memset(ref_med,0,sizeof(ref_med));
+    Dsp_BiquadBankInit(&bank,0.98f,-1.96f,0.98f,-1.96f,0.9604f);
+    ref_bank=bank;
+
+    printf("\n[性能测试] %s，%d路，块长%d，单位：千样本/秒\n", DSP_ISA, DSP_LANES, BENCH_BLOCK);
+    printf("  内核               逐样本标量       向量化     加速比\n");
+
+    //增益：AoS逐个调用 vs SoA按块
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t i=0;i<BENCH_BLOCK;i++){
+            bench_aos_out[i]=FilerAndProcess(&bench_aos[i]);
+        }
+    }
+    ref=cycle_counter_get()-start;
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        Dsp_Scale(bench_in[0],bench_out[0],BENCH_BLOCK,0.8f,0.0f);
+        Dsp_Scale(bench_in[1],bench_out[1],BENCH_BLOCK,0.8f,0.0f);
+    }
+    vec=cycle_counter_get()-start;
+    bench_report("增益(FilerAndProcess)",ref,vec,2*BENCH_BLOCK);
+
+    //FIR
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            for(uint32_t i=0;i<BENCH_BLOCK;i++){
+                bench_out[ch][i]=ref_fir_sample(&ref_fir[ch],lowpass_taps,FIR_TAPS,bench_in[ch][i]);
+            }
+        }
+    }
+    ref=cycle_counter_get()-start;
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            Dsp_Fir(&fir[ch],bench_in[ch],bench_out[ch],BENCH_BLOCK);
+        }
+    }
+    vec=cycle_counter_get()-start;
+    bench_report("FIR 15抽头",ref,vec,BENCH_CHANNELS*BENCH_BLOCK);
+
+    //滑动平均
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            for(uint32_t i=0;i<BENCH_BLOCK;i++){
+                bench_out[ch][i]=ref_average_sample(&ref_avg[ch],8,bench_in[ch][i]);
+            }
+        }
+    }
+    ref=cycle_counter_get()-start;
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            Dsp_Fir(&avg[ch],bench_in[ch],bench_out[ch],BENCH_BLOCK);
+        }
+    }
+    vec=cycle_counter_get()-start;
+    bench_report("滑动平均 8点",ref,vec,BENCH_CHANNELS*BENCH_BLOCK);
+
+    //中值
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            for(uint32_t i=0;i<BENCH_BLOCK;i++){
+                bench_out[ch][i]=ref_median_sample(&ref_med[ch],bench_in[ch][i]);
+            }
+        }
+    }
+    ref=cycle_counter_get()-start;
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            Dsp_Median5(&med[ch],bench_in[ch],bench_out[ch],BENCH_BLOCK);
+        }
+    }
+    vec=cycle_counter_get()-start;
+    bench_report("中值 5点",ref,vec,BENCH_CHANNELS*BENCH_BLOCK);
+
+    //IIR：跑完后对比两种实现的输出，确认向量化没有改变结果
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+            for(uint32_t i=0;i<BENCH_BLOCK;i++){
+                bench_out[ch][i]=ref_biquad_sample(&ref_bank,ch,bench_in[ch][i]);
+            }
+        }
+    }
+    ref=cycle_counter_get()-start;
+    start=cycle_counter_get();
+    for(uint32_t r=0;r<BENCH_ROUNDS;r++){
+        BENCH_BARRIER();
+        Dsp_BiquadBank(&bank,&bench_in[0][0],&bench_out[0][0],
+                       BENCH_CHANNELS,BENCH_BLOCK,BENCH_BLOCK);
+    }
+    vec=cycle_counter_get()-start;
+    bench_report("IIR 二阶节",ref,vec,BENCH_CHANNELS*BENCH_BLOCK);
+    for(uint32_t ch=0;ch<BENCH_CHANNELS;ch++){
+        float err=fabsf(bank.z1[ch]-ref_bank.z1[ch]);
+        if(err>max_err){
+            max_err=err;
+        }
+    }
+    printf("  IIR两种实现的状态最大差值: %g\n", max_err);
+
+    vTaskDelete(NULL);
+}
+
+
+int main(void){
+    srand(1234);
+
+    design_lowpass(lowpass_taps,FIR_TAPS,0.1f);
+    for(uint32_t ch=0;ch<SENSOR_CHANNELS;ch++){
+        Dsp_MedianInit(&median_state[ch]);
+        Dsp_FirInit(&lowpass_state[ch],lowpass_taps,FIR_TAPS);
+    }
+    //二阶高通（隔直），极点0.98
+    Dsp_BiquadBankInit(&dc_block_bank,0.98f,-1.96f,0.98f,-1.96f,0.9604f);
+
+    xTaskCreate(ProcessTask, "Process", 512, NULL, 2, NULL);
+    xTaskCreate(bench_task, "Bench", 1024, NULL, 1, NULL);
+
+    vTaskStartScheduler();
+
+    printf("调度器启动失败！\n");
+    return -1;
+}
+
+/*
+学习要点总结：
+
+1. SoA vs AoS：
+   - AoS里温度和湿度交错，连续加载一个向量拿到的是两种数据
+   - SoA里一个通道的样本连续，一次加载4/8个同类样本，处理完连续写回
+
+2. 向量抽象层：
+   - 内核只依赖vfloat_t和十来个宏，AVX2/SSE2/NEON/MVE/标量各一组定义
+   - 没有SIMD的芯片（Cortex-M4/M7）走标量定义，同一份代码照样能用
+
+3. FIR和中值：沿样本方向并行
+   - 历史样本拼在块前面，"往前第k个样本"就是往左偏k个元素的一次非对齐加载
+   - 中值用min/max比较网络，没有分支，数据里的尖峰不会造成分支预测失败
+
+4. IIR：跨通道并行
+   - y[i]依赖y[i-1]，同一通道内没法并行
+   - 同样的滤波器用在多个通道上时，把DSP_LANES个通道放进一个向量
+   - 状态整块都在寄存器里，不用每个样本读写内存
+
+5. 对照组：
+   - 逐样本函数调用、环形缓冲取模、插入排序，是最常见的写法
+   - 对照组关掉了自动向量化，否则编译器可能把简单的循环也向量化
+*/
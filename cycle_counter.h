@@ -0,0 +1,46 @@
+/*
+ * 周期计数器（各demo的基准测试共用）
+ * Cortex-M3/M4/M7使用DWT->CYCCNT计CPU周期；主机（POSIX移植）使用clock_gettime计纳秒
+ *
+ * cycle_counter_init()  使能计数器，第一次读之前调用一次
+ * cycle_counter_get()   读当前计数，32位回绕，两次读数相减得到间隔
+ * CYCLE_UNIT            计数的单位，打印用
+ * CYCLES_PER_SECOND     每秒的计数值，换算成时间用
+ */
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <stdint.h>
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define DEMCR       (*(volatile uint32_t*)0xE000EDFC)
+#define DWT_CTRL    (*(volatile uint32_t*)0xE0001000)
+#define DWT_CYCCNT  (*(volatile uint32_t*)0xE0001004)
+#define CYCLE_UNIT  "cycles"
+#define CYCLES_PER_SECOND   configCPU_CLOCK_HZ
+
+static inline void cycle_counter_init(void){
+    DEMCR|=(1UL<<24);       //TRCENA：使能DWT
+    DWT_CYCCNT=0;
+    DWT_CTRL|=1UL;          //CYCCNTENA：启动周期计数
+}
+
+static inline uint32_t cycle_counter_get(void){
+    return DWT_CYCCNT;
+}
+#else
+#include <time.h>
+#define CYCLE_UNIT  "ns"
+#define CYCLES_PER_SECOND   1000000000ULL
+
+static inline void cycle_counter_init(void){
+}
+
+static inline uint32_t cycle_counter_get(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (uint32_t)((uint64_t)ts.tv_sec*1000000000ULL+(uint64_t)ts.tv_nsec);
+}
+#endif
+
+#endif